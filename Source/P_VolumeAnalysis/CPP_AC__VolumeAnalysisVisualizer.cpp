@@ -0,0 +1,257 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#include "CPP_AC__VolumeAnalysisVisualizer.h"
+#include "CPP_EN__VolumeAnalysisStats.h"
+#include "Materials/MaterialInterface.h"
+#include "UObject/ConstructorHelpers.h"
+
+// Unit cube corners are indexed by bit (X = 1, Y = 2, Z = 4); two triangles per face, wound outward
+static const int32 GMarkerCubeTriangles[36] = {
+	0, 2, 6, 0, 6, 4, 1, 7, 3, 1, 5, 7,
+	0, 5, 1, 0, 4, 5, 2, 3, 7, 2, 7, 6,
+	0, 1, 3, 0, 3, 2, 4, 7, 5, 4, 6, 7};
+
+UCPP_AC__VolumeAnalysisVisualizer::UCPP_AC__VolumeAnalysisVisualizer(const FObjectInitializer &ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	static ConstructorHelpers::FObjectFinder<UMaterialInterface> VertexColorMaterial(TEXT("/Engine/EngineDebugMaterials/VertexColorMaterial.VertexColorMaterial"));
+	if (VertexColorMaterial.Succeeded())
+	{
+		MarkerMaterial = VertexColorMaterial.Object;
+	}
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetGenerateOverlapEvents(false);
+	SetCastShadow(false);
+	bUseAsyncCooking = false;
+}
+
+void UCPP_AC__VolumeAnalysisVisualizer::BuildFromGrid(const FS_VoxelGrid &Grid)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UCPP_AC__VolumeAnalysisVisualizer::BuildFromGrid);
+	ResetForGrid(Grid);
+	if (Mode == EE_VolumeAnalysisVisualizerMode::MergedRegions)
+	{
+		FS_VolumeAnalysisRegions Regions;
+		if (Regions.Build(Grid, /*bIncludeHidden*/ Filter != EE_VolumeAnalysisVisualizerFilter::VisibleOnly))
+		{
+			// Bits the mesh shows, so UpdateFromGrid only rebuilds on a change
+			BuiltBits = Grid.VisibilityBits;
+			BuildRegionMesh(Regions);
+		}
+		return;
+	}
+	for (int32 Z = 0; Z < BuiltCounts.Z; ++Z)
+	{
+		BuildSlice(Grid, Z);
+	}
+}
+
+bool UCPP_AC__VolumeAnalysisVisualizer::UpdateFromGrid(const FS_VoxelGrid &Grid)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UCPP_AC__VolumeAnalysisVisualizer::UpdateFromGrid);
+	if (Mode == EE_VolumeAnalysisVisualizerMode::MergedRegions)
+	{
+		// Merging is global, so there is no per-slice update
+		if (!bBuiltRegions || !IsLayoutCurrent(Grid) || BuiltBits != Grid.VisibilityBits)
+		{
+			BuildFromGrid(Grid);
+		}
+		return true;
+	}
+	if (!IsLayoutCurrent(Grid) || bBuiltRegions)
+	{
+		ResetForGrid(Grid);
+	}
+	const int32 NumSlices = BuiltCounts.Z;
+	int32 Rebuilt = 0;
+	for (int32 Step = 0; Step < NumSlices; ++Step)
+	{
+		const int32 Z = (NextSlice + Step) % NumSlices;
+		if (!HasSliceChanged(Grid, Z))
+		{
+			continue;
+		}
+		if (Rebuilt == MaxSlicesPerUpdate)
+		{
+			// Out of budget; resume from here next call
+			NextSlice = Z;
+			return false;
+		}
+		BuildSlice(Grid, Z);
+		++Rebuilt;
+	}
+	return true;
+}
+
+void UCPP_AC__VolumeAnalysisVisualizer::BuildFromRegions(const FS_VolumeAnalysisRegions &Regions)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UCPP_AC__VolumeAnalysisVisualizer::BuildFromRegions);
+	ClearVisualization();
+	BuildRegionMesh(Regions);
+}
+
+void UCPP_AC__VolumeAnalysisVisualizer::ApplySliceFilter()
+{
+	if (bBuiltRegions)
+	{
+		return;
+	}
+	for (int32 Z = 0; Z < GetNumSections(); ++Z)
+	{
+		SetMeshSectionVisible(Z, IsSliceShown(Z));
+	}
+}
+
+void UCPP_AC__VolumeAnalysisVisualizer::ClearVisualization()
+{
+	ClearAllMeshSections();
+	BuiltCounts = FIntVector::ZeroValue;
+	BuiltBits.Empty();
+	SliceBuilt.Empty();
+	NextSlice = 0;
+	bBuiltRegions = false;
+}
+
+void UCPP_AC__VolumeAnalysisVisualizer::ResetForGrid(const FS_VoxelGrid &Grid)
+{
+	ClearVisualization();
+	if (!Grid.IsValid())
+	{
+		return;
+	}
+	BuiltOrigin = Grid.Origin;
+	BuiltCellSize = Grid.CellSize;
+	BuiltCounts = FIntVector(Grid.CountX, Grid.CountY, Grid.CountZ);
+	BuiltEdgesX = Grid.EdgesX;
+	BuiltEdgesY = Grid.EdgesY;
+	BuiltEdgesZ = Grid.EdgesZ;
+	BuiltBits.SetNumZeroed(Grid.VisibilityBits.Num());
+	SliceBuilt.Init(false, Grid.CountZ);
+}
+
+bool UCPP_AC__VolumeAnalysisVisualizer::IsLayoutCurrent(const FS_VoxelGrid &Grid) const
+{
+	return BuiltCounts == FIntVector(Grid.CountX, Grid.CountY, Grid.CountZ) && BuiltOrigin.Equals(Grid.Origin) && BuiltCellSize.Equals(Grid.CellSize) && BuiltEdgesX == Grid.EdgesX && BuiltEdgesY == Grid.EdgesY && BuiltEdgesZ == Grid.EdgesZ && BuiltBits.Num() == Grid.VisibilityBits.Num();
+}
+
+void UCPP_AC__VolumeAnalysisVisualizer::GetSliceWordRange(int32 Z, int32 &OutFirstWord, int32 &OutNumWords) const
+{
+	const int32 SliceSize = BuiltCounts.X * BuiltCounts.Y;
+	OutFirstWord = (Z * SliceSize) >> 5;
+	OutNumWords = (((Z + 1) * SliceSize - 1) >> 5) - OutFirstWord + 1;
+}
+
+bool UCPP_AC__VolumeAnalysisVisualizer::HasSliceChanged(const FS_VoxelGrid &Grid, int32 Z) const
+{
+	if (Z % FMath::Max(LODStride, 1) != 0)
+	{
+		return false;
+	}
+	if (!SliceBuilt[Z])
+	{
+		return true;
+	}
+	// Words shared with a neighbouring slice may report a change that is not ours; that only costs a redundant rebuild
+	int32 FirstWord, NumWords;
+	GetSliceWordRange(Z, FirstWord, NumWords);
+	return FMemory::Memcmp(&BuiltBits[FirstWord], &Grid.VisibilityBits[FirstWord], NumWords * sizeof(uint32)) != 0;
+}
+
+void UCPP_AC__VolumeAnalysisVisualizer::BuildSlice(const FS_VoxelGrid &Grid, int32 Z)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PVol_DebugDraw);
+	const int32 Stride = FMath::Max(LODStride, 1);
+	int32 FirstWord, NumWords;
+	GetSliceWordRange(Z, FirstWord, NumWords);
+	FMemory::Memcpy(&BuiltBits[FirstWord], &Grid.VisibilityBits[FirstWord], NumWords * sizeof(uint32));
+	SliceBuilt[Z] = true;
+
+	Vertices.Reset();
+	Triangles.Reset();
+	Colors.Reset();
+	if (Z % Stride == 0)
+	{
+		const FTransform &ToWorld = GetComponentTransform();
+		const FVector MarkerExtent = Grid.CellSize * (0.5f * MarkerScale);
+		for (int32 Y = 0; Y < Grid.CountY; Y += Stride)
+		{
+			for (int32 X = 0; X < Grid.CountX; X += Stride)
+			{
+				const bool bVisible = Grid.IsVisible(Grid.Index(X, Y, Z));
+				if ((bVisible && Filter == EE_VolumeAnalysisVisualizerFilter::HiddenOnly) || (!bVisible && Filter == EE_VolumeAnalysisVisualizerFilter::VisibleOnly))
+				{
+					continue;
+				}
+				const FVector Extent = Grid.IsUniform() ? MarkerExtent : Grid.GetCellBox(X, Y, Z).GetExtent() * MarkerScale;
+				AddBox(ToWorld, Grid.GetCellCenter(X, Y, Z), Extent, bVisible ? VisibleColor : HiddenColor);
+			}
+		}
+	}
+
+	if (Vertices.Num() == 0)
+	{
+		ClearMeshSection(Z);
+		return;
+	}
+	// Unlit vertex colors only; normals, UVs and tangents are not needed
+	CreateMeshSection(Z, Vertices, Triangles, TArray<FVector>(), TArray<FVector2D>(), Colors, TArray<FProcMeshTangent>(), /*bCreateCollision*/ false);
+	SetMaterial(Z, MarkerMaterial);
+	SetMeshSectionVisible(Z, IsSliceShown(Z));
+}
+
+bool UCPP_AC__VolumeAnalysisVisualizer::IsSliceShown(int32 Z) const
+{
+	return Z >= SliceMinZ && (SliceMaxZ < 0 || Z <= SliceMaxZ);
+}
+
+void UCPP_AC__VolumeAnalysisVisualizer::BuildRegionMesh(const FS_VolumeAnalysisRegions &Regions)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PVol_DebugDraw);
+	bBuiltRegions = true;
+	Vertices.Reset();
+	Triangles.Reset();
+	Colors.Reset();
+	const FTransform &ToWorld = GetComponentTransform();
+	for (const FS_VolumeAnalysisRegionBox &Box : Regions.Boxes)
+	{
+		if ((Box.bVisible && Filter == EE_VolumeAnalysisVisualizerFilter::HiddenOnly) || (!Box.bVisible && Filter == EE_VolumeAnalysisVisualizerFilter::VisibleOnly))
+		{
+			continue;
+		}
+		FColor Color = Box.bVisible ? VisibleColor : HiddenColor;
+		if (Box.bVisible && bColorByComponent)
+		{
+			// Hue steps of ~0.618 turns keep consecutive components apart
+			Color = FLinearColor::MakeFromHSV8(static_cast<uint8>(Box.Component * 158), 192, 255).ToFColor(/*bSRGB*/ true);
+		}
+		AddBox(ToWorld, Box.Bounds.GetCenter(), Box.Bounds.GetExtent(), Color);
+	}
+
+	if (Vertices.Num() == 0)
+	{
+		ClearMeshSection(0);
+		return;
+	}
+	CreateMeshSection(0, Vertices, Triangles, TArray<FVector>(), TArray<FVector2D>(), Colors, TArray<FProcMeshTangent>(), /*bCreateCollision*/ false);
+	SetMaterial(0, MarkerMaterial);
+}
+
+void UCPP_AC__VolumeAnalysisVisualizer::AddBox(const FTransform &ToWorld, const FVector &Center, const FVector &Extent, const FColor &Color)
+{
+	// Vertices are stored in component space so the mesh lines up wherever the component sits
+	const int32 Base = Vertices.Num();
+	for (int32 Corner = 0; Corner < 8; ++Corner)
+	{
+		const FVector Sign((Corner & 1) ? 1.0 : -1.0, (Corner & 2) ? 1.0 : -1.0, (Corner & 4) ? 1.0 : -1.0);
+		Vertices.Add(ToWorld.InverseTransformPosition(Center + Extent * Sign));
+		Colors.Add(Color);
+	}
+	for (int32 Tri : GMarkerCubeTriangles)
+	{
+		Triangles.Add(Base + Tri);
+	}
+}
@@ -0,0 +1,154 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProceduralMeshComponent.h"
+#include "CPP_ST__VolumeAnalysisGrid.h"
+#include "CPP_ST__VolumeAnalysisRegions.h"
+#include "CPP_AC__VolumeAnalysisVisualizer.generated.h"
+
+class UMaterialInterface;
+
+UENUM(BlueprintType)
+enum class EE_VolumeAnalysisVisualizerFilter : uint8
+{
+	All,
+	VisibleOnly,
+	HiddenOnly
+};
+
+UENUM(BlueprintType)
+enum class EE_VolumeAnalysisVisualizerMode : uint8
+{
+	// A small cube per voxel, one section per Z slice
+	VoxelMarkers UMETA(DisplayName = "Voxel Markers"),
+	// One full-size box per merged region (FS_VolumeAnalysisRegions) in a single section; far fewer triangles
+	MergedRegions UMETA(DisplayName = "Merged Regions")
+};
+
+/**
+ * Draws a voxel grid as one vertex-colored procedural mesh (a small cube per voxel) instead of one debug
+ * draw call per voxel. Each Z slice is its own mesh section, so slice filtering only toggles section
+ * visibility and incremental updates rebuild just the slices whose visibility bits changed.
+ * In MergedRegions mode the grid is greedy-merged into boxes instead; any change rebuilds the whole mesh.
+ */
+UCLASS(ClassGroup = (Punal), meta = (BlueprintSpawnableComponent))
+class P_VOLUMEANALYSIS_API UCPP_AC__VolumeAnalysisVisualizer : public UProceduralMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	UCPP_AC__VolumeAnalysisVisualizer(const FObjectInitializer &ObjectInitializer);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Visualizer")
+	EE_VolumeAnalysisVisualizerMode Mode = EE_VolumeAnalysisVisualizerMode::VoxelMarkers;
+
+	// Which voxels get a marker (or which regions are drawn)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Visualizer")
+	EE_VolumeAnalysisVisualizerFilter Filter = EE_VolumeAnalysisVisualizerFilter::All;
+
+	// MergedRegions: give each connected component of visible voxels its own color instead of VisibleColor
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Visualizer")
+	bool bColorByComponent = false;
+
+	// Voxel markers only: draw every Nth voxel along each axis (1 = all); cuts triangle count by Stride^3 on large grids
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Visualizer", meta = (ClampMin = "1", UIMin = "1", UIMax = "8"))
+	int32 LODStride = 1;
+
+	// First Z slice shown (voxel markers only)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Visualizer", meta = (ClampMin = "0", UIMin = "0"))
+	int32 SliceMinZ = 0;
+
+	// Last Z slice shown (< 0 = up to the top of the grid)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Visualizer")
+	int32 SliceMaxZ = -1;
+
+	// Marker edge length as a fraction of the cell size
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Visualizer", meta = (ClampMin = "0.01", ClampMax = "1.0", UIMin = "0.01", UIMax = "1.0"))
+	float MarkerScale = 0.2f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Visualizer")
+	FColor VisibleColor = FColor::Green;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Visualizer")
+	FColor HiddenColor = FColor::Red;
+
+	// Upper bound on slices rebuilt per UpdateFromGrid call, to keep live updates from hitching
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Visualizer", meta = (ClampMin = "1", UIMin = "1"))
+	int32 MaxSlicesPerUpdate = 4;
+
+	// Vertex-color material applied to every section (defaults to the engine's debug vertex color material)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Visualizer")
+	TObjectPtr<UMaterialInterface> MarkerMaterial;
+
+	// Rebuild every slice (or the region mesh) from Grid
+	UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|Visualizer")
+	void BuildFromGrid(const FS_VoxelGrid &Grid);
+
+	// Replace the visualization with one box per region that passes Filter (independent of Mode)
+	UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|Visualizer")
+	void BuildFromRegions(const FS_VolumeAnalysisRegions &Regions);
+
+	/**
+	 * Rebuild only slices whose visibility changed since they were last built, at most MaxSlicesPerUpdate per call.
+	 * Falls back to a full rebuild if the grid layout changed. Returns true once every slice is up to date.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|Visualizer")
+	bool UpdateFromGrid(const FS_VoxelGrid &Grid);
+
+	// Re-apply SliceMinZ/SliceMaxZ to the existing sections (no rebuild)
+	UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|Visualizer")
+	void ApplySliceFilter();
+
+	UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|Visualizer")
+	void ClearVisualization();
+
+private:
+	// Drop cached state and size it for Grid's layout
+	void ResetForGrid(const FS_VoxelGrid &Grid);
+
+	bool IsLayoutCurrent(const FS_VoxelGrid &Grid) const;
+
+	// Visibility words overlapping slice Z
+	void GetSliceWordRange(int32 Z, int32 &OutFirstWord, int32 &OutNumWords) const;
+
+	bool HasSliceChanged(const FS_VoxelGrid &Grid, int32 Z) const;
+
+	void BuildSlice(const FS_VoxelGrid &Grid, int32 Z);
+
+	// Region mesh into section 0 (the caller clears other sections)
+	void BuildRegionMesh(const FS_VolumeAnalysisRegions &Regions);
+
+	// Append a vertex-colored box given in world space to the reused buffers
+	void AddBox(const FTransform &ToWorld, const FVector &Center, const FVector &Extent, const FColor &Color);
+
+	bool IsSliceShown(int32 Z) const;
+
+	// Layout the cached sections were built for
+	FVector BuiltOrigin = FVector::ZeroVector;
+	FVector BuiltCellSize = FVector::ZeroVector;
+	FIntVector BuiltCounts = FIntVector::ZeroValue;
+	TArray<double> BuiltEdgesX;
+	TArray<double> BuiltEdgesY;
+	TArray<double> BuiltEdgesZ;
+
+	// Visibility words as of each slice's last build (only the words of built slices are meaningful)
+	TArray<uint32> BuiltBits;
+	TBitArray<> SliceBuilt;
+
+	// The sections hold a region mesh (section 0) rather than slices
+	bool bBuiltRegions = false;
+
+	// Round-robin cursor so capped updates do not starve the upper slices
+	int32 NextSlice = 0;
+
+	// Reused vertex/index/color buffers
+	TArray<FVector> Vertices;
+	TArray<int32> Triangles;
+	TArray<FColor> Colors;
+};
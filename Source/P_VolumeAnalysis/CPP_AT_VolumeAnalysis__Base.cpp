@@ -1,14 +1,29 @@
 // Copyright (c) 2025
 #include "CPP_AT_VolumeAnalysis__Base.h"
 #include "CPP_BPL__VolumeAnalysis.h"
+#include "CPP_IO__VolumeAnalysisBinary.h"
+#include "CPP_IO__VolumeAnalysisCache.h"
+#include "CPP_IO__VolumeAnalysisTiles.h"
+#include "CPP_AC__VolumeAnalysisVisualizer.h"
+#include "CPP_EN__VolumeAnalysisStats.h"
+#include "CPP_SS__VolumeAnalysisScheduler.h"
+#include "CPP_DA__VolumeAnalysisBakedResults.h"
+#include "Camera/CameraComponent.h"
 #include "DrawDebugHelpers.h"
 #include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "EngineUtils.h"
+#include "TimerManager.h"
+#include "Misc/Paths.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogPVolActor, Log, All);
 
 ACPP_AT_VolumeAnalysis_Base::ACPP_AT_VolumeAnalysis_Base()
 {
     PrimaryActorTick.bCanEverTick = true;
+
+    ResultVisualizer = CreateDefaultSubobject<UCPP_AC__VolumeAnalysisVisualizer>(TEXT("ResultVisualizer"));
+    DebugLineBatcher = CreateDefaultSubobject<ULineBatchComponent>(TEXT("DebugLineBatcher"));
 }
 
 /**
@@ -17,15 +32,180 @@ ACPP_AT_VolumeAnalysis_Base::ACPP_AT_VolumeAnalysis_Base()
 void ACPP_AT_VolumeAnalysis_Base::BeginPlay()
 {
     Super::BeginPlay();
+    if (bLoadBakedResultsOnBeginPlay && BakedResults)
+    {
+        LoadBakedResults();
+    }
+}
+
+void ACPP_AT_VolumeAnalysis_Base::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    StopAnalysis();
+    Super::EndPlay(EndPlayReason);
+}
+
+void ACPP_AT_VolumeAnalysis_Base::PostLoad()
+{
+    Super::PostLoad();
+    // The old default (6 px points) maps onto the marker default (0.2 of a cell); only changed sizes are carried over
+    if (DebugPointSize_DEPRECATED != 6.f && ResultVisualizer)
+    {
+        ResultVisualizer->MarkerScale = FMath::Clamp(DebugPointSize_DEPRECATED / 30.f, 0.01f, 1.f);
+        DebugPointSize_DEPRECATED = 6.f;
+    }
+}
+
+#if WITH_EDITOR
+void ACPP_AT_VolumeAnalysis_Base::PostRegisterAllComponents()
+{
+    Super::PostRegisterAllComponents();
+    // Bound whatever bAutoMarkDirtyOnActorMoved is, so toggling it in the details panel takes effect immediately
+    if (GEngine && !ActorMovedHandle.IsValid())
+    {
+        ActorMovedHandle = GEngine->OnActorMoved().AddUObject(this, &ACPP_AT_VolumeAnalysis_Base::HandleEditorActorMoved);
+        ActorDeletedHandle = GEngine->OnLevelActorDeleted().AddUObject(this, &ACPP_AT_VolumeAnalysis_Base::HandleEditorActorRemoved);
+    }
+}
+
+void ACPP_AT_VolumeAnalysis_Base::UnregisterAllComponents(bool bForReregister)
+{
+    if (GEngine && ActorMovedHandle.IsValid())
+    {
+        GEngine->OnActorMoved().Remove(ActorMovedHandle);
+        GEngine->OnLevelActorDeleted().Remove(ActorDeletedHandle);
+        ActorMovedHandle.Reset();
+        ActorDeletedHandle.Reset();
+    }
+    Super::UnregisterAllComponents(bForReregister);
 }
+#endif
 
 void ACPP_AT_VolumeAnalysis_Base::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
-    if (bIsRunning)
+    if (bAutoMarkDirtyOnActorMoved && TrackedActorBounds.Num() > 0 && GetWorld() && GetWorld()->IsGameWorld())
+    {
+        PollTrackedActors();
+    }
+    if (!bIsRunning && bAutoReanalyzeDirtyRegions && DirtyRegions.Num() > 0)
+    {
+        ReanalyzeDirtyRegions();
+    }
+    if (!bIsRunning || !Engine.IsValid())
+    {
+        return;
+    }
+
+    if (bRunningParallel)
+    {
+        // Worker threads own the grid until the task finishes; pick up the result on the game thread.
+        // A scheduled run has no task until the scheduler grants it a worker slot.
+        if (ParallelTask.IsValid() && ParallelTask.IsCompleted())
+        {
+            FinishAnalysis();
+        }
+    }
+    else if (!bScheduled)
+    {
+        StepGameThread(TickBudgetMs * 0.001);
+    }
+}
+
+void ACPP_AT_VolumeAnalysis_Base::StepGameThread(double BudgetSeconds)
+{
+    const bool bDone = Engine->ProcessRowsStep(RowsPerTick, BudgetSeconds);
+    FlushDebugLines();
+    if (bDone)
+    {
+        FinishAnalysis();
+    }
+    else if (bDrawDebug && bDrawDebugPoints && bLiveDebugPoints && ResultVisualizer)
+    {
+        ResultVisualizer->UpdateFromGrid(Engine->GetGrid());
+    }
+}
+
+void ACPP_AT_VolumeAnalysis_Base::StepScheduledRun(double BudgetSeconds)
+{
+    if (bIsRunning && bScheduled && !bRunningParallel && Engine.IsValid())
+    {
+        StepGameThread(BudgetSeconds);
+    }
+}
+
+void ACPP_AT_VolumeAnalysis_Base::LaunchScheduledParallelRun()
+{
+    if (bIsRunning && bScheduled && bRunningParallel && Engine.IsValid() && !ParallelTask.IsValid())
+    {
+        LaunchParallelTask();
+    }
+}
+
+void ACPP_AT_VolumeAnalysis_Base::AdoptSharedResult(const FVolumeAnalysisResultRef &InResult, const FS_VolumeAnalysisRunSummary &InSummary)
+{
+    // Same grid layout and settings as the producing run, so its snapshot is exactly what this run would have produced
+    bScheduled = false;
+    StopAnalysis();
+    ResultSnapshot = InResult;
+    LastRunSummary = InSummary;
+    SnapshotTrackedActorBounds();
+    OnResultsLoaded(TEXT("Shared Analysis"), /*bRefreshDebug*/ true, /*bBroadcastComplete*/ true);
+}
+
+UCPP_SS__VolumeAnalysisScheduler *ACPP_AT_VolumeAnalysis_Base::GetScheduler() const
+{
+    UWorld *World = GetWorld();
+    return World ? World->GetSubsystem<UCPP_SS__VolumeAnalysisScheduler>() : nullptr;
+}
+
+FS_VolumeAnalysisSettings ACPP_AT_VolumeAnalysis_Base::GetAnalysisSettings() const
+{
+    FS_VolumeAnalysisSettings Settings;
+    Settings.TraceChannel = TraceChannel;
+    Settings.MaxTraceDistance = MaxTraceDistance;
+    Settings.RowTrace = RowTrace;
+    Settings.PhaseOrder = PhaseOrder;
+    Settings.bUseCenterOverlapTest = bUseCenterOverlapTest;
+    Settings.CenterOverlapRadius = CenterOverlapRadius;
+    Settings.bCenterOverlapPrePass = bCenterOverlapPrePass;
+    Settings.bClassifyPrimitiveShapes = bClassifyPrimitiveShapes;
+    Settings.bEnableSubSampling = bEnableSubSampling;
+    Settings.SubSampleCountX = SubSampleCountX;
+    Settings.SubSampleCountY = SubSampleCountY;
+    Settings.SubSampleCountZ = SubSampleCountZ;
+    Settings.Refinement = Refinement;
+    Settings.AdaptiveMaxDepth = AdaptiveMaxDepth;
+    Settings.bAdaptiveSolidCulling = bAdaptiveSolidCulling;
+    Settings.Visibility = VisibilityMode;
+    if (VisibilityMode == EE_VolumeAnalysisVisibility::FromOrigins)
     {
-        ProcessRowsStep(RowsPerTick);
+        // Actors are sampled now; the run keeps their pose from the moment it started
+        Settings.Origins = VisibilityOrigins;
+        for (const AActor *OriginActor : OriginActors)
+        {
+            if (!OriginActor)
+            {
+                continue;
+            }
+            FS_VolumeAnalysisOrigin &Origin = Settings.Origins.AddDefaulted_GetRef();
+            if (const UCameraComponent *Camera = OriginActor->FindComponentByClass<UCameraComponent>())
+            {
+                Origin.Location = Camera->GetComponentLocation();
+                Origin.Rotation = Camera->GetComponentRotation();
+                Origin.FieldOfView = Camera->FieldOfView;
+                Origin.AspectRatio = Camera->AspectRatio;
+            }
+            else
+            {
+                OriginActor->GetActorEyesViewPoint(Origin.Location, Origin.Rotation);
+            }
+        }
+        if (Settings.Origins.Num() > 8)
+        {
+            Settings.Origins.SetNum(8);
+        }
     }
+    return Settings;
 }
 
 void ACPP_AT_VolumeAnalysis_Base::StartAnalysis()
@@ -36,45 +216,60 @@ void ACPP_AT_VolumeAnalysis_Base::StartAnalysis()
         return;
     }
 
-    // Build AABB from provided volume box
-    const FBox AABB = UCPP_BPL__VolumeAnalysis::LinkedBox_GetAABB(VolumeBox);
-    if (!AABB.IsValid)
+    // Build AABB from provided volume box (or the shard's piece of its grid)
+    FBox AABB;
+    FIntVector Counts;
+    if (!GetRunLayout(AABB, Counts))
     {
-        UE_LOG(LogPVolActor, Warning, TEXT("StartAnalysis: Invalid AABB from VolumeBox"));
+        UE_LOG(LogPVolActor, Warning, TEXT("StartAnalysis: Invalid AABB from VolumeBox, or empty shard range"));
         return;
     }
 
-    // Generate voxel grid
-    PendingBoxes.Reset();
-    UCPP_BPL__VolumeAnalysis::GenerateVoxelGridBoxes_ByCounts(AABB, SampleCountX, SampleCountY, SampleCountZ, PendingBoxes);
+    if (IsGradedGrid() && (bTiledAnalysis || bAnalyzeShardOnly))
+    {
+        // Tiles and shards are cut on an evenly spaced lattice
+        UE_LOG(LogPVolActor, Warning, TEXT("StartAnalysis: CellGrowth above 1 cannot be combined with tiled or shard runs"));
+        return;
+    }
 
-    GridCountX = SampleCountX;
-    GridCountY = SampleCountY;
-    GridCountZ = SampleCountZ;
+    // Any previous run is abandoned; a full run makes pending dirty regions moot
+    StopAnalysis();
+    DirtyRegions.Reset();
+    if (bTiledAnalysis)
+    {
+        StartTiledAnalysis(UCPP_BPL__VolumeAnalysis::LinkedBox_GetAABB(VolumeBox));
+        return;
+    }
 
-    // Compute approx cell sizes (for overlap radius auto)
-    const FVector BoxSize = AABB.GetSize();
-    CellSizeX = (GridCountX > 0) ? (BoxSize.X / GridCountX) : 0.f;
-    CellSizeY = (GridCountY > 0) ? (BoxSize.Y / GridCountY) : 0.f;
-    CellSizeZ = (GridCountZ > 0) ? (BoxSize.Z / GridCountZ) : 0.f;
+    PendingCacheKey.Reset();
+    if (bUseResultCache && !IsGradedGrid())
+    {
+        const FString Key = GetResultCacheKey();
+        FS_VoxelGrid CachedGrid;
+        if (FVolumeAnalysisCache::Load(Key, AABB, Counts.X, Counts.Y, Counts.Z, CachedGrid))
+        {
+            UE_LOG(LogPVolActor, Display, TEXT("StartAnalysis: Loaded cached results (%s)"), *Key);
+            SetResultGrid(MoveTemp(CachedGrid));
+            SnapshotTrackedActorBounds();
+            OnResultsLoaded(TEXT("Result Cache"), /*bRefreshDebug*/ true, /*bBroadcastComplete*/ true);
+            return;
+        }
+        PendingCacheKey = Key;
+    }
 
-    // Reset visibility
-    for (FS_LinkedBox &B : PendingBoxes)
+    CreateEngine();
+    if (!Engine->Init(AABB, Counts.X, Counts.Y, Counts.Z, CellGrowth))
     {
-        B.VisibilityMask = 0;
+        UE_LOG(LogPVolActor, Warning, TEXT("StartAnalysis: Could not build voxel grid (%d x %d x %d)"), Counts.X, Counts.Y, Counts.Z);
+        Engine.Reset();
+        return;
     }
 
     // Reset state
-    AnalysisResults.Reset();
+    SetResultGrid(FS_VoxelGrid());
     VisibleCount = 0;
     HiddenCount = 0;
-    bIsSubSampling = false;
-    HiddenBoxIndices.Reset();
-    CurrentHiddenIndex = 0;
-    CurrentCellIndex = 0;
-    CurrentPhase = 0;
-    CurrentPhaseRowIndex = 0;
-    bIsRunning = true;
+    LaunchEngine();
 
     if (bDrawDebug && bDrawDebugBox)
     {
@@ -82,743 +277,944 @@ void ACPP_AT_VolumeAnalysis_Base::StartAnalysis()
     }
 }
 
-void ACPP_AT_VolumeAnalysis_Base::StopAnalysis()
-{
-    bIsRunning = false;
-    bIsSubSampling = false;
-}
-
-void ACPP_AT_VolumeAnalysis_Base::ClearResults()
+void ACPP_AT_VolumeAnalysis_Base::StartTiledAnalysis(const FBox &AABB)
 {
-    StopAnalysis();
-    AnalysisResults.Reset();
-    PendingBoxes.Reset();
+    // Only the running tile's grid is resident; finished tiles go straight to disk
+    SetResultGrid(FS_VoxelGrid());
     VisibleCount = 0;
     HiddenCount = 0;
-    GridCountX = GridCountY = GridCountZ = 0;
-    CellSizeX = CellSizeY = CellSizeZ = 0.f;
-    HiddenBoxIndices.Reset();
-    CurrentHiddenIndex = 0;
-    CurrentCellIndex = 0;
-    CurrentPhase = 0;
-    CurrentPhaseRowIndex = 0;
+    LastRunSummary = FS_VolumeAnalysisRunSummary();
+    TileStore = MakeShared<FVolumeAnalysisTileStore>();
+    if (!TileStore->BeginWrite(GetTileDirectory(), AABB, GetGridCounts(), TileSize, bCompressTiles))
+    {
+        UE_LOG(LogPVolActor, Warning, TEXT("StartAnalysis: Could not start tiled results in '%s'"), *GetTileDirectory());
+        TileStore.Reset();
+        return;
+    }
+
+    CurrentTile = 0;
+    if (!StartTile())
+    {
+        CurrentTile = INDEX_NONE;
+        TileStore.Reset();
+        return;
+    }
+
+    if (bDrawDebug && bDrawDebugBox)
+    {
+        DrawAABB(AABB, FColor::Yellow);
+    }
 }
 
-TArray<FS_LinkedBox> ACPP_AT_VolumeAnalysis_Base::GetAnalysisResults()
+bool ACPP_AT_VolumeAnalysis_Base::StartTile()
 {
-    return AnalysisResults;
+    // Like a shard, the tile is a regular run over its piece of the grid, grown to whole adaptive roots
+    const FVoxelRange Compute = FVolumeAnalysisEngine::GetShardComputeRange(GetAnalysisSettings(), TileStore->GetCounts(), TileStore->GetTileRange(CurrentTile));
+    const FIntVector Size = Compute.Max - Compute.Min;
+    CreateEngine();
+    if (Compute.IsEmpty() || !Engine->Init(TileStore->GetRangeBounds(Compute), Size.X, Size.Y, Size.Z))
+    {
+        UE_LOG(LogPVolActor, Warning, TEXT("StartAnalysis: Could not build voxel grid for tile %d (%d x %d x %d)"), CurrentTile, Size.X, Size.Y, Size.Z);
+        Engine.Reset();
+        return false;
+    }
+    LaunchEngine();
+    return true;
 }
 
-void ACPP_AT_VolumeAnalysis_Base::LoadAnalysisResults(const TArray<FS_LinkedBox> &InBoxes, bool bRefreshDebug, bool bBroadcastComplete)
+void ACPP_AT_VolumeAnalysis_Base::FinishTile()
 {
-    // Stop any running analysis and replace results with a copy of the provided data
-    StopAnalysis();
-    PendingBoxes.Reset();
-    AnalysisResults = InBoxes; // copy
+    const FS_VolumeAnalysisRunSummary TileSummary = Engine->GetRunSummary();
+    FS_VoxelGrid Computed = Engine->TakeGrid();
+    Engine.Reset();
 
-    // Recompute counts
-    VisibleCount = 0;
-    HiddenCount = 0;
-    for (const FS_LinkedBox &Box : AnalysisResults)
+    // Drop the halo so the tile file holds exactly its own voxels
+    const FVoxelRange Range = TileStore->GetTileRange(CurrentTile);
+    const FIntVector Size = Range.Max - Range.Min;
+    FS_VoxelGrid Tile;
+    if (Computed.CountX == Size.X && Computed.CountY == Size.Y && Computed.CountZ == Size.Z)
     {
-        if (Box.VisibilityMask)
-            ++VisibleCount;
-        else
-            ++HiddenCount;
+        Tile = MoveTemp(Computed);
+    }
+    else
+    {
+        Tile.Init(TileStore->GetRangeBounds(Range), Size.X, Size.Y, Size.Z);
+        Tile.CopyFrom(Computed);
+    }
+    if (!TileStore->WriteTile(CurrentTile, Tile))
+    {
+        UE_LOG(LogPVolActor, Warning, TEXT("Tiled analysis: Could not write tile %d to '%s'; it reads as hidden"), CurrentTile, *TileStore->GetDirectory());
     }
 
-    if (bRefreshDebug && bDrawDebug && bDrawDebugPoints && GetWorld())
+    const auto AddClamped = [](int32 &Total, int64 Value)
+    {
+        Total = static_cast<int32>(FMath::Min<int64>(int64(Total) + Value, MAX_int32));
+    };
+    AddClamped(LastRunSummary.NumVoxels, Tile.Num());
+    AddClamped(LastRunSummary.VisibleVoxels, Tile.CountVisible());
+    AddClamped(LastRunSummary.RefinedVoxels, TileSummary.RefinedVoxels);
+    LastRunSummary.LineTraces += TileSummary.LineTraces;
+    LastRunSummary.OverlapSweeps += TileSummary.OverlapSweeps;
+    LastRunSummary.OverlapCacheHits += TileSummary.OverlapCacheHits;
+
+    ++CurrentTile;
+    if (CurrentTile < TileStore->GetNumTiles())
     {
-        for (const FS_LinkedBox &Box : AnalysisResults)
+        if (StartTile())
         {
-            const FVector C = UCPP_BPL__VolumeAnalysis::LinkedBox_GetCenter(Box);
-            DrawDebugPoint(GetWorld(), C, DebugPointSize, Box.VisibilityMask ? FColor::Green : FColor::Red, DebugDrawDuration > 0.f, DebugDrawDuration);
+            return;
         }
+        UE_LOG(LogPVolActor, Warning, TEXT("Tiled analysis: Stopped at tile %d of %d; the rest read as hidden"), CurrentTile, TileStore->GetNumTiles());
     }
 
-    UE_LOG(LogPVolActor, Display, TEXT("LoadAnalysisResults: boxes=%d (Visible=%d Hidden=%d)"), AnalysisResults.Num(), VisibleCount, HiddenCount);
-    if (bBroadcastComplete)
-    {
-        OnAnalysisComplete.Broadcast(AnalysisResults);
-    }
+    CurrentTile = INDEX_NONE;
+    TileStore->FinishWrite();
+    TileStore->SetMaxResidentTiles(MaxResidentTiles);
+    LastRunSummary.WallSeconds = static_cast<float>(FPlatformTime::Seconds() - RunStartSeconds);
+    const int64 NumVoxels = TileStore->GetNumVoxels();
+    const double Queries = static_cast<double>(LastRunSummary.LineTraces + LastRunSummary.OverlapSweeps);
+    LastRunSummary.QueriesPerSecond = LastRunSummary.WallSeconds > 0.f ? static_cast<float>(Queries / LastRunSummary.WallSeconds) : 0.f;
+    LastRunSummary.QueriesPerVoxel = NumVoxels > 0 ? static_cast<float>(Queries / NumVoxels) : 0.f;
+
+    const int64 Visible = TileStore->CountVisible();
+    VisibleCount = static_cast<int32>(FMath::Min<int64>(Visible, MAX_int32));
+    HiddenCount = static_cast<int32>(FMath::Min<int64>(NumVoxels - Visible, MAX_int32));
+    UE_LOG(LogPVolActor, Display, TEXT("Tiled Analysis Complete; tiles=%d in '%s' (Visible=%lld Hidden=%lld); %s"), TileStore->GetNumTiles(), *TileStore->GetDirectory(), Visible, NumVoxels - Visible, *LastRunSummary.ToString());
+    BroadcastAnalysisComplete();
 }
 
-bool ACPP_AT_VolumeAnalysis_Base::LoadAnalysisResultsFromJsonFile(const FString &FilePath, bool bRefreshDebug, bool bBroadcastComplete)
+FString ACPP_AT_VolumeAnalysis_Base::GetTileDirectory() const
 {
-    TArray<FS_LinkedBox> Boxes;
-    if (!UCPP_BPL__VolumeAnalysis::LoadLinkedBoxesFromJsonFile(FilePath, Boxes))
+    return TileDirectory.IsEmpty() ? FPaths::ProjectSavedDir() / TEXT("VolumeAnalysis/Tiles") / GetName() : TileDirectory;
+}
+
+bool ACPP_AT_VolumeAnalysis_Base::LoadTiledResults(const FString &Directory)
+{
+    StopAnalysis();
+    DirtyRegions.Reset();
+    TSharedPtr<FVolumeAnalysisTileStore> Store = MakeShared<FVolumeAnalysisTileStore>();
+    const FString Dir = Directory.IsEmpty() ? GetTileDirectory() : Directory;
+    if (!Store->Open(Dir))
     {
-        UE_LOG(LogPVolActor, Warning, TEXT("LoadAnalysisResultsFromJsonFile: Failed to read '%s'"), *FilePath);
+        UE_LOG(LogPVolActor, Warning, TEXT("LoadTiledResults: Failed to read '%s'"), *FVolumeAnalysisTileStore::GetManifestPath(Dir));
         return false;
     }
-    LoadAnalysisResults(Boxes, bRefreshDebug, bBroadcastComplete);
+    Store->SetMaxResidentTiles(MaxResidentTiles);
+
+    SetResultGrid(FS_VoxelGrid());
+    TileStore = Store;
+    const int64 Visible = TileStore->CountVisible();
+    VisibleCount = static_cast<int32>(FMath::Min<int64>(Visible, MAX_int32));
+    HiddenCount = static_cast<int32>(FMath::Min<int64>(TileStore->GetNumVoxels() - Visible, MAX_int32));
+    UE_LOG(LogPVolActor, Display, TEXT("LoadTiledResults: tiles=%d (Visible=%lld Hidden=%lld)"), TileStore->GetNumTiles(), Visible, TileStore->GetNumVoxels() - Visible);
+    BroadcastAnalysisComplete();
     return true;
 }
 
-void ACPP_AT_VolumeAnalysis_Base::LoadSingleAnalysisResult(const FS_LinkedBox &InBox, bool bRefreshDebug, bool bBroadcastComplete)
+bool ACPP_AT_VolumeAnalysis_Base::HasTiledResults() const
 {
-    TArray<FS_LinkedBox> Boxes;
-    Boxes.Add(InBox);
-    LoadAnalysisResults(Boxes, bRefreshDebug, bBroadcastComplete);
+    return TileStore.IsValid() && TileStore->IsOpen() && CurrentTile == INDEX_NONE && !GetResultGrid().IsValid();
 }
 
-/**
- * Get number of visible points in current analysis
- */
-int32 ACPP_AT_VolumeAnalysis_Base::GetVisiblePointCount() const
+FString ACPP_AT_VolumeAnalysis_Base::GetResultCacheKey() const
 {
-    return VisibleCount;
+    FBox AABB;
+    FIntVector Counts;
+    if (!GetRunLayout(AABB, Counts))
+    {
+        return FString();
+    }
+    return FVolumeAnalysisCache::ComputeKey(GetWorld(), AABB, Counts.X, Counts.Y, Counts.Z, GetAnalysisSettings(), bIgnoreSelf ? this : nullptr);
 }
 
-/**
- * Get number of hidden points in current analysis
- */
-int32 ACPP_AT_VolumeAnalysis_Base::GetHiddenPointCount() const
+bool ACPP_AT_VolumeAnalysis_Base::GetRunLayout(FBox &OutVolume, FIntVector &OutCounts) const
 {
-    return HiddenCount;
+    OutVolume = UCPP_BPL__VolumeAnalysis::LinkedBox_GetAABB(VolumeBox);
+    OutCounts = GetGridCounts();
+    if (!OutVolume.IsValid)
+    {
+        return false;
+    }
+    if (!bAnalyzeShardOnly)
+    {
+        return true;
+    }
+    // The shard is a regular run over its (halo-grown) piece; its voxels line up with the full grid's
+    const FVector CellSize = OutVolume.GetSize() / FVector(OutCounts);
+    const FVoxelRange Compute = FVolumeAnalysisEngine::GetShardComputeRange(GetAnalysisSettings(), OutCounts, FVoxelRange(ShardMin, ShardMax));
+    if (Compute.IsEmpty())
+    {
+        return false;
+    }
+    OutVolume = FBox(OutVolume.Min + CellSize * FVector(Compute.Min), OutVolume.Min + CellSize * FVector(Compute.Max));
+    OutCounts = Compute.Max - Compute.Min;
+    return true;
 }
-/**
- * Get visibility percentage (0-100)
- */
-float ACPP_AT_VolumeAnalysis_Base::GetVisibilityPercentage() const
+
+bool ACPP_AT_VolumeAnalysis_Base::IsGradedGrid() const
 {
-    const int32 Total = VisibleCount + HiddenCount;
-    return (Total > 0) ? (static_cast<float>(VisibleCount) * 100.0f / static_cast<float>(Total)) : 0.0f;
+    return CellGrowth.X > 1.0 || CellGrowth.Y > 1.0 || CellGrowth.Z > 1.0;
 }
 
-void ACPP_AT_VolumeAnalysis_Base::ProcessRowsStep(int32 MaxRowsPerTick)
+FIntVector ACPP_AT_VolumeAnalysis_Base::GetGridCounts() const
 {
-    if (!GetWorld())
+    if (GridSizing == EE_VolumeAnalysisGridSizing::ByCellSize)
     {
-        UE_LOG(LogPVolActor, Warning, TEXT("ProcessRowsStep: No World"));
-        bIsRunning = false;
-        return;
+        return UCPP_BPL__VolumeAnalysis::ComputeCountsForCellSize(UCPP_BPL__VolumeAnalysis::LinkedBox_GetAABB(VolumeBox), TargetCellSize, MaxVoxels, CellGrowth);
     }
+    return FIntVector(SampleCountX, SampleCountY, SampleCountZ);
+}
 
-    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(VolumeAnalysis), /*bTraceComplex*/ true);
-    if (bIgnoreSelf)
-    {
-        QueryParams.AddIgnoredActor(this);
-    }
+TArray<FS_VolumeAnalysisShard> ACPP_AT_VolumeAnalysis_Base::PlanShards(const FIntVector &ShardsPerAxis) const
+{
+    TArray<FS_VolumeAnalysisShard> Shards;
+    FVolumeAnalysisEngine::PlanShards(GetAnalysisSettings(), GetGridCounts(), ShardsPerAxis, Shards);
+    return Shards;
+}
 
-    // If we're in sub-sampling mode, prioritize refining hidden boxes
-    if (bIsSubSampling)
+bool ACPP_AT_VolumeAnalysis_Base::LoadMergedShardResults(const TArray<FString> &FilePaths, bool bRefreshDebug, bool bBroadcastComplete)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ACPP_AT_VolumeAnalysis_Base::LoadMergedShardResults);
+    const FBox AABB = UCPP_BPL__VolumeAnalysis::LinkedBox_GetAABB(VolumeBox);
+    const FIntVector Counts = GetGridCounts();
+    FS_VoxelGrid Merged;
+    Merged.Init(AABB, Counts.X, Counts.Y, Counts.Z);
+    if (!Merged.IsValid())
     {
-        UE_LOG(LogPVolActor, VeryVerbose, TEXT("ProcessRowsStep: Entering SubSampling phase with %d remaining"), HiddenBoxIndices.Num() - CurrentHiddenIndex);
-        ProcessRowsStep_SubSampling(MaxRowsPerTick, QueryParams);
-        return;
+        UE_LOG(LogPVolActor, Warning, TEXT("LoadMergedShardResults: Invalid AABB from VolumeBox"));
+        return false;
     }
 
-    auto GetCenter = [&](const FS_LinkedBox &Box) -> FVector
-    {
-        return UCPP_BPL__VolumeAnalysis::LinkedBox_GetCenter(Box);
-    };
-
-    const auto Index = [&](int32 X, int32 Y, int32 Z) -> int32
+    // Halos overlap neighbouring shards with identical results, so later files may simply overwrite them
+    TBitArray<> Covered(false, Merged.Num());
+    for (const FString &FilePath : FilePaths)
     {
-        return Z * (GridCountY * GridCountX) + Y * GridCountX + X;
-    };
-
-    auto IsCenterFree = [&](const FVector &C) -> bool
-    {
-        if (!bUseCenterOverlapTest)
+        FS_VoxelGrid Part;
+        if (!FVolumeAnalysisBinary::LoadFromFile(FilePath, Part))
         {
-            return true;
+            UE_LOG(LogPVolActor, Warning, TEXT("LoadMergedShardResults: Failed to read '%s'"), *FilePath);
+            return false;
         }
-        const float AutoR = 0.25f * FMath::Max(0.001f, FMath::Min3(CellSizeX, CellSizeY, CellSizeZ));
-        const float Radius = (CenterOverlapRadius > 0.f) ? CenterOverlapRadius : AutoR;
-        FCollisionShape Shape = FCollisionShape::MakeSphere(Radius);
-        FHitResult OverlapHit;
-        const bool bHitOverlap = GetWorld()->SweepSingleByChannel(OverlapHit, C, C, FQuat::Identity, TraceChannel, Shape, QueryParams);
-        return !bHitOverlap;
-    };
-
-    // Helpers to scan a row along a principal axis using long traces segmented by hits
-    auto ScanRowX = [&](int32 YIndex, int32 ZIndex)
-    {
-        const int32 Count = GridCountX;
-        if (Count <= 0)
-            return;
-        const auto RowCenter = [&](int32 Xi) -> FVector
-        { return GetCenter(PendingBoxes[Index(Xi, YIndex, ZIndex)]); };
-
-        if (Count == 1)
+        const FVoxelRange Range = Merged.CopyFrom(Part);
+        if (Range.IsEmpty())
         {
-            const FVector C = RowCenter(0);
-            if (IsCenterFree(C))
-                PendingBoxes[Index(0, YIndex, ZIndex)].VisibilityMask = 1;
-            return;
+            UE_LOG(LogPVolActor, Warning, TEXT("LoadMergedShardResults: '%s' does not lie on this actor's grid"), *FilePath);
+            return false;
         }
-
-        const FVector FirstC = RowCenter(0);
-        const FVector SecondC = RowCenter(1);
-        const float StepLen = FVector::Distance(FirstC, SecondC);
-        int32 StartI = 0;
-        while (StartI < Count)
+        for (int32 Z = Range.Min.Z; Z < Range.Max.Z; ++Z)
         {
-            int32 TargetI = Count - 1;
-            if (MaxTraceDistance > 0.f && StepLen > KINDA_SMALL_NUMBER)
-            {
-                const int32 MaxSteps = FMath::Clamp(static_cast<int32>(FMath::FloorToInt(MaxTraceDistance / StepLen)), 1, Count - 1);
-                TargetI = FMath::Min(StartI + MaxSteps, Count - 1);
-            }
-            const FVector StartC = RowCenter(StartI);
-            const FVector EndC = RowCenter(TargetI);
-            FHitResult Hit;
-            const bool bHit = GetWorld()->LineTraceSingleByChannel(Hit, StartC, EndC, TraceChannel, QueryParams);
-            if (!bHit)
+            for (int32 Y = Range.Min.Y; Y < Range.Max.Y; ++Y)
             {
-                for (int32 i = StartI; i <= TargetI; ++i)
-                {
-                    const FVector C = RowCenter(i);
-                    if (IsCenterFree(C))
-                        PendingBoxes[Index(i, YIndex, ZIndex)].VisibilityMask = 1;
-                }
-                if (bDrawDebug && bDrawDebugRays)
-                {
-                    DrawDebugLine(GetWorld(), StartC, EndC, FColor::Green, DebugDrawDuration > 0.f, DebugDrawDuration, 0, DebugLineThickness);
-                }
-                StartI = TargetI + 1;
-            }
-            else
-            {
-                const float SegmentLen = FVector::Distance(StartC, EndC);
-                const float HitDist = FMath::Clamp(Hit.Time * SegmentLen, 0.f, SegmentLen);
-                int32 HitIndex = StartI;
-                if (StepLen > KINDA_SMALL_NUMBER)
-                {
-                    HitIndex = FMath::Clamp(StartI + FMath::FloorToInt(HitDist / StepLen + 1e-3f), StartI, TargetI);
-                }
-                for (int32 i = StartI; i <= HitIndex; ++i)
-                {
-                    const FVector C = RowCenter(i);
-                    if (IsCenterFree(C))
-                        PendingBoxes[Index(i, YIndex, ZIndex)].VisibilityMask = 1;
-                }
-                if (bDrawDebug && bDrawDebugRays)
-                {
-                    const FVector HitPoint = StartC + (EndC - StartC) * Hit.Time;
-                    DrawDebugLine(GetWorld(), StartC, HitPoint, FColor::Green, DebugDrawDuration > 0.f, DebugDrawDuration, 0, DebugLineThickness);
-                    DrawDebugLine(GetWorld(), HitPoint, EndC, FColor::Red, DebugDrawDuration > 0.f, DebugDrawDuration, 0, DebugLineThickness);
-                }
-                StartI = FMath::Min(HitIndex + 1, Count);
+                Covered.SetRange(Merged.Index(Range.Min.X, Y, Z), Range.Max.X - Range.Min.X, true);
             }
         }
-    };
-
-    auto ScanRowY = [&](int32 XIndex, int32 ZIndex)
+    }
+    const int32 NumUncovered = Merged.Num() - Covered.CountSetBits();
+    if (NumUncovered > 0)
     {
-        const int32 Count = GridCountY;
-        if (Count <= 0)
-            return;
-        const auto RowCenter = [&](int32 Yi) -> FVector
-        { return GetCenter(PendingBoxes[Index(XIndex, Yi, ZIndex)]); };
+        UE_LOG(LogPVolActor, Warning, TEXT("LoadMergedShardResults: %d voxels are not covered by any of the %d shards; they stay hidden"), NumUncovered, FilePaths.Num());
+    }
 
-        if (Count == 1)
-        {
-            const FVector C = RowCenter(0);
-            if (IsCenterFree(C))
-                PendingBoxes[Index(XIndex, 0, ZIndex)].VisibilityMask = 1;
-            return;
-        }
+    StopAnalysis();
+    DirtyRegions.Reset();
+    SetResultGrid(MoveTemp(Merged));
+    SnapshotTrackedActorBounds();
+    OnResultsLoaded(TEXT("Merged Shards"), bRefreshDebug, bBroadcastComplete);
+    return true;
+}
 
-        const FVector FirstC = RowCenter(0);
-        const FVector SecondC = RowCenter(1);
-        const float StepLen = FVector::Distance(FirstC, SecondC);
-        int32 StartI = 0;
-        while (StartI < Count)
-        {
-            int32 TargetI = Count - 1;
-            if (MaxTraceDistance > 0.f && StepLen > KINDA_SMALL_NUMBER)
-            {
-                const int32 MaxSteps = FMath::Clamp(static_cast<int32>(FMath::FloorToInt(MaxTraceDistance / StepLen)), 1, Count - 1);
-                TargetI = FMath::Min(StartI + MaxSteps, Count - 1);
-            }
-            const FVector StartC = RowCenter(StartI);
-            const FVector EndC = RowCenter(TargetI);
-            FHitResult Hit;
-            const bool bHit = GetWorld()->LineTraceSingleByChannel(Hit, StartC, EndC, TraceChannel, QueryParams);
-            if (!bHit)
-            {
-                for (int32 i = StartI; i <= TargetI; ++i)
-                {
-                    const FVector C = RowCenter(i);
-                    if (IsCenterFree(C))
-                        PendingBoxes[Index(XIndex, i, ZIndex)].VisibilityMask = 1;
-                }
-                if (bDrawDebug && bDrawDebugRays)
-                {
-                    DrawDebugLine(GetWorld(), StartC, EndC, FColor::Green, DebugDrawDuration > 0.f, DebugDrawDuration, 0, DebugLineThickness);
-                }
-                StartI = TargetI + 1;
-            }
-            else
-            {
-                const float SegmentLen = FVector::Distance(StartC, EndC);
-                const float HitDist = FMath::Clamp(Hit.Time * SegmentLen, 0.f, SegmentLen);
-                int32 HitIndex = StartI;
-                if (StepLen > KINDA_SMALL_NUMBER)
-                {
-                    HitIndex = FMath::Clamp(StartI + FMath::FloorToInt(HitDist / StepLen + 1e-3f), StartI, TargetI);
-                }
-                for (int32 i = StartI; i <= HitIndex; ++i)
-                {
-                    const FVector C = RowCenter(i);
-                    if (IsCenterFree(C))
-                        PendingBoxes[Index(XIndex, i, ZIndex)].VisibilityMask = 1;
-                }
-                if (bDrawDebug && bDrawDebugRays)
-                {
-                    const FVector HitPoint = StartC + (EndC - StartC) * Hit.Time;
-                    DrawDebugLine(GetWorld(), StartC, HitPoint, FColor::Green, DebugDrawDuration > 0.f, DebugDrawDuration, 0, DebugLineThickness);
-                    DrawDebugLine(GetWorld(), HitPoint, EndC, FColor::Red, DebugDrawDuration > 0.f, DebugDrawDuration, 0, DebugLineThickness);
-                }
-                StartI = FMath::Min(HitIndex + 1, Count);
-            }
-        }
-    };
+bool ACPP_AT_VolumeAnalysis_Base::LoadBakedResults(bool bRefreshDebug, bool bBroadcastComplete)
+{
+    FS_VoxelGrid BakedGrid;
+    if (!BakedResults || !BakedResults->CopyToGrid(BakedGrid))
+    {
+        UE_LOG(LogPVolActor, Warning, TEXT("LoadBakedResults: No baked results on %s"), *GetName());
+        return false;
+    }
 
-    auto ScanColumnZ = [&](int32 XIndex, int32 YIndex)
+    const FBox AABB = UCPP_BPL__VolumeAnalysis::LinkedBox_GetAABB(VolumeBox);
+    const FBox BakedBounds = BakedGrid.GetBounds();
+    const bool bSameLayout = AABB.IsValid && FIntVector(BakedGrid.CountX, BakedGrid.CountY, BakedGrid.CountZ) == GetGridCounts() && BakedBounds.Min.Equals(AABB.Min) && BakedBounds.Max.Equals(AABB.Max) && BakedGrid.IsUniform() != IsGradedGrid();
+    if (!bSameLayout)
     {
-        const int32 Count = GridCountZ;
-        if (Count <= 0)
-            return;
-        const auto ColCenter = [&](int32 Zi) -> FVector
-        { return GetCenter(PendingBoxes[Index(XIndex, YIndex, Zi)]); };
+        UE_LOG(LogPVolActor, Warning, TEXT("LoadBakedResults: '%s' was baked for a different volume or sample counts; rebake it"), *BakedResults->GetPathName());
+    }
+
+    StopAnalysis();
+    DirtyRegions.Reset();
+    SetResultGrid(MoveTemp(BakedGrid));
+    LastRunSummary = BakedResults->Summary;
+    SnapshotTrackedActorBounds();
+    OnResultsLoaded(TEXT("Baked Results"), bRefreshDebug, bBroadcastComplete);
+    return true;
+}
 
-        if (Count == 1)
+bool ACPP_AT_VolumeAnalysis_Base::RunAnalysisToCompletion()
+{
+    // Cleared first so a run that fails to start does not report the previous results
+    ClearResults();
+    {
+        // The scheduler is only stepped by the world tick, which does not run while this blocks
+        TGuardValue<bool> NoScheduler(bUseSharedScheduler, false);
+        StartAnalysis();
+    }
+    while (bIsRunning && Engine.IsValid())
+    {
+        if (bRunningParallel)
         {
-            const FVector C = ColCenter(0);
-            if (IsCenterFree(C))
-                PendingBoxes[Index(XIndex, YIndex, 0)].VisibilityMask = 1;
-            return;
+            ParallelTask.Wait();
+            FinishAnalysis();
         }
-
-        const FVector FirstC = ColCenter(0);
-        const FVector SecondC = ColCenter(1);
-        const float StepLen = FVector::Distance(FirstC, SecondC);
-        int32 StartI = 0;
-        while (StartI < Count)
+        else
         {
-            int32 TargetI = Count - 1;
-            if (MaxTraceDistance > 0.f && StepLen > KINDA_SMALL_NUMBER)
-            {
-                const int32 MaxSteps = FMath::Clamp(static_cast<int32>(FMath::FloorToInt(MaxTraceDistance / StepLen)), 1, Count - 1);
-                TargetI = FMath::Min(StartI + MaxSteps, Count - 1);
-            }
-            const FVector StartC = ColCenter(StartI);
-            const FVector EndC = ColCenter(TargetI);
-            FHitResult Hit;
-            const bool bHit = GetWorld()->LineTraceSingleByChannel(Hit, StartC, EndC, TraceChannel, QueryParams);
-            if (!bHit)
-            {
-                for (int32 i = StartI; i <= TargetI; ++i)
-                {
-                    const FVector C = ColCenter(i);
-                    if (IsCenterFree(C))
-                        PendingBoxes[Index(XIndex, YIndex, i)].VisibilityMask = 1;
-                }
-                if (bDrawDebug && bDrawDebugRays)
-                {
-                    DrawDebugLine(GetWorld(), StartC, EndC, FColor::Green, DebugDrawDuration > 0.f, DebugDrawDuration, 0, DebugLineThickness);
-                }
-                StartI = TargetI + 1;
-            }
-            else
-            {
-                const float SegmentLen = FVector::Distance(StartC, EndC);
-                const float HitDist = FMath::Clamp(Hit.Time * SegmentLen, 0.f, SegmentLen);
-                int32 HitIndex = StartI;
-                if (StepLen > KINDA_SMALL_NUMBER)
-                {
-                    HitIndex = FMath::Clamp(StartI + FMath::FloorToInt(HitDist / StepLen + 1e-3f), StartI, TargetI);
-                }
-                for (int32 i = StartI; i <= HitIndex; ++i)
-                {
-                    const FVector C = ColCenter(i);
-                    if (IsCenterFree(C))
-                        PendingBoxes[Index(XIndex, YIndex, i)].VisibilityMask = 1;
-                }
-                if (bDrawDebug && bDrawDebugRays)
-                {
-                    const FVector HitPoint = StartC + (EndC - StartC) * Hit.Time;
-                    DrawDebugLine(GetWorld(), StartC, HitPoint, FColor::Green, DebugDrawDuration > 0.f, DebugDrawDuration, 0, DebugLineThickness);
-                    DrawDebugLine(GetWorld(), HitPoint, EndC, FColor::Red, DebugDrawDuration > 0.f, DebugDrawDuration, 0, DebugLineThickness);
-                }
-                StartI = FMath::Min(HitIndex + 1, Count);
-            }
+            StepGameThread(0.05);
         }
-    };
+    }
+    return GetResultGrid().IsValid() || HasTiledResults();
+}
 
-    int32 RowsProcessed = 0;
-    while (bIsRunning && RowsProcessed < MaxRowsPerTick && CurrentPhase < 3)
+#if WITH_EDITOR
+void ACPP_AT_VolumeAnalysis_Base::BakeResults()
+{
+    if (!BakedResults)
     {
-        if (CurrentPhase == 0)
-        {
-            const int32 TotalRows = GridCountY * GridCountZ;
-            if (TotalRows <= 0)
-            {
-                CurrentPhase = 1;
-                CurrentPhaseRowIndex = 0;
-                continue;
-            }
+        UE_LOG(LogPVolActor, Warning, TEXT("BakeResults: Assign a Volume Analysis Baked Results asset first (or run CPP_CMD__VolumeAnalysisBake, which creates one)"));
+        return;
+    }
+    if (!RunAnalysisToCompletion())
+    {
+        UE_LOG(LogPVolActor, Warning, TEXT("BakeResults: Analysis of %s did not complete"), *GetName());
+        return;
+    }
+    BakedResults->SetFromGrid(GetResultGrid(), LastRunSummary, GetResultCacheKey());
+    BakedResults->MarkPackageDirty();
+    UE_LOG(LogPVolActor, Display, TEXT("BakeResults: Stored %d voxels in '%s'"), GetResultGrid().Num(), *BakedResults->GetPathName());
+}
+#endif
 
-            const int32 RowIdx = CurrentPhaseRowIndex;
-            if (RowIdx >= TotalRows)
-            {
-                CurrentPhase = 1;
-                CurrentPhaseRowIndex = 0;
-                continue;
-            }
-            const int32 ZIndex = RowIdx / GridCountY;
-            const int32 YIndex = RowIdx % GridCountY;
-            ScanRowX(YIndex, ZIndex);
-            ++CurrentPhaseRowIndex;
-            ++RowsProcessed;
-        }
-        else if (CurrentPhase == 1)
-        {
-            const int32 TotalRows = GridCountX * GridCountZ;
-            if (TotalRows <= 0)
-            {
-                CurrentPhase = 2;
-                CurrentPhaseRowIndex = 0;
-                continue;
-            }
-            const int32 RowIdx = CurrentPhaseRowIndex;
-            if (RowIdx >= TotalRows)
-            {
-                CurrentPhase = 2;
-                CurrentPhaseRowIndex = 0;
-                continue;
-            }
-            const int32 ZIndex = RowIdx / GridCountX;
-            const int32 XIndex = RowIdx % GridCountX;
-            ScanRowY(XIndex, ZIndex);
-            ++CurrentPhaseRowIndex;
-            ++RowsProcessed;
-        }
-        else if (CurrentPhase == 2)
+void ACPP_AT_VolumeAnalysis_Base::CreateEngine()
+{
+    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(VolumeAnalysis), /*bTraceComplex*/ true);
+    if (bIgnoreSelf)
+    {
+        QueryParams.AddIgnoredActor(this);
+    }
+    if (VisibilityMode == EE_VolumeAnalysisVisibility::FromOrigins)
+    {
+        // Eye and camera points sit inside the origin actor's own collision, which would otherwise occlude everything
+        for (const AActor *OriginActor : OriginActors)
         {
-            const int32 TotalCols = GridCountX * GridCountY;
-            if (TotalCols <= 0)
-            {
-                CurrentPhase = 3;
-                break;
-            }
-            const int32 ColIdx = CurrentPhaseRowIndex;
-            if (ColIdx >= TotalCols)
+            if (OriginActor)
             {
-                CurrentPhase = 3;
-                break;
+                QueryParams.AddIgnoredActor(OriginActor);
             }
-            const int32 YIndex = ColIdx / GridCountX;
-            const int32 XIndex = ColIdx % GridCountX;
-            ScanColumnZ(XIndex, YIndex);
-            ++CurrentPhaseRowIndex;
-            ++RowsProcessed;
         }
     }
 
-    // progress log
-    if (bIsRunning && CurrentPhase < 3)
+    Engine = MakeShared<FVolumeAnalysisEngine, ESPMode::ThreadSafe>(GetWorld(), GetAnalysisSettings(), QueryParams);
+    Engine->DebugDraw.bDrawRays = bDrawDebug && bDrawDebugRays;
+    Engine->DebugDraw.bDrawSubBoxes = bDrawDebug && bDrawDebugSubBoxes;
+    Engine->DebugDraw.LineThickness = DebugLineThickness;
+    Engine->DebugDraw.Duration = DebugDrawDuration;
+    Engine->DebugDraw.LineBuffer = DebugLineBatcher ? &PendingDebugLines : nullptr;
+}
+
+void ACPP_AT_VolumeAnalysis_Base::LaunchEngine()
+{
+    bIsRunning = true;
+    if (CurrentTile <= 0)
     {
-        UE_LOG(LogPVolActor, VeryVerbose, TEXT("ProcessRowsStep: Phase=%d Row=%d"), CurrentPhase, CurrentPhaseRowIndex);
+        // A tiled run is timed from its first tile
+        RunStartSeconds = FPlatformTime::Seconds();
     }
+    GetWorldTimerManager().ClearTimer(ResultPointsTimer);
 
-    const bool bMainCompleted = (CurrentPhase >= 3);
-    if (bMainCompleted)
-    {
-        // Signal main pass complete by setting CurrentCellIndex beyond range for compatibility with downstream logic
-        CurrentCellIndex = PendingBoxes.Num();
+    bRunningParallel = (ExecutionMode == EE_VolumeAnalysisExecution::ParallelWorkers);
 
-        if (bEnableSubSampling && !bIsSubSampling)
+    // Tiles are not shared between actors and must come back through FinishAnalysis, so they bypass the scheduler
+    UCPP_SS__VolumeAnalysisScheduler *Scheduler = (bUseSharedScheduler && CurrentTile == INDEX_NONE) ? GetScheduler() : nullptr;
+    bScheduled = (Scheduler != nullptr);
+    if (bScheduled)
+    {
+        // The scheduler steps game-thread runs and launches parallel ones when a worker slot frees up
+        if (!Scheduler->SubmitJob(this, Engine->GetGrid(), GetAnalysisSettings(), Engine->IsIncremental(), bRunningParallel))
         {
-            HiddenBoxIndices.Reset();
-            HiddenBoxIndices.Reserve(PendingBoxes.Num());
-            int32 TmpVisible = 0;
-            for (int32 i = 0; i < PendingBoxes.Num(); ++i)
-            {
-                if (PendingBoxes[i].VisibilityMask == 0)
-                {
-                    HiddenBoxIndices.Add(i);
-                }
-                else
-                {
-                    ++TmpVisible;
-                }
-            }
-            const int32 TmpHidden = HiddenBoxIndices.Num();
-            bIsSubSampling = TmpHidden > 0;
-            CurrentHiddenIndex = 0;
-            if (bIsSubSampling)
-            {
-                bIsRunning = true;
-                UE_LOG(LogPVolActor, Display, TEXT("SubSampling: %d hidden boxes to refine (Visible after main=%d, Hidden=%d)"), HiddenBoxIndices.Num(), TmpVisible, TmpHidden);
-                const int32 Remaining = MaxRowsPerTick - RowsProcessed;
-                if (Remaining > 0)
-                {
-                    ProcessRowsStep_SubSampling(Remaining, QueryParams);
-                }
-                else
-                {
-                    UE_LOG(LogPVolActor, VeryVerbose, TEXT("SubSampling: Deferring to next tick (no remaining budget)"));
-                }
-                return;
-            }
-            else
-            {
-                UE_LOG(LogPVolActor, Display, TEXT("SubSampling: Skipped (no hidden boxes). Main pass: Visible=%d Hidden=%d; bEnableSubSampling=%s"), TmpVisible, TmpHidden, bEnableSubSampling ? TEXT("true") : TEXT("false"));
-            }
+            // An identical run is already in flight; its result arrives through AdoptSharedResult
+            Engine.Reset();
         }
+        return;
+    }
+    if (bRunningParallel)
+    {
+        LaunchParallelTask();
+    }
+}
 
-        if (!bIsSubSampling)
-        {
-            bIsRunning = false;
-            VisibleCount = 0;
-            HiddenCount = 0;
-            for (const FS_LinkedBox &Box : PendingBoxes)
-            {
-                if (Box.VisibilityMask)
-                    ++VisibleCount;
-                else
-                    ++HiddenCount;
-            }
-            AnalysisResults = PendingBoxes;
-            if (bDrawDebug && bDrawDebugPoints)
-            {
-                for (const FS_LinkedBox &Box : AnalysisResults)
-                {
-                    const FVector C = UCPP_BPL__VolumeAnalysis::LinkedBox_GetCenter(Box);
-                    DrawDebugPoint(GetWorld(), C, DebugPointSize, Box.VisibilityMask ? FColor::Green : FColor::Red, DebugDrawDuration > 0.f, DebugDrawDuration);
-                }
-            }
-            UE_LOG(LogPVolActor, Display, TEXT("ProcessRowsStep: Complete; boxes=%d (Visible=%d Hidden=%d)"), AnalysisResults.Num(), VisibleCount, HiddenCount);
-            OnAnalysisComplete.Broadcast(AnalysisResults);
-        }
+void ACPP_AT_VolumeAnalysis_Base::LaunchParallelTask()
+{
+    TSharedPtr<FVolumeAnalysisEngine, ESPMode::ThreadSafe> RunEngine = Engine;
+    ParallelTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [RunEngine]()
+                                     { RunEngine->RunParallel(); });
+}
+
+void ACPP_AT_VolumeAnalysis_Base::MarkRegionDirty(const FBox &WorldBounds)
+{
+    if (!WorldBounds.IsValid)
+    {
+        return;
     }
-    else if (bIsSubSampling)
+    // Skip changes that cannot touch the analysed volume
+    if (GetResultGrid().IsValid() && !GetResultGrid().GetBounds().Intersect(WorldBounds))
     {
-        const int32 Remaining = MaxRowsPerTick - RowsProcessed;
-        if (Remaining > 0)
-        {
-            ProcessRowsStep_SubSampling(Remaining, QueryParams);
-        }
-        else
-        {
-            UE_LOG(LogPVolActor, VeryVerbose, TEXT("SubSampling: Skipped this tick (no remaining budget)"));
-        }
+        return;
     }
+    DirtyRegions.Add(WorldBounds);
 }
 
-// Sub-sampling tick extension
-void ACPP_AT_VolumeAnalysis_Base::ProcessRowsStep_SubSampling(int32 MaxCellsPerTick, const FCollisionQueryParams &QueryParams)
+void ACPP_AT_VolumeAnalysis_Base::MarkActorDirty(AActor *Actor)
 {
-    if (!bIsSubSampling || HiddenBoxIndices.Num() == 0)
+    if (!Actor || Actor == this)
     {
         return;
     }
+    // Both where the actor was when last seen and where it is now need rescanning
+    if (const FBox *Previous = TrackedActorBounds.Find(Actor))
+    {
+        MarkRegionDirty(*Previous);
+    }
+    const FBox Current = Actor->GetComponentsBoundingBox(/*bNonColliding*/ false);
+    MarkRegionDirty(Current);
+    if (Current.IsValid)
+    {
+        TrackedActorBounds.Add(Actor, Current);
+    }
+    else
+    {
+        TrackedActorBounds.Remove(Actor);
+    }
+}
 
-    auto GetCenter = [&](const FS_LinkedBox &Box) -> FVector
+bool ACPP_AT_VolumeAnalysis_Base::ReanalyzeDirtyRegions()
+{
+    if (bIsRunning || DirtyRegions.Num() == 0)
     {
-        return UCPP_BPL__VolumeAnalysis::LinkedBox_GetCenter(Box);
-    };
+        return false;
+    }
+    if (!GetWorld() || !GetResultGrid().IsValid())
+    {
+        UE_LOG(LogPVolActor, Warning, TEXT("ReanalyzeDirtyRegions: No previous result to update; run StartAnalysis first"));
+        return false;
+    }
 
-    const auto Index = [&](int32 X, int32 Y, int32 Z) -> int32
+    CreateEngine();
+    const bool bStarted = Engine->InitIncremental(GetResultGrid(), DirtyRegions, MoveTemp(ResultOverlapCache));
+    ResultOverlapCache.Reset();
+    UE_LOG(LogPVolActor, Display, TEXT("ReanalyzeDirtyRegions: %d dirty regions%s"), DirtyRegions.Num(), !bStarted ? TEXT(" (none inside the volume)") : (Engine->IsIncremental() ? TEXT("") : TEXT(" (full re-trace from origins)")));
+    InFlightDirtyRegions = MoveTemp(DirtyRegions);
+    DirtyRegions.Reset();
+    if (!bStarted)
     {
-        return Z * (GridCountY * GridCountX) + Y * GridCountX + X;
-    };
+        Engine.Reset();
+        return false;
+    }
+    // The current snapshot stays readable until the updated grid replaces it in FinishAnalysis
+    LaunchEngine();
+    return true;
+}
 
-    auto TraceBetween = [&](const FVector &P0, const FVector &P1) -> bool
+#if WITH_EDITOR
+void ACPP_AT_VolumeAnalysis_Base::HandleEditorActorMoved(AActor *Actor)
+{
+    if (bAutoMarkDirtyOnActorMoved && Actor && Actor->GetWorld() == GetWorld())
     {
-        FHitResult Hit;
-        const bool bHit = GetWorld()->LineTraceSingleByChannel(Hit, P0, P1, TraceChannel, QueryParams);
-        return !bHit; // true if clear path
-    };
+        MarkActorDirty(Actor);
+    }
+}
 
-    auto IsCenterFree = [&](const FVector &C) -> bool
+void ACPP_AT_VolumeAnalysis_Base::HandleEditorActorRemoved(AActor *Actor)
+{
+    if (!bAutoMarkDirtyOnActorMoved)
     {
-        if (!bUseCenterOverlapTest)
-        {
-            return true;
-        }
-        const float AutoR = 0.25f * FMath::Max(0.001f, FMath::Min3(CellSizeX, CellSizeY, CellSizeZ));
-        const float Radius = (CenterOverlapRadius > 0.f) ? CenterOverlapRadius : AutoR;
-        FCollisionShape Shape = FCollisionShape::MakeSphere(Radius);
-        FHitResult Hit;
-        const bool bHit = GetWorld()->SweepSingleByChannel(Hit, C, C, FQuat::Identity, TraceChannel, Shape, QueryParams);
-        return !bHit;
-    };
+        return;
+    }
+    if (const FBox *Previous = TrackedActorBounds.Find(Actor))
+    {
+        MarkRegionDirty(*Previous);
+        TrackedActorBounds.Remove(Actor);
+    }
+}
+#endif
 
-    int32 RefinedThisTick = 0;
-    while (bIsRunning && RefinedThisTick < MaxCellsPerTick && CurrentHiddenIndex < HiddenBoxIndices.Num())
+void ACPP_AT_VolumeAnalysis_Base::PollTrackedActors()
+{
+    // Gameplay moves send no notification; static actors cannot move at runtime, so only movable ones are compared
+    for (auto It = TrackedActorBounds.CreateIterator(); It; ++It)
     {
-        const int32 BoxIdx = HiddenBoxIndices[CurrentHiddenIndex];
-        FS_LinkedBox &Box = PendingBoxes[BoxIdx];
-        if (Box.VisibilityMask != 0)
+        AActor *Actor = It.Key().Get();
+        if (!Actor)
         {
-            ++CurrentHiddenIndex;
-            continue; // already flipped by earlier refinement
+            MarkRegionDirty(It.Value());
+            It.RemoveCurrent();
+            continue;
         }
-
-        // Build sub-voxel grid within this box's AABB
-        const FBox BoxAABB = UCPP_BPL__VolumeAnalysis::LinkedBox_GetAABB(Box);
-        TArray<FS_LinkedBox> SubVoxels;
-        UCPP_BPL__VolumeAnalysis::GenerateVoxelGridBoxes_ByCounts(BoxAABB, SubSampleCountX, SubSampleCountY, SubSampleCountZ, SubVoxels);
-        if (bDrawDebug && bDrawDebugSubBoxes)
+        if (!Actor->IsRootComponentMovable())
         {
-            for (const FS_LinkedBox &SV : SubVoxels)
-            {
-                const FBox SVBox = UCPP_BPL__VolumeAnalysis::LinkedBox_GetAABB(SV);
-                DrawAABB(SVBox, FColor(0, 255, 255)); // cyan sub-box wireframes
-            }
+            continue;
         }
-
-        bool bAnyVisible = false;
-        // Optimize refinement using long-trace row scanning along X inside the parent sample
-        const auto IndexSub = [&](int32 X, int32 Y, int32 Z) -> int32
+        const FBox Current = Actor->GetComponentsBoundingBox(/*bNonColliding*/ false);
+        if (Current != It.Value())
         {
-            return Z * (SubSampleCountY * SubSampleCountX) + Y * SubSampleCountX + X;
-        };
-
-        auto SubCenter = [&](int32 X, int32 Y, int32 Z) -> FVector
-        {
-            return GetCenter(SubVoxels[IndexSub(X, Y, Z)]);
-        };
-
-        // Helper to scan a 1D row by long trace and set bAnyVisible if any free center is reachable
-        auto ScanSubRow = [&](int32 Count, const TFunction<FVector(int32)> &CenterAt)
-        {
-            if (Count <= 0)
-                return;
-            if (Count == 1)
-            {
-                const FVector C = CenterAt(0);
-                if (IsCenterFree(C))
-                    bAnyVisible = true;
-                return;
-            }
-            const FVector FirstC = CenterAt(0), SecondC = CenterAt(1);
-            const float StepLen = FVector::Distance(FirstC, SecondC);
-            int32 StartI = 0;
-            while (StartI < Count)
+            MarkRegionDirty(It.Value());
+            MarkRegionDirty(Current);
+            if (Current.IsValid)
             {
-                int32 TargetI = Count - 1;
-                if (MaxTraceDistance > 0.f && StepLen > KINDA_SMALL_NUMBER)
-                {
-                    const int32 MaxSteps = FMath::Clamp(static_cast<int32>(FMath::FloorToInt(MaxTraceDistance / StepLen)), 1, Count - 1);
-                    TargetI = FMath::Min(StartI + MaxSteps, Count - 1);
-                }
-                const FVector StartC = CenterAt(StartI);
-                const FVector EndC = CenterAt(TargetI);
-                FHitResult Hit;
-                const bool bHit = GetWorld()->LineTraceSingleByChannel(Hit, StartC, EndC, TraceChannel, QueryParams);
-                if (!bHit)
-                {
-                    for (int32 i = StartI; i <= TargetI; ++i)
-                    {
-                        const FVector C = CenterAt(i);
-                        if (IsCenterFree(C))
-                            bAnyVisible = true;
-                    }
-                    if (bDrawDebug && bDrawDebugRays)
-                    {
-                        DrawDebugLine(GetWorld(), StartC, EndC, FColor::Cyan, DebugDrawDuration > 0.f, DebugDrawDuration, 0, DebugLineThickness * 0.6f);
-                    }
-                    StartI = TargetI + 1;
-                }
-                else
-                {
-                    const float SegmentLen = FVector::Distance(StartC, EndC);
-                    const float HitDist = FMath::Clamp(Hit.Time * SegmentLen, 0.f, SegmentLen);
-                    int32 HitIndex = StartI;
-                    if (StepLen > KINDA_SMALL_NUMBER)
-                    {
-                        HitIndex = FMath::Clamp(StartI + FMath::FloorToInt(HitDist / StepLen + 1e-3f), StartI, TargetI);
-                    }
-                    for (int32 i = StartI; i <= HitIndex; ++i)
-                    {
-                        const FVector C = CenterAt(i);
-                        if (IsCenterFree(C))
-                            bAnyVisible = true;
-                    }
-                    if (bDrawDebug && bDrawDebugRays)
-                    {
-                        const FVector HitPoint = StartC + (EndC - StartC) * Hit.Time;
-                        DrawDebugLine(GetWorld(), StartC, HitPoint, FColor::Cyan, DebugDrawDuration > 0.f, DebugDrawDuration, 0, DebugLineThickness * 0.6f);
-                        DrawDebugLine(GetWorld(), HitPoint, EndC, FColor::Red, DebugDrawDuration > 0.f, DebugDrawDuration, 0, DebugLineThickness * 0.6f);
-                    }
-                    StartI = FMath::Min(HitIndex + 1, Count);
-                }
+                It.Value() = Current;
             }
-        };
-
-        // X-axis rows at fixed (y,z)
-        for (int32 z = 0; z < SubSampleCountZ; ++z)
-        {
-            for (int32 y = 0; y < SubSampleCountY; ++y)
+            else
             {
-                ScanSubRow(SubSampleCountX, [&](int32 x)
-                           { return SubCenter(x, y, z); });
+                It.RemoveCurrent();
             }
         }
-        // Y-axis rows at fixed (x,z)
-        for (int32 z = 0; z < SubSampleCountZ; ++z)
+    }
+}
+
+void ACPP_AT_VolumeAnalysis_Base::SnapshotTrackedActorBounds()
+{
+    TrackedActorBounds.Reset();
+    UWorld *World = GetWorld();
+    if (!bAutoMarkDirtyOnActorMoved || !World || !GetResultGrid().IsValid())
+    {
+        return;
+    }
+    // Remember where overlapping actors are so a later move can also dirty the space they leave
+    const FBox VolumeBounds = GetResultGrid().GetBounds();
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        AActor *Actor = *It;
+        if (Actor == this)
         {
-            for (int32 x = 0; x < SubSampleCountX; ++x)
-            {
-                ScanSubRow(SubSampleCountY, [&](int32 y)
-                           { return SubCenter(x, y, z); });
-            }
+            continue;
         }
-        // Z-axis columns at fixed (x,y)
-        for (int32 y = 0; y < SubSampleCountY; ++y)
+        const FBox Bounds = Actor->GetComponentsBoundingBox(/*bNonColliding*/ false);
+        if (Bounds.IsValid && Bounds.Intersect(VolumeBounds))
         {
-            for (int32 x = 0; x < SubSampleCountX; ++x)
-            {
-                ScanSubRow(SubSampleCountZ, [&](int32 z)
-                           { return SubCenter(x, y, z); });
-            }
+            TrackedActorBounds.Add(Actor, Bounds);
         }
+    }
+}
 
-        if (bAnyVisible)
+void ACPP_AT_VolumeAnalysis_Base::StopAnalysis()
+{
+    if (bScheduled)
+    {
+        bScheduled = false;
+        if (UCPP_SS__VolumeAnalysisScheduler *Scheduler = GetScheduler())
         {
-            Box.VisibilityMask = 1;
+            Scheduler->CancelJob(this);
         }
+    }
+    if (Engine.IsValid())
+    {
+        Engine->Cancel();
+    }
+    if (bRunningParallel && ParallelTask.IsValid())
+    {
+        // Workers bail out after their current row; wait so nothing touches the world afterwards
+        ParallelTask.Wait();
+    }
+    // A cancelled incremental update leaves the previous result untouched, so its regions are still dirty
+    DirtyRegions.Append(InFlightDirtyRegions);
+    InFlightDirtyRegions.Reset();
+    ParallelTask = UE::Tasks::FTask();
+    Engine.Reset();
+    bRunningParallel = false;
+    bIsRunning = false;
+    if (CurrentTile != INDEX_NONE)
+    {
+        // Keep the tiles finished so far readable; the rest are recorded as missing (hidden)
+        CurrentTile = INDEX_NONE;
+        TileStore->FinishWrite();
+        TileStore->SetMaxResidentTiles(MaxResidentTiles);
+    }
+}
+
+void ACPP_AT_VolumeAnalysis_Base::ClearResults()
+{
+    StopAnalysis();
+    SetResultGrid(FS_VoxelGrid());
+    TileStore.Reset();
+    VisibleCount = 0;
+    HiddenCount = 0;
+    DirtyRegions.Reset();
+    TrackedActorBounds.Reset();
+    if (GetWorld())
+    {
+        GetWorldTimerManager().ClearTimer(ResultPointsTimer);
+    }
+    if (ResultVisualizer)
+    {
+        ResultVisualizer->ClearVisualization();
+    }
+    if (DebugLineBatcher)
+    {
+        DebugLineBatcher->Flush();
+    }
+}
+
+TArray<FS_LinkedBox> ACPP_AT_VolumeAnalysis_Base::GetAnalysisResults()
+{
+    TArray<FS_LinkedBox> Boxes;
+    GetResultGrid().ToLinkedBoxes(Boxes);
+    return Boxes;
+}
+
+FS_VoxelGrid ACPP_AT_VolumeAnalysis_Base::GetAnalysisResultGrid() const
+{
+    return GetResultGrid();
+}
+
+bool ACPP_AT_VolumeAnalysis_Base::GetAnalysisRegions(bool bIncludeHidden, FS_VolumeAnalysisRegions &OutRegions) const
+{
+    // Tiled results are never resident as one grid, so they have no region list
+    return OutRegions.Build(GetResultGrid(), bIncludeHidden);
+}
+
+void ACPP_AT_VolumeAnalysis_Base::SetResultGrid(FS_VoxelGrid &&InGrid)
+{
+    if (InGrid.IsValid())
+    {
+        // Grid results replace a tiled result
+        TileStore.Reset();
+    }
+    ResultSnapshot = MakeShared<FS_VoxelGrid, ESPMode::ThreadSafe>(MoveTemp(InGrid));
+    SummedVolume.Reset();
+    ResultOverlapCache.Reset();
+}
+
+void ACPP_AT_VolumeAnalysis_Base::UpdateResultStats()
+{
+    const FS_VoxelGrid &Grid = GetResultGrid();
+    VisibleCount = Grid.CountVisible();
+    HiddenCount = Grid.Num() - VisibleCount;
+    if (bBuildSummedVolumeTable && Grid.IsValid())
+    {
+        SummedVolume.Build(Grid);
+    }
+    else
+    {
+        SummedVolume.Reset();
+    }
+}
+
+void ACPP_AT_VolumeAnalysis_Base::LoadAnalysisResults(const TArray<FS_LinkedBox> &InBoxes, bool bRefreshDebug, bool bBroadcastComplete)
+{
+    // Stop any running analysis and rebuild the result grid from the provided boxes
+    StopAnalysis();
+    FS_VoxelGrid LoadedGrid;
+    if (!LoadedGrid.InitFromLinkedBoxes(InBoxes))
+    {
+        UE_LOG(LogPVolActor, Warning, TEXT("LoadAnalysisResults: %d boxes do not form a dense uniform grid; results cleared"), InBoxes.Num());
+    }
+    SetResultGrid(MoveTemp(LoadedGrid));
+    OnResultsLoaded(TEXT("LoadAnalysisResults"), bRefreshDebug, bBroadcastComplete);
+}
+
+void ACPP_AT_VolumeAnalysis_Base::LoadAnalysisResults(FS_VoxelGrid &&InGrid, bool bRefreshDebug, bool bBroadcastComplete)
+{
+    StopAnalysis();
+    SetResultGrid(MoveTemp(InGrid));
+    OnResultsLoaded(TEXT("LoadAnalysisResults"), bRefreshDebug, bBroadcastComplete);
+}
+
+void ACPP_AT_VolumeAnalysis_Base::LoadAnalysisResults(const FVolumeAnalysisResultRef &InResult, bool bRefreshDebug, bool bBroadcastComplete)
+{
+    // Snapshots are immutable, so sharing one with its producer is safe
+    StopAnalysis();
+    ResultSnapshot = InResult;
+    OnResultsLoaded(TEXT("LoadAnalysisResults"), bRefreshDebug, bBroadcastComplete);
+}
 
-        ++CurrentHiddenIndex;
-        ++RefinedThisTick;
+void ACPP_AT_VolumeAnalysis_Base::OnResultsLoaded(const TCHAR *Context, bool bRefreshDebug, bool bBroadcastComplete)
+{
+    // Recompute counts
+    UpdateResultStats();
+
+    if (bRefreshDebug && bDrawDebug && bDrawDebugPoints && GetWorld())
+    {
+        DrawResultPoints();
     }
 
-    // If sub-sampling finished, finalize
-    if (CurrentHiddenIndex >= HiddenBoxIndices.Num())
+    UE_LOG(LogPVolActor, Display, TEXT("%s: boxes=%d (Visible=%d Hidden=%d)"), Context, GetResultGrid().Num(), VisibleCount, HiddenCount);
+    if (bBroadcastComplete)
     {
-        bIsSubSampling = false;
-        bIsRunning = false;
+        BroadcastAnalysisComplete();
+    }
+}
 
-        // Compute final counts
+bool ACPP_AT_VolumeAnalysis_Base::LoadAnalysisResultsFromBinaryFile(const FString &FilePath, bool bRefreshDebug, bool bBroadcastComplete)
+{
+    StopAnalysis();
+    FS_VoxelGrid LoadedGrid;
+    const bool bLoaded = FVolumeAnalysisBinary::LoadFromFile(FilePath, LoadedGrid);
+    SetResultGrid(MoveTemp(LoadedGrid));
+    if (!bLoaded)
+    {
+        UE_LOG(LogPVolActor, Warning, TEXT("LoadAnalysisResultsFromBinaryFile: Failed to read '%s'"), *FilePath);
         VisibleCount = 0;
         HiddenCount = 0;
-        for (const FS_LinkedBox &B : PendingBoxes)
+        return false;
+    }
+    OnResultsLoaded(TEXT("LoadAnalysisResultsFromBinaryFile"), bRefreshDebug, bBroadcastComplete);
+    return true;
+}
+
+bool ACPP_AT_VolumeAnalysis_Base::SaveAnalysisResultsToBinaryFile(const FString &FilePath, bool bCompress) const
+{
+    return FVolumeAnalysisBinary::SaveToFile(GetResultGrid(), FilePath, bCompress);
+}
+
+bool ACPP_AT_VolumeAnalysis_Base::LoadAnalysisResultsFromJsonFile(const FString &FilePath, bool bRefreshDebug, bool bBroadcastComplete)
+{
+    TArray<FS_LinkedBox> Boxes;
+    if (!UCPP_BPL__VolumeAnalysis::LoadLinkedBoxesFromJsonFile(FilePath, Boxes))
+    {
+        UE_LOG(LogPVolActor, Warning, TEXT("LoadAnalysisResultsFromJsonFile: Failed to read '%s'"), *FilePath);
+        return false;
+    }
+    LoadAnalysisResults(Boxes, bRefreshDebug, bBroadcastComplete);
+    return true;
+}
+
+void ACPP_AT_VolumeAnalysis_Base::LoadSingleAnalysisResult(const FS_LinkedBox &InBox, bool bRefreshDebug, bool bBroadcastComplete)
+{
+    TArray<FS_LinkedBox> Boxes;
+    Boxes.Add(InBox);
+    LoadAnalysisResults(Boxes, bRefreshDebug, bBroadcastComplete);
+}
+
+/**
+ * Get number of visible points in current analysis
+ */
+int32 ACPP_AT_VolumeAnalysis_Base::GetVoxelIndexAt(const FVector &WorldLocation) const
+{
+    if (HasTiledResults())
+    {
+        FIntVector Voxel;
+        return TileStore->GetVoxelAt(WorldLocation, Voxel) ? GetTiledVoxelIndex(Voxel) : INDEX_NONE;
+    }
+    return GetResultGrid().GetVoxelIndexAt(WorldLocation);
+}
+
+int32 ACPP_AT_VolumeAnalysis_Base::GetTiledVoxelIndex(const FIntVector &Voxel) const
+{
+    const int64 Index = TileStore->GetLinearIndex(Voxel);
+    return Index <= MAX_int32 ? static_cast<int32>(Index) : INDEX_NONE;
+}
+
+bool ACPP_AT_VolumeAnalysis_Base::IsPointVisible(const FVector &WorldLocation) const
+{
+    if (HasTiledResults())
+    {
+        FIntVector Voxel;
+        return TileStore->GetVoxelAt(WorldLocation, Voxel) && TileStore->IsVisible(Voxel);
+    }
+    return GetResultGrid().IsPointVisible(WorldLocation);
+}
+
+int32 ACPP_AT_VolumeAnalysis_Base::GetOriginMaskAt(const FVector &WorldLocation) const
+{
+    if (HasTiledResults())
+    {
+        FIntVector Voxel;
+        return TileStore->GetVoxelAt(WorldLocation, Voxel) ? TileStore->GetOriginMask(Voxel) : 0;
+    }
+    const int32 Index = GetResultGrid().GetVoxelIndexAt(WorldLocation);
+    return (Index != INDEX_NONE) ? GetResultGrid().GetOriginMask(Index) : 0;
+}
+
+bool ACPP_AT_VolumeAnalysis_Base::IsPointVisibleFromOrigin(const FVector &WorldLocation, int32 OriginIndex) const
+{
+    return OriginIndex >= 0 && OriginIndex < 8 && (GetOriginMaskAt(WorldLocation) & (1 << OriginIndex)) != 0;
+}
+
+int32 ACPP_AT_VolumeAnalysis_Base::GetVisibleVoxelCountInBox(const FBox &WorldBox) const
+{
+    return static_cast<int32>(FMath::Min<int64>(CountVisibleInRange(GetResultVoxelRange(WorldBox)), MAX_int32));
+}
+
+int32 ACPP_AT_VolumeAnalysis_Base::GetVisibleVoxelCountInRange(const FIntVector &MinIndex, const FIntVector &MaxIndex) const
+{
+    return static_cast<int32>(FMath::Min<int64>(CountVisibleInRange(ClampToResultGrid(MinIndex, MaxIndex + FIntVector(1))), MAX_int32));
+}
+
+float ACPP_AT_VolumeAnalysis_Base::GetVisibilityPercentageInRange(const FIntVector &MinIndex, const FIntVector &MaxIndex) const
+{
+    const FVoxelRange Range = ClampToResultGrid(MinIndex, MaxIndex + FIntVector(1));
+    const int64 Total = Range.Num();
+    return Total > 0 ? static_cast<float>(CountVisibleInRange(Range) * 100.0 / Total) : 0.0f;
+}
+
+float ACPP_AT_VolumeAnalysis_Base::GetVisibilityPercentageInBox(const FBox &WorldBox) const
+{
+    const FVoxelRange Range = GetResultVoxelRange(WorldBox);
+    const int64 Total = Range.Num();
+    return Total > 0 ? static_cast<float>(CountVisibleInRange(Range) * 100.0 / Total) : 0.0f;
+}
+
+int64 ACPP_AT_VolumeAnalysis_Base::CountVisibleInRange(const FVoxelRange &Range) const
+{
+    if (HasTiledResults())
+    {
+        return TileStore->CountVisibleInRange(Range);
+    }
+    if (SummedVolume.Matches(GetResultGrid()))
+    {
+        return SummedVolume.CountVisible(Range);
+    }
+    return GetResultGrid().CountVisibleInRange(Range);
+}
+
+FVoxelRange ACPP_AT_VolumeAnalysis_Base::ClampToResultGrid(const FIntVector &MinIndex, const FIntVector &MaxIndexExclusive) const
+{
+    const FS_VoxelGrid &Grid = GetResultGrid();
+    const FIntVector Counts = HasTiledResults() ? TileStore->GetCounts() : FIntVector(Grid.CountX, Grid.CountY, Grid.CountZ);
+    FVoxelRange Range;
+    for (int32 Axis = 0; Axis < 3; ++Axis)
+    {
+        Range.Min[Axis] = FMath::Clamp(MinIndex[Axis], 0, Counts[Axis]);
+        Range.Max[Axis] = FMath::Clamp(MaxIndexExclusive[Axis], 0, Counts[Axis]);
+    }
+    return Range;
+}
+
+bool ACPP_AT_VolumeAnalysis_Base::RaymarchResults(const FVector &Start, const FVector &End, bool bFindVisible, FVector &OutHitLocation, int32 &OutVoxelIndex) const
+{
+    OutHitLocation = End;
+    if (HasTiledResults())
+    {
+        FIntVector Voxel;
+        const bool bHit = TileStore->Raymarch(Start, End, bFindVisible, OutHitLocation, Voxel);
+        OutVoxelIndex = bHit ? GetTiledVoxelIndex(Voxel) : INDEX_NONE;
+        return bHit;
+    }
+    return GetResultGrid().Raymarch(Start, End, bFindVisible, OutHitLocation, OutVoxelIndex);
+}
+
+FVoxelRange ACPP_AT_VolumeAnalysis_Base::GetResultVoxelRange(const FBox &WorldBox) const
+{
+    return HasTiledResults() ? TileStore->GetVoxelRange(WorldBox) : GetResultGrid().GetVoxelRange(WorldBox);
+}
+
+int32 ACPP_AT_VolumeAnalysis_Base::GetVisiblePointCount() const
+{
+    return VisibleCount;
+}
+
+/**
+ * Get number of hidden points in current analysis
+ */
+int32 ACPP_AT_VolumeAnalysis_Base::GetHiddenPointCount() const
+{
+    return HiddenCount;
+}
+/**
+ * Get visibility percentage (0-100)
+ */
+float ACPP_AT_VolumeAnalysis_Base::GetVisibilityPercentage() const
+{
+    if (HasTiledResults())
+    {
+        // Tiled grids may exceed the int32 counts
+        const int64 NumVoxels = TileStore->GetNumVoxels();
+        return NumVoxels > 0 ? static_cast<float>(double(TileStore->CountVisible()) * 100.0 / double(NumVoxels)) : 0.0f;
+    }
+    const int32 Total = VisibleCount + HiddenCount;
+    return (Total > 0) ? (static_cast<float>(VisibleCount) * 100.0f / static_cast<float>(Total)) : 0.0f;
+}
+
+float ACPP_AT_VolumeAnalysis_Base::GetAnalysisProgress() const
+{
+    if (bIsRunning && Engine.IsValid())
+    {
+        if (CurrentTile != INDEX_NONE)
         {
-            if (B.VisibilityMask)
-                ++VisibleCount;
-            else
-                ++HiddenCount;
+            return (CurrentTile + Engine->GetProgress()) / FMath::Max(TileStore->GetNumTiles(), 1);
         }
-        AnalysisResults = PendingBoxes;
+        return Engine->GetProgress();
+    }
+    return (GetResultGrid().IsValid() || HasTiledResults()) ? 1.0f : 0.0f;
+}
 
-        if (bDrawDebug && bDrawDebugPoints)
+float ACPP_AT_VolumeAnalysis_Base::GetEstimatedTimeRemaining() const
+{
+    if (!bIsRunning || !Engine.IsValid())
+    {
+        return 0.0f;
+    }
+    const float Progress = GetAnalysisProgress();
+    if (Progress <= 0.0f)
+    {
+        return -1.0f;
+    }
+    const double Elapsed = FPlatformTime::Seconds() - RunStartSeconds;
+    return static_cast<float>(Elapsed * (1.0 - Progress) / Progress);
+}
+
+void ACPP_AT_VolumeAnalysis_Base::FinishAnalysis()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ACPP_AT_VolumeAnalysis_Base::FinishAnalysis);
+    SCOPE_CYCLE_COUNTER(STAT_PVol_Finalize);
+    bIsRunning = false;
+    bRunningParallel = false;
+    ParallelTask = UE::Tasks::FTask();
+    UCPP_SS__VolumeAnalysisScheduler *Scheduler = bScheduled ? GetScheduler() : nullptr;
+    bScheduled = false;
+    if (!Engine.IsValid() || !Engine->IsComplete())
+    {
+        Engine.Reset();
+        if (Scheduler)
         {
-            for (const FS_LinkedBox &B : AnalysisResults)
-            {
-                const FVector C = UCPP_BPL__VolumeAnalysis::LinkedBox_GetCenter(B);
-                DrawDebugPoint(GetWorld(), C, DebugPointSize, B.VisibilityMask ? FColor::Green : FColor::Red, DebugDrawDuration > 0.f, DebugDrawDuration);
-            }
+            Scheduler->CancelJob(this);
         }
-        UE_LOG(LogPVolActor, Display, TEXT("SubSampling: Complete; boxes=%d (Visible=%d Hidden=%d)"), AnalysisResults.Num(), VisibleCount, HiddenCount);
-        OnAnalysisComplete.Broadcast(AnalysisResults);
+        return;
+    }
+
+    if (CurrentTile != INDEX_NONE)
+    {
+        FinishTile();
+        return;
+    }
+
+    const bool bWasIncremental = Engine->IsIncremental();
+    InFlightDirtyRegions.Reset();
+    LastRunSummary = Engine->GetRunSummary();
+    TArray<uint8> OverlapCache;
+    const bool bKeepOverlapCache = bAutoMarkDirtyOnActorMoved || bAutoReanalyzeDirtyRegions;
+    SetResultGrid(Engine->TakeGrid(bKeepOverlapCache ? &OverlapCache : nullptr));
+    ResultOverlapCache = MoveTemp(OverlapCache);
+    Engine.Reset();
+    if (!bWasIncremental)
+    {
+        SnapshotTrackedActorBounds();
+        if (!PendingCacheKey.IsEmpty())
+        {
+            FVolumeAnalysisCache::Save(PendingCacheKey, GetResultGrid(), bCompressResultCache);
+        }
+    }
+    PendingCacheKey.Reset();
+    UpdateResultStats();
+    if (Scheduler)
+    {
+        // Before broadcasting, so a listener starting a new run does not meet the finished job
+        Scheduler->CompleteJob(this);
+    }
+
+    if (bDrawDebug && bDrawDebugPoints)
+    {
+        DrawResultPoints();
     }
+    UE_LOG(LogPVolActor, Display, TEXT("Analysis Complete; boxes=%d (Visible=%d Hidden=%d); %s"), GetResultGrid().Num(), VisibleCount, HiddenCount, *LastRunSummary.ToString());
+    BroadcastAnalysisComplete();
 }
 
 void ACPP_AT_VolumeAnalysis_Base::DrawAABB(const FBox &Box, const FColor &Color) const
@@ -829,3 +1225,37 @@ void ACPP_AT_VolumeAnalysis_Base::DrawAABB(const FBox &Box, const FColor &Color)
     const FVector E = Box.GetExtent();
     DrawDebugBox(GetWorld(), C, E, FQuat::Identity, Color, /*bPersistentLines*/ DebugDrawDuration > 0.f, DebugDrawDuration, 0, DebugLineThickness);
 }
+
+void ACPP_AT_VolumeAnalysis_Base::DrawResultPoints()
+{
+    if (!ResultVisualizer)
+        return;
+    ResultVisualizer->BuildFromGrid(GetResultGrid());
+    if (DebugDrawDuration > 0.f)
+    {
+        GetWorldTimerManager().SetTimer(ResultPointsTimer, ResultVisualizer.Get(), &UCPP_AC__VolumeAnalysisVisualizer::ClearVisualization, DebugDrawDuration, false);
+    }
+}
+
+void ACPP_AT_VolumeAnalysis_Base::FlushDebugLines()
+{
+    SCOPE_CYCLE_COUNTER(STAT_PVol_DebugDraw);
+    if (PendingDebugLines.Num() > 0 && DebugLineBatcher)
+    {
+        DebugLineBatcher->DrawLines(PendingDebugLines);
+    }
+    PendingDebugLines.Reset();
+}
+
+void ACPP_AT_VolumeAnalysis_Base::BroadcastAnalysisComplete()
+{
+    OnResultsReady.Broadcast(ResultSnapshot);
+    OnAnalysisResultsUpdated.Broadcast();
+    if (!OnAnalysisComplete.IsBound())
+    {
+        return;
+    }
+    TArray<FS_LinkedBox> Boxes;
+    GetResultGrid().ToLinkedBoxes(Boxes);
+    OnAnalysisComplete.Broadcast(Boxes);
+}
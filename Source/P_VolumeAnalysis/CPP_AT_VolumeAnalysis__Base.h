@@ -12,14 +12,29 @@
 #include "Engine/World.h"
 #include "Engine/EngineTypes.h"
 #include "CPP_BPL__VolumeAnalysis.h"
+#include "CPP_EN__VolumeAnalysisEngine.h"
+#include "Tasks/Task.h"
+#include "Engine/TimerHandle.h"
+#include "Components/LineBatchComponent.h"
 #include "CPP_AT_VolumeAnalysis__Base.generated.h"
 
+class UCPP_AC__VolumeAnalysisVisualizer;
+class UCPP_SS__VolumeAnalysisScheduler;
+class UCPP_DA__VolumeAnalysisBakedResults;
+class FVolumeAnalysisTileStore;
+
 /**
  * Delegate for broadcasting when Volume Analysis is complete
  * Allows other systems to react to finished analysis
  */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnVolumeAnalysisComplete, const TArray<FS_LinkedBox> &, AnalysisResultBoxes);
 
+/** Fired alongside FOnVolumeAnalysisComplete without building the linked-box array (query the actor instead) */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnVolumeAnalysisResultsUpdated);
+
+/** Native completion event carrying the shared result snapshot (no copy) */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnVolumeAnalysisResultsReady, const FVolumeAnalysisResultRef & /*Result*/);
+
 /**
  * Main VolumeAnalysis Actor class
  */
@@ -36,6 +51,18 @@ protected:
     /** Called when the game starts or when spawned */
     virtual void BeginPlay() override;
 
+    /** Cancels a running analysis and waits for worker threads before the world goes away */
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    /** Carries values of deprecated properties over to their replacements */
+    virtual void PostLoad() override;
+
+#if WITH_EDITOR
+    /** Editor move/delete notifications are followed while the actor is registered, in editor and game worlds alike */
+    virtual void PostRegisterAllComponents() override;
+    virtual void UnregisterAllComponents(bool bForReregister = false) override;
+#endif
+
 public:
     /** Called every frame to update analysis if needed */
     virtual void Tick(float DeltaTime) override;
@@ -60,6 +87,22 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Sampling", meta = (ClampMin = "1", UIMin = "1"))
     int32 SampleCountZ = 16;
 
+    /** Take the grid resolution from the SampleCounts, or from TargetCellSize so cost follows the volume's size */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Sampling")
+    EE_VolumeAnalysisGridSizing GridSizing = EE_VolumeAnalysisGridSizing::ByCounts;
+
+    /** World units per cell with ByCellSize (the first, smallest cell along axes with CellGrowth above 1) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Sampling", meta = (ClampMin = "1", UIMin = "1", EditCondition = "GridSizing == EE_VolumeAnalysisGridSizing::ByCellSize"))
+    FVector TargetCellSize = FVector(50.0);
+
+    /** Voxel budget with ByCellSize: larger grids are coarsened evenly until they fit (0 = no cap) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Sampling", meta = (ClampMin = "0", UIMin = "0", EditCondition = "GridSizing == EE_VolumeAnalysisGridSizing::ByCellSize"))
+    int64 MaxVoxels = 8388608;
+
+    /** Size ratio of neighbouring cells per axis (1 = even spacing); above 1 cells are finest at the volume's min side, e.g. Z = 1.1 for detail near the floor. Graded grids skip the result cache and cannot be sharded or tiled */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Sampling", meta = (ClampMin = "1", ClampMax = "4", UIMin = "1", UIMax = "1.5"))
+    FVector CellGrowth = FVector::OneVector;
+
     /** Trace channel used for visibility checks */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Trace")
     TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
@@ -72,6 +115,14 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Trace", meta = (ClampMin = "0", UIMin = "0"))
     float MaxTraceDistance = 0.f;
 
+    /** Row scan queries: single-hit segments restarted after every wall, or a forward and a reverse multi-hit trace per segment that find the open space between blocking shapes, with single-hit segments only across each shape's span */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Trace")
+    EE_VolumeAnalysisRowTrace RowTrace = EE_VolumeAnalysisRowTrace::Segmented;
+
+    /** Fixed X, Y, Z scan order, or the axis with the longest rows first (fewest traces; later phases skip resolved voxels) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Trace")
+    EE_VolumeAnalysisPhaseOrder PhaseOrder = EE_VolumeAnalysisPhaseOrder::Fixed;
+
     /** Whether to draw debug points/lines */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Debug")
     bool bDrawDebug = true;
@@ -84,23 +135,27 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Debug")
     bool bDrawDebugRays = true;
 
-    /** Draw sample points colored by visibility */
+    /** Draw sample points colored by visibility (one batched mesh, see ResultVisualizer for LOD/slice filtering) */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Debug")
     bool bDrawDebugPoints = true;
 
+    /** Keep the point mesh in sync while a game-thread run is in progress (changed slices only, capped per tick) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Debug", meta = (EditCondition = "bDrawDebugPoints"))
+    bool bLiveDebugPoints = false;
+
     /** Draw sub-sample boxes for hidden samples during sub-sampling */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Debug")
     bool bDrawDebugSubBoxes = false;
 
-    /** Size of debug points */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Debug", meta = (ClampMin = "0", UIMin = "0"))
-    float DebugPointSize = 6.f;
+    /** Points are drawn as meshed markers now; a saved size is converted to ResultVisualizer's MarkerScale on load */
+    UPROPERTY(meta = (DeprecatedProperty, DeprecationMessage = "Use ResultVisualizer's MarkerScale instead."))
+    float DebugPointSize_DEPRECATED = 6.f;
 
     /** Debug line thickness */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Debug", meta = (ClampMin = "0", UIMin = "0"))
     float DebugLineThickness = 0.5f;
 
-    /** Duration seconds to persist debug draw (0 = one frame) */
+    /** Duration seconds to persist debug draw (0 = one frame; the point mesh then stays until the next run or ClearResults) */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Debug", meta = (ClampMin = "0", UIMin = "0"))
     float DebugDrawDuration = 2.0f;
 
@@ -108,6 +163,14 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Performance", meta = (ClampMin = "1", UIMin = "1"))
     int32 RowsPerTick = 8;
 
+    /** Per-frame time budget for the game-thread path in milliseconds; when > 0 it replaces RowsPerTick and rows/cells are processed until the budget is spent */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Performance", meta = (ClampMin = "0.0", UIMin = "0.0", UIMax = "16.0", Units = "ms"))
+    float TickBudgetMs = 0.f;
+
+    /** Where the analysis runs: throttled on the game thread, or across worker threads (no per-ray debug draw) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Performance")
+    EE_VolumeAnalysisExecution ExecutionMode = EE_VolumeAnalysisExecution::GameThreadTick;
+
     /** Treat voxel centers overlapping blocking geometry as hidden; if true, a voxel must have a free center AND a clear neighbor trace to be visible */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Visibility")
     bool bUseCenterOverlapTest = true;
@@ -116,6 +179,29 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Visibility", meta = (ClampMin = "0.0", UIMin = "0.0"))
     float CenterOverlapRadius = 0.0f;
 
+    /** Resolve every voxel center overlap once up front as a batched pre-pass before the row scans (results are cached either way) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Visibility", meta = (EditCondition = "bUseCenterOverlapTest"))
+    bool bCenterOverlapPrePass = false;
+
+    /** Gather blocking boxes, spheres, capsules and convex hulls once per run and test voxel centers against them in memory; physics sweeps are only issued near other geometry (complex meshes, landscapes, skeletal bodies) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Visibility", meta = (EditCondition = "bUseCenterOverlapTest"))
+    bool bClassifyPrimitiveShapes = false;
+
+    //////////////////////////////////////////////////////////////////////////
+    // ORIGINS (line of sight from points/cameras instead of open space connectivity)
+    //////////////////////////////////////////////////////////////////////////
+    /** Connectivity axis scans, or per-voxel line of sight from VisibilityOrigins and OriginActors (one origin mask bit each) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Origins")
+    EE_VolumeAnalysisVisibility VisibilityMode = EE_VolumeAnalysisVisibility::Connectivity;
+
+    /** Fixed origins; bits are assigned in order, first these, then OriginActors (at most 8 in total) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Origins", meta = (EditCondition = "VisibilityMode == EE_VolumeAnalysisVisibility::FromOrigins"))
+    TArray<FS_VolumeAnalysisOrigin> VisibilityOrigins;
+
+    /** Actors resolved to origins when a run starts: camera frustum if they have a camera component, else omnidirectional from their eyes. Their own collision is ignored by the run. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Origins", meta = (EditCondition = "VisibilityMode == EE_VolumeAnalysisVisibility::FromOrigins"))
+    TArray<TObjectPtr<AActor>> OriginActors;
+
     //////////////////////////////////////////////////////////////////////////
     // SUB-SAMPLING (refine only boxes still hidden after the main pass)
     //////////////////////////////////////////////////////////////////////////
@@ -133,14 +219,124 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|SubSampling", meta = (ClampMin = "1", UIMin = "1"))
     int32 SubSampleCountZ = 2;
 
+    //////////////////////////////////////////////////////////////////////////
+    // ADAPTIVE (octree refinement instead of the uniform row scan)
+    //////////////////////////////////////////////////////////////////////////
+    /** Uniform row scan + sub-sampling, or coarse-to-fine octree classification that only subdivides mixed cells */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Adaptive")
+    EE_VolumeAnalysisRefinement Refinement = EE_VolumeAnalysisRefinement::Uniform;
+
+    /** Octree levels above the voxel grid (root cells span 2^Depth voxels per axis) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Adaptive", meta = (ClampMin = "0", ClampMax = "10", UIMin = "0", UIMax = "6", EditCondition = "Refinement == EE_VolumeAnalysisRefinement::Adaptive"))
+    int32 AdaptiveMaxDepth = 3;
+
+    /** Skip mixed cells whose center and 8 corners are all inside blocking geometry (faster, may miss enclosed pockets) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Adaptive", meta = (EditCondition = "Refinement == EE_VolumeAnalysisRefinement::Adaptive"))
+    bool bAdaptiveSolidCulling = true;
+
+    //////////////////////////////////////////////////////////////////////////
+    // INCREMENTAL (re-analyse only regions whose geometry changed)
+    //////////////////////////////////////////////////////////////////////////
+    /** Mark the old and new bounds of actors that overlapped the volume at the last full run as dirty when they move or are deleted: from editor notifications, and by polling movable actors from Tick in game worlds */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Incremental")
+    bool bAutoMarkDirtyOnActorMoved = false;
+
+    /** Start ReanalyzeDirtyRegions automatically from Tick whenever regions are dirty and no run is in progress */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Incremental")
+    bool bAutoReanalyzeDirtyRegions = false;
+
+    //////////////////////////////////////////////////////////////////////////
+    // SCHEDULER (one world-wide queue instead of per-actor ticking)
+    //////////////////////////////////////////////////////////////////////////
+    /** Hand runs to the world's UCPP_SS__VolumeAnalysisScheduler: shared frame budget, capped worker slots, identical runs traced once */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Scheduler")
+    bool bUseSharedScheduler = false;
+
+    /** Share of the scheduler's frame budget relative to other game-thread runs; parallel runs launch highest first */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Scheduler", meta = (ClampMin = "1", UIMin = "1", UIMax = "10", EditCondition = "bUseSharedScheduler"))
+    int32 SchedulerPriority = 1;
+
+    //////////////////////////////////////////////////////////////////////////
+    // CACHE (reuse results of an identical run from a previous session)
+    //////////////////////////////////////////////////////////////////////////
+    /** StartAnalysis first looks in <ProjectSaved>/VolumeAnalysis/Cache for a result keyed by the volume, sample counts, settings and overlapping colliding geometry; full runs store theirs */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Cache")
+    bool bUseResultCache = false;
+
+    /** Store cache entries compressed */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Cache", meta = (EditCondition = "bUseResultCache"))
+    bool bCompressResultCache = true;
+
+    //////////////////////////////////////////////////////////////////////////
+    // BAKE (results precomputed in the editor or by CPP_CMD__VolumeAnalysisBake)
+    //////////////////////////////////////////////////////////////////////////
+    /** Results baked for this actor; loaded at BeginPlay instead of tracing */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Bake")
+    TObjectPtr<UCPP_DA__VolumeAnalysisBakedResults> BakedResults;
+
+    /** Load BakedResults at BeginPlay (no StartAnalysis needed) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Bake")
+    bool bLoadBakedResultsOnBeginPlay = true;
+
+    //////////////////////////////////////////////////////////////////////////
+    // SHARD (analyse one piece of the grid; pieces from several machines are merged afterwards)
+    //////////////////////////////////////////////////////////////////////////
+    /** StartAnalysis only covers voxels [ShardMin, ShardMax) of the grid (plus any halo the settings need); the result grid is that piece */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Shard")
+    bool bAnalyzeShardOnly = false;
+
+    /** First voxel of the shard, in full-grid indices */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Shard", meta = (EditCondition = "bAnalyzeShardOnly"))
+    FIntVector ShardMin = FIntVector::ZeroValue;
+
+    /** One past the last voxel of the shard, in full-grid indices */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Shard", meta = (EditCondition = "bAnalyzeShardOnly"))
+    FIntVector ShardMax = FIntVector::ZeroValue;
+
+    //////////////////////////////////////////////////////////////////////////
+    // TILED (volumes too large to hold in memory)
+    //////////////////////////////////////////////////////////////////////////
+    /** StartAnalysis runs the grid tile by tile and writes each finished tile to TileDirectory; only one tile is resident while running. Point queries page tiles in on demand. Ignores the result cache and shard settings. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Tiled")
+    bool bTiledAnalysis = false;
+
+    /** Voxels per tile edge (keep it a multiple of the adaptive root cell size so tiles need no halo) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Tiled", meta = (ClampMin = "4", ClampMax = "256", UIMin = "8", UIMax = "128", EditCondition = "bTiledAnalysis"))
+    int32 TileSize = 32;
+
+    /** Tiles kept in memory for queries; least recently used tiles are dropped beyond this */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Tiled", meta = (ClampMin = "1", UIMin = "1", EditCondition = "bTiledAnalysis"))
+    int32 MaxResidentTiles = 64;
+
+    /** Empty = <ProjectSaved>/VolumeAnalysis/Tiles/<ActorName> */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Tiled", meta = (EditCondition = "bTiledAnalysis"))
+    FString TileDirectory;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Tiled", meta = (EditCondition = "bTiledAnalysis"))
+    bool bCompressTiles = true;
+
+    //////////////////////////////////////////////////////////////////////////
+    // QUERY
+    //////////////////////////////////////////////////////////////////////////
+    /** Build a summed-volume table with each result set so region counts/percentages are O(1) (4 bytes per voxel) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Query")
+    bool bBuildSummedVolumeTable = false;
+
     //////////////////////////////////////////////////////////////////////////
     // EVENTS
     //////////////////////////////////////////////////////////////////////////
 
-    /** Event fired when Volume analysis completes */
+    /** Event fired when Volume analysis completes (the linked-box array is built only while this is bound) */
     UPROPERTY(BlueprintAssignable, Category = "Punal|VolumeAnalysis|Events")
     FOnVolumeAnalysisComplete OnAnalysisComplete;
 
+    /** Event fired whenever new results are in place, without converting them to linked boxes */
+    UPROPERTY(BlueprintAssignable, Category = "Punal|VolumeAnalysis|Events")
+    FOnVolumeAnalysisResultsUpdated OnAnalysisResultsUpdated;
+
+    /** C++ listeners: receives the result snapshot itself; hold on to it for as long as needed */
+    FOnVolumeAnalysisResultsReady OnResultsReady;
+
     //////////////////////////////////////////////////////////////////////////
     // PUBLIC FUNCTIONS
     //////////////////////////////////////////////////////////////////////////
@@ -149,6 +345,10 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis")
     void StartAnalysis();
 
+    /** Snapshot of this actor's trace and sub-sampling settings as used for a run */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis")
+    FS_VolumeAnalysisSettings GetAnalysisSettings() const;
+
     /** Stop current analysis if running */
     UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis")
     void StopAnalysis();
@@ -161,6 +361,60 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis")
     TArray<FS_LinkedBox> GetAnalysisResults();
 
+    /** Get the current analysis results as the compact voxel grid (cheap compared to GetAnalysisResults) */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis")
+    FS_VoxelGrid GetAnalysisResultGrid() const;
+
+    /** Get the current results as connected regions of visible voxels and merged boxes (far fewer entries than GetAnalysisResults); false without grid results */
+    UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis")
+    bool GetAnalysisRegions(bool bIncludeHidden, FS_VolumeAnalysisRegions &OutRegions) const;
+
+    /** C++ access to the result grid without copying (valid until the results are next replaced) */
+    const FS_VoxelGrid &GetResultGrid() const { return *ResultSnapshot; }
+
+    /** Shared immutable snapshot of the results; unaffected by later runs, so it can be kept or passed across threads */
+    FVolumeAnalysisResultRef GetResultSnapshot() const { return ResultSnapshot; }
+
+    /** Voxel of the current results containing WorldLocation (-1 outside the volume). Tiled results: the full-grid index, -1 where it exceeds int32 */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Query")
+    int32 GetVoxelIndexAt(const FVector &WorldLocation) const;
+
+    /** Whether WorldLocation lies in a visible voxel of the current results (false outside the volume) */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Query")
+    bool IsPointVisible(const FVector &WorldLocation) const;
+
+    /** Origin mask of the voxel containing WorldLocation: bit N set when origin N sees it (0 outside the volume) */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Query")
+    int32 GetOriginMaskAt(const FVector &WorldLocation) const;
+
+    /** Whether origin OriginIndex (0-7) of the last FromOrigins run sees the voxel containing WorldLocation */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Query")
+    bool IsPointVisibleFromOrigin(const FVector &WorldLocation, int32 OriginIndex) const;
+
+    /** Number of visible result voxels overlapping a world-space box (tiled results page in only the partly covered tiles) */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Query")
+    int32 GetVisibleVoxelCountInBox(const FBox &WorldBox) const;
+
+    /** Visible result voxels in the inclusive voxel index range [MinIndex, MaxIndex] (O(1) with bBuildSummedVolumeTable) */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Query")
+    int32 GetVisibleVoxelCountInRange(const FIntVector &MinIndex, const FIntVector &MaxIndex) const;
+
+    /** Visibility percentage (0-100) of the inclusive voxel index range [MinIndex, MaxIndex] clamped to the grid */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Query")
+    float GetVisibilityPercentageInRange(const FIntVector &MinIndex, const FIntVector &MaxIndex) const;
+
+    /** Visibility percentage (0-100) of the result voxels overlapping a world-space box */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Query")
+    float GetVisibilityPercentageInBox(const FBox &WorldBox) const;
+
+    /** March the result grid along Start->End and report the first voxel whose visibility equals bFindVisible (index as GetVoxelIndexAt) */
+    UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|Query")
+    bool RaymarchResults(const FVector &Start, const FVector &End, bool bFindVisible, FVector &OutHitLocation, int32 &OutVoxelIndex) const;
+
+    /** Timing and scene query counts of the last completed run */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Stats")
+    FS_VolumeAnalysisRunSummary GetLastRunSummary() const { return LastRunSummary; }
+
     /** Get number of visible points in current analysis */
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis")
     int32 GetVisiblePointCount() const;
@@ -173,14 +427,107 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis")
     float GetVisibilityPercentage() const;
 
+    /** True while a run (full or incremental) is in progress */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis")
+    bool IsAnalysisRunning() const { return bIsRunning; }
+
+    /** Progress of the current analysis (0-1); 1 once results are available, 0 when idle without results */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis")
+    float GetAnalysisProgress() const;
+
+    /** Estimated seconds until the current analysis completes, extrapolated from elapsed time and progress (-1 if unknown, 0 when idle) */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis")
+    float GetEstimatedTimeRemaining() const;
+
+    // Scheduler: process one budgeted slice of a scheduled game-thread run
+    void StepScheduledRun(double BudgetSeconds);
+
+    // Scheduler: start a scheduled parallel run once it has been given a worker slot
+    void LaunchScheduledParallelRun();
+
+    // Scheduler: take the result of an identical run performed by another actor
+    void AdoptSharedResult(const FVolumeAnalysisResultRef &InResult, const FS_VolumeAnalysisRunSummary &InSummary);
+
     // Load externally computed results into this actor (copy). Recomputes counts and optionally refreshes debug draw.
+    // The boxes must tile a box-shaped volume one per cell (graded spacing is rebuilt from their bounds); otherwise nothing is loaded.
     UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|IO")
     void LoadAnalysisResults(const TArray<FS_LinkedBox> &InBoxes, bool bRefreshDebug = true, bool bBroadcastComplete = true);
 
-    // Load results from a JSON file previously saved with SaveLinkedBoxesToJsonFile.
+    // Adopt a grid without copying it
+    void LoadAnalysisResults(FS_VoxelGrid &&InGrid, bool bRefreshDebug = true, bool bBroadcastComplete = true);
+
+    // Share an existing snapshot (e.g. from an async handle or another actor) without copying it
+    void LoadAnalysisResults(const FVolumeAnalysisResultRef &InResult, bool bRefreshDebug = true, bool bBroadcastComplete = true);
+
+    // Load results from a JSON file previously saved with SaveLinkedBoxesToJsonFile (same box rules as LoadAnalysisResults).
     UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|IO")
     bool LoadAnalysisResultsFromJsonFile(const FString &FilePath, bool bRefreshDebug = true, bool bBroadcastComplete = true);
 
+    // Load results from a binary file (.pvag) saved with SaveAnalysisResultsToBinaryFile / SaveVoxelGridToBinaryFile.
+    UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|IO")
+    bool LoadAnalysisResultsFromBinaryFile(const FString &FilePath, bool bRefreshDebug = true, bool bBroadcastComplete = true);
+
+    // Save the current results in the binary format (packed visibility bits, optionally compressed)
+    UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|IO")
+    bool SaveAnalysisResultsToBinaryFile(const FString &FilePath, bool bCompress = false) const;
+
+    // Replace the current results with BakedResults. Returns false if there is no bake; a bake whose layout no
+    // longer matches VolumeBox and the sample counts is still loaded, with a warning.
+    UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|Bake")
+    bool LoadBakedResults(bool bRefreshDebug = true, bool bBroadcastComplete = true);
+
+    // Run a full analysis and block until it completes, bypassing the shared scheduler (baking, tools).
+    // Returns false if the run could not start.
+    bool RunAnalysisToCompletion();
+
+#if WITH_EDITOR
+    // Run a full analysis now and store it in BakedResults (which must be set); the asset is marked dirty for saving
+    UFUNCTION(CallInEditor, Category = "Punal|VolumeAnalysis|Bake")
+    void BakeResults();
+#endif
+
+    // Split this actor's grid into up to ShardsPerAxis pieces per axis for distributed runs
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Shard")
+    TArray<FS_VolumeAnalysisShard> PlanShards(const FIntVector &ShardsPerAxis) const;
+
+    // Merge shard results saved with SaveAnalysisResultsToBinaryFile into this actor's full grid and load it.
+    // Fails if a file is unreadable or not on this actor's grid; voxels no shard covered stay hidden (with a warning).
+    UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|Shard")
+    bool LoadMergedShardResults(const TArray<FString> &FilePaths, bool bRefreshDebug = true, bool bBroadcastComplete = true);
+
+    // Use the tiled result in Directory (empty = the default TileDirectory) for queries, paging tiles in on demand
+    UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|Tiled")
+    bool LoadTiledResults(const FString &Directory);
+
+    // True while queries are answered from a tiled result (no grid result is loaded)
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Tiled")
+    bool HasTiledResults() const;
+
+    // Cells per axis of the whole grid: the SampleCounts, or derived from the volume's size with ByCellSize
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Sampling")
+    FIntVector GetGridCounts() const;
+
+    // Cache key StartAnalysis would use right now (empty if the volume is invalid)
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Cache")
+    FString GetResultCacheKey() const;
+
+    // Queue a world-space region whose geometry changed; it is rescanned by ReanalyzeDirtyRegions
+    UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|Incremental")
+    void MarkRegionDirty(const FBox &WorldBounds);
+
+    // Queue an actor's current bounds (and its last known bounds, if tracked) as dirty
+    UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|Incremental")
+    void MarkActorDirty(AActor *Actor);
+
+    // Update the current results in place by rescanning only the rows/columns and voxels the dirty regions touch.
+    // Returns false if a run is in progress, nothing is dirty or there is no previous result.
+    // FromOrigins results are re-traced in full instead (only the overlap tests inside the regions are redone).
+    UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|Incremental")
+    bool ReanalyzeDirtyRegions();
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Incremental")
+    int32 GetDirtyRegionCount() const { return DirtyRegions.Num(); }
+
     // Convenience: load a single box as the entire result set
     UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|IO")
     void LoadSingleAnalysisResult(const FS_LinkedBox &InBox, bool bRefreshDebug = true, bool bBroadcastComplete = true);
@@ -190,49 +537,145 @@ protected:
     // COMPONENTS
     //////////////////////////////////////////////////////////////////////////
 
+    /** Result point mesh (replaces per-voxel debug points) */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Components")
+    TObjectPtr<UCPP_AC__VolumeAnalysisVisualizer> ResultVisualizer;
+
+    /** Receives a run's ray and sub-box debug lines as one batch per tick */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Components")
+    TObjectPtr<ULineBatchComponent> DebugLineBatcher;
+
 private:
     //////////////////////////////////////////////////////////////////////////
     // INTERNAL DATA
     //////////////////////////////////////////////////////////////////////////
-    // Store analysis results (voxel boxes)
-    TArray<FS_LinkedBox> AnalysisResults;
+    // Store analysis results (dense voxel grid; linked boxes are built on demand). Replaced, never mutated.
+    FVolumeAnalysisResultRef ResultSnapshot = MakeShared<FS_VoxelGrid, ESPMode::ThreadSafe>();
     int32 VisibleCount = 0;
     int32 HiddenCount = 0;
 
-    // Generated voxel boxes to analyze this run (flattened Z-Y-X order)
-    TArray<FS_LinkedBox> PendingBoxes;
-    int32 CurrentCellIndex = 0;
+    // Engine for the current run (owns the pending grid and scan state)
+    TSharedPtr<FVolumeAnalysisEngine, ESPMode::ThreadSafe> Engine;
     bool bIsRunning = false;
 
-    // Cached grid extents for neighbor lookup
-    int32 GridCountX = 0;
-    int32 GridCountY = 0;
-    int32 GridCountZ = 0;
+    // Worker task when the current run uses EE_VolumeAnalysisExecution::ParallelWorkers
+    UE::Tasks::FTask ParallelTask;
+    bool bRunningParallel = false;
+
+    // The current run was submitted to the world's scheduler (it steps/launches it, or it waits on a shared run)
+    bool bScheduled = false;
+
+    // Debug lines produced by the engine during a step, submitted to DebugLineBatcher afterwards
+    TArray<FBatchedLine> PendingDebugLines;
+
+    // Cache key of the running full run after a cache miss; its result is stored under it
+    FString PendingCacheKey;
+
+    // Tiled runs: the store being written (then read), and the tile the engine is working on (INDEX_NONE otherwise)
+    TSharedPtr<FVolumeAnalysisTileStore> TileStore;
+    int32 CurrentTile = INDEX_NONE;
+
+    // Stats of the run that produced the current results (left as-is when results are loaded)
+    FS_VolumeAnalysisRunSummary LastRunSummary;
+
+    // Prefix sums of ResultSnapshot (only when bBuildSummedVolumeTable)
+    FVolumeAnalysisSummedVolume SummedVolume;
+
+    // Clears the point mesh once DebugDrawDuration has elapsed
+    FTimerHandle ResultPointsTimer;
+
+    // FPlatformTime::Seconds() when the current run started (for the ETA)
+    double RunStartSeconds = 0.0;
+
+    // World-space regions queued by MarkRegionDirty since the last (re-)analysis
+    TArray<FBox> DirtyRegions;
+
+    // Regions handed to the running incremental update (restored if it is cancelled)
+    TArray<FBox> InFlightDirtyRegions;
+
+    // Center overlap cache of the current grid result (one byte per voxel, not part of the published snapshot); only
+    // kept when bAutoMarkDirtyOnActorMoved or bAutoReanalyzeDirtyRegions expects incremental runs
+    TArray<uint8> ResultOverlapCache;
+
+    // Last known bounds of actors overlapping the volume, so moves can dirty the space they leave
+    TMap<TWeakObjectPtr<AActor>, FBox> TrackedActorBounds;
+
+#if WITH_EDITOR
+    FDelegateHandle ActorMovedHandle;
+    FDelegateHandle ActorDeletedHandle;
+    void HandleEditorActorMoved(AActor *Actor);
+    void HandleEditorActorRemoved(AActor *Actor);
+#endif
 
-    // Cached approximate cell sizes (computed at StartAnalysis for auto radius)
-    float CellSizeX = 0.f;
-    float CellSizeY = 0.f;
-    float CellSizeZ = 0.f;
+    // Game worlds: dirty tracked movable actors whose bounds changed (or that were destroyed) since last seen
+    void PollTrackedActors();
 
-    // Sub-sampling phase state
-    bool bIsSubSampling = false;
-    TArray<int32> HiddenBoxIndices;
-    int32 CurrentHiddenIndex = 0;
+    // Internal: build the engine from the current settings (query params, debug draw)
+    void CreateEngine();
 
-    // Main-pass multi-axis scan state
-    // Phase 0 = X-rows (GridCountY * GridCountZ)
-    // Phase 1 = Y-rows (GridCountX * GridCountZ)
-    // Phase 2 = Z-columns (GridCountX * GridCountY)
-    int32 CurrentPhase = 0;
-    int32 CurrentPhaseRowIndex = 0;
+    // Volume and counts StartAnalysis runs over: the whole VolumeBox grid, or the shard's piece of it
+    bool GetRunLayout(FBox &OutVolume, FIntVector &OutCounts) const;
 
-    // Internal: process a portion of rows each tick to avoid hitching
-    void ProcessRowsStep(int32 MaxRowsPerTick);
-    void ProcessRowsStep_SubSampling(int32 MaxCellsPerTick, const FCollisionQueryParams &QueryParams);
+    // Any CellGrowth above 1: cells are not evenly spaced
+    bool IsGradedGrid() const;
+
+    // Tiled runs: start the store and the first tile, run the current tile, store a finished tile and move on
+    void StartTiledAnalysis(const FBox &AABB);
+    bool StartTile();
+    void FinishTile();
+    FString GetTileDirectory() const;
+
+    // Internal: start stepping the initialized engine from Tick or on worker threads, or submit it to the scheduler
+    void LaunchEngine();
+
+    // Internal: run the engine on the worker pool
+    void LaunchParallelTask();
+
+    // Internal: one game-thread step of the engine within BudgetSeconds (0 = RowsPerTick rows)
+    void StepGameThread(double BudgetSeconds);
+
+    // Internal: the world's scheduler subsystem (null in worlds it does not support)
+    UCPP_SS__VolumeAnalysisScheduler *GetScheduler() const;
+
+    // Internal: record bounds of actors overlapping the result volume (when auto-tracking is enabled)
+    void SnapshotTrackedActorBounds();
+
+    // Internal: adopt the engine's grid as the result set, then draw/log/broadcast
+    void FinishAnalysis();
+
+    // Internal: publish a new result snapshot
+    void SetResultGrid(FS_VoxelGrid &&InGrid);
+
+    // Internal: recompute visible/hidden counts and the summed-volume table for the current results
+    void UpdateResultStats();
+
+    // Internal: visible voxels in a clamped range, from the summed-volume table or the tile store when available
+    int64 CountVisibleInRange(const FVoxelRange &Range) const;
+
+    // Internal: voxel range of the current (grid or tiled) results clamped to the grid
+    FVoxelRange ClampToResultGrid(const FIntVector &MinIndex, const FIntVector &MaxIndexExclusive) const;
+
+    // Internal: voxels of the current (grid or tiled) results overlapping a world-space box
+    FVoxelRange GetResultVoxelRange(const FBox &WorldBox) const;
+
+    // Internal: GetVoxelIndexAt's index for a full-grid voxel of the tiled results
+    int32 GetTiledVoxelIndex(const FIntVector &Voxel) const;
+
+    // Internal: recount, draw and broadcast after the results were replaced from outside a run
+    void OnResultsLoaded(const TCHAR *Context, bool bRefreshDebug, bool bBroadcastComplete);
 
     // Internal: draw an AABB
     void DrawAABB(const FBox &Box, const FColor &Color) const;
 
+    // Internal: rebuild the result point mesh from the current results
+    void DrawResultPoints();
+
+    // Internal: hand the lines collected during an engine step to the line batcher
+    void FlushDebugLines();
+
+    // Internal: broadcast OnAnalysisComplete (linked boxes are only built when someone is listening)
+    void BroadcastAnalysisComplete();
+
     //////////////////////////////////////////////////////////////////////////
     // INTERNAL FUNCTIONS
     //////////////////////////////////////////////////////////////////////////
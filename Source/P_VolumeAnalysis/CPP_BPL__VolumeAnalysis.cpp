@@ -5,13 +5,18 @@
  */
 
 #include "CPP_BPL__VolumeAnalysis.h"
+#include "CPP_OBJ__VolumeAnalysisHandle.h"
+#include "CPP_IO__VolumeAnalysisBinary.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "DrawDebugHelpers.h"
-#include "Dom/JsonObject.h"
-#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
 #include "Policies/PrettyJsonPrintPolicy.h"
 #include "Policies/CondensedJsonPrintPolicy.h"
 #include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
 #include "Misc/Paths.h"
 
 FVector UCPP_BPL__VolumeAnalysis::GetClosestPointOnLineSegment(
@@ -64,47 +69,141 @@ void UCPP_BPL__VolumeAnalysis::GenerateVoxelGridBoxes_ByCounts(
 	{
 		return;
 	}
+	TArray<double> EdgesX, EdgesY, EdgesZ;
+	MakeGradedAxisEdges(Box.Min.X, Box.Max.X, CountX, 1.0, EdgesX);
+	MakeGradedAxisEdges(Box.Min.Y, Box.Max.Y, CountY, 1.0, EdgesY);
+	MakeGradedAxisEdges(Box.Min.Z, Box.Max.Z, CountZ, 1.0, EdgesZ);
+	GenerateVoxelGridBoxes_ByEdges(EdgesX, EdgesY, EdgesZ, OutBoxes);
+}
 
-	const FVector Min = Box.Min;
-	const FVector Max = Box.Max;
+void UCPP_BPL__VolumeAnalysis::GenerateVoxelGridBoxes_ByCellSize(
+	const FBox &Box,
+	const FVector &CellSize,
+	int64 MaxVoxels,
+	TArray<FS_LinkedBox> &OutBoxes)
+{
+	const FIntVector Counts = ComputeCountsForCellSize(Box, CellSize, MaxVoxels, FVector::OneVector);
+	GenerateVoxelGridBoxes_ByCounts(Box, Counts.X, Counts.Y, Counts.Z, OutBoxes);
+}
 
-	const float StepX = (CountX > 1) ? (Max.X - Min.X) / float(CountX) : (Max.X - Min.X);
-	const float StepY = (CountY > 1) ? (Max.Y - Min.Y) / float(CountY) : (Max.Y - Min.Y);
-	const float StepZ = (CountZ > 1) ? (Max.Z - Min.Z) / float(CountZ) : (Max.Z - Min.Z);
+void UCPP_BPL__VolumeAnalysis::GenerateVoxelGridBoxes_ByEdges(
+	const TArray<double> &EdgesX,
+	const TArray<double> &EdgesY,
+	const TArray<double> &EdgesZ,
+	TArray<FS_LinkedBox> &OutBoxes)
+{
+	OutBoxes.Reset();
+	const int32 CountX = EdgesX.Num() - 1;
+	const int32 CountY = EdgesY.Num() - 1;
+	const int32 CountZ = EdgesZ.Num() - 1;
+	if (CountX <= 0 || CountY <= 0 || CountZ <= 0)
+	{
+		return;
+	}
+
+	// Build the (CountX+1) x (CountY+1) x (CountZ+1) corner lattice once; every box references the lattice
+	// points it touches, so neighbours share corners (as LinkTwoBoxPoint would) and moving one lattice point
+	// moves every box that uses it
+	const int32 LX = CountX + 1;
+	const int32 LY = CountY + 1;
+	const int32 LZ = CountZ + 1;
+	TArray<FS_LinkedSharedPoint> Lattice;
+	Lattice.SetNum(LX * LY * LZ);
+	for (int32 zi = 0; zi < LZ; ++zi)
+	{
+		for (int32 yi = 0; yi < LY; ++yi)
+		{
+			for (int32 xi = 0; xi < LX; ++xi)
+			{
+				Lattice[(zi * LY + yi) * LX + xi].SetPoint(FVector(EdgesX[xi], EdgesY[yi], EdgesZ[zi]));
+			}
+		}
+	}
+	const auto Corner = [&Lattice, LX, LY](int32 xi, int32 yi, int32 zi) -> const FS_LinkedSharedPoint &
+	{
+		return Lattice[(zi * LY + yi) * LX + xi];
+	};
 
-	// Create CountX*CountY*CountZ boxes filling the AABB
+	// Create CountX*CountY*CountZ boxes filling the AABB, X fastest (matches FS_VoxelGrid::Index)
 	OutBoxes.Reserve(CountX * CountY * CountZ);
 	for (int32 zi = 0; zi < CountZ; ++zi)
 	{
-		const float Z0 = Min.Z + zi * StepZ;
-		const float Z1 = Z0 + StepZ;
 		for (int32 yi = 0; yi < CountY; ++yi)
 		{
-			const float Y0 = Min.Y + yi * StepY;
-			const float Y1 = Y0 + StepY;
 			for (int32 xi = 0; xi < CountX; ++xi)
 			{
-				const float X0 = Min.X + xi * StepX;
-				const float X1 = X0 + StepX;
-
-				FS_LinkedBox Voxel;
+				FS_LinkedBox &Voxel = OutBoxes.AddDefaulted_GetRef();
 				Voxel.VisibilityMask = 0;
+				Voxel.Points.Reserve(8);
+
+				// Left/Right = X, Backward/Forward = Y, Bottom/Top = Z
+				Voxel.Points.Add(EE_Box_8Point::Bottom_Backward_Left, Corner(xi, yi, zi));
+				Voxel.Points.Add(EE_Box_8Point::Bottom_Backward_Right, Corner(xi + 1, yi, zi));
+				Voxel.Points.Add(EE_Box_8Point::Bottom_Forward_Left, Corner(xi, yi + 1, zi));
+				Voxel.Points.Add(EE_Box_8Point::Bottom_Forward_Right, Corner(xi + 1, yi + 1, zi));
+
+				Voxel.Points.Add(EE_Box_8Point::Top_Backward_Left, Corner(xi, yi, zi + 1));
+				Voxel.Points.Add(EE_Box_8Point::Top_Backward_Right, Corner(xi + 1, yi, zi + 1));
+				Voxel.Points.Add(EE_Box_8Point::Top_Forward_Left, Corner(xi, yi + 1, zi + 1));
+				Voxel.Points.Add(EE_Box_8Point::Top_Forward_Right, Corner(xi + 1, yi + 1, zi + 1));
+			}
+		}
+	}
+}
 
-				// Define 8 corners
-				Voxel.SetBoxPoint(EE_Box_8Point::Bottom_Backward_Left, FVector(X0, Y0, Z0));
-				Voxel.SetBoxPoint(EE_Box_8Point::Bottom_Backward_Right, FVector(X1, Y0, Z0));
-				Voxel.SetBoxPoint(EE_Box_8Point::Bottom_Forward_Left, FVector(X0, Y1, Z0));
-				Voxel.SetBoxPoint(EE_Box_8Point::Bottom_Forward_Right, FVector(X1, Y1, Z0));
+FIntVector UCPP_BPL__VolumeAnalysis::ComputeCountsForCellSize(const FBox &Box, const FVector &CellSize, int64 MaxVoxels, const FVector &CellGrowth)
+{
+	if (!Box.IsValid)
+	{
+		return FIntVector::ZeroValue;
+	}
+	const FVector Size = Box.GetSize();
+	FIntVector Counts;
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		const double Cell = FMath::Max(static_cast<double>(CellSize[Axis]), UE_KINDA_SMALL_NUMBER);
+		const double Growth = static_cast<double>(CellGrowth[Axis]);
+		// Cells CellSize * Growth^i add up to the axis size after log(1 + Size * (Growth - 1) / CellSize) / log(Growth) of them
+		const double Exact = Growth <= 1.0 + 1e-6 ? Size[Axis] / Cell : FMath::Loge(1.0 + Size[Axis] * (Growth - 1.0) / Cell) / FMath::Loge(Growth);
+		Counts[Axis] = static_cast<int32>(FMath::Clamp<double>(FMath::RoundToDouble(Exact), 1.0, MAX_int32));
+	}
 
-				Voxel.SetBoxPoint(EE_Box_8Point::Top_Backward_Left, FVector(X0, Y0, Z1));
-				Voxel.SetBoxPoint(EE_Box_8Point::Top_Backward_Right, FVector(X1, Y0, Z1));
-				Voxel.SetBoxPoint(EE_Box_8Point::Top_Forward_Left, FVector(X0, Y1, Z1));
-				Voxel.SetBoxPoint(EE_Box_8Point::Top_Forward_Right, FVector(X1, Y1, Z1));
+	// Coarsen every axis by the same factor until the grid fits; axes clamped at one cell push the others further
+	for (int32 Iteration = 0; MaxVoxels > 0 && int64(Counts.X) * Counts.Y * Counts.Z > MaxVoxels && Iteration < 64; ++Iteration)
+	{
+		const double Scale = FMath::Pow(static_cast<double>(MaxVoxels) / (double(Counts.X) * Counts.Y * Counts.Z), 1.0 / 3.0);
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			Counts[Axis] = FMath::Max(1, FMath::FloorToInt32(Counts[Axis] * Scale));
+		}
+	}
+	return Counts;
+}
 
-				OutBoxes.Add(MoveTemp(Voxel));
-			}
+void UCPP_BPL__VolumeAnalysis::MakeGradedAxisEdges(double Min, double Max, int32 Count, double Growth, TArray<double> &OutEdges)
+{
+	OutEdges.Reset();
+	if (Count <= 0)
+	{
+		return;
+	}
+	OutEdges.SetNumUninitialized(Count + 1);
+	const double Size = Max - Min;
+	if (Growth <= 1.0 + 1e-6)
+	{
+		for (int32 I = 0; I <= Count; ++I)
+		{
+			OutEdges[I] = Min + Size * I / Count;
 		}
+		return;
 	}
+	// Edge I sits at Size * (Growth^I - 1) / (Growth^Count - 1); the last edge is exact
+	const double Denominator = FMath::Pow(Growth, static_cast<double>(Count)) - 1.0;
+	for (int32 I = 0; I < Count; ++I)
+	{
+		OutEdges[I] = Min + Size * (FMath::Pow(Growth, static_cast<double>(I)) - 1.0) / Denominator;
+	}
+	OutEdges[Count] = Max;
 }
 
 FVector UCPP_BPL__VolumeAnalysis::LinkedBox_GetCenter(const FS_LinkedBox &InBox)
@@ -165,7 +264,101 @@ FBox UCPP_BPL__VolumeAnalysis::LinkedBox_GetAABB(const FS_LinkedBox &InBox)
 	return MakeBoxFromPoints(Pts);
 }
 
+int32 UCPP_BPL__VolumeAnalysis::VoxelGrid_Num(const FS_VoxelGrid &InGrid)
+{
+	return InGrid.Num();
+}
+
+bool UCPP_BPL__VolumeAnalysis::VoxelGrid_IsVisible(const FS_VoxelGrid &InGrid, int32 Index)
+{
+	return InGrid.IsValid() && Index >= 0 && Index < InGrid.Num() && InGrid.IsVisible(Index);
+}
+
+int32 UCPP_BPL__VolumeAnalysis::VoxelGrid_GetOriginMask(const FS_VoxelGrid &InGrid, int32 Index)
+{
+	return (InGrid.IsValid() && Index >= 0 && Index < InGrid.Num()) ? InGrid.GetOriginMask(Index) : 0;
+}
+
+FVector UCPP_BPL__VolumeAnalysis::VoxelGrid_GetCellCenter(const FS_VoxelGrid &InGrid, int32 X, int32 Y, int32 Z)
+{
+	return InGrid.GetCellCenter(X, Y, Z);
+}
+
+FBox UCPP_BPL__VolumeAnalysis::VoxelGrid_GetCellBox(const FS_VoxelGrid &InGrid, int32 X, int32 Y, int32 Z)
+{
+	return InGrid.GetCellBox(X, Y, Z);
+}
+
+FS_LinkedBox UCPP_BPL__VolumeAnalysis::VoxelGrid_GetLinkedBox(const FS_VoxelGrid &InGrid, int32 Index)
+{
+	FS_LinkedBox Box;
+	if (InGrid.IsValid() && Index >= 0 && Index < InGrid.Num())
+	{
+		InGrid.MakeLinkedBox(Index, Box);
+	}
+	return Box;
+}
+
+void UCPP_BPL__VolumeAnalysis::VoxelGrid_ToLinkedBoxes(const FS_VoxelGrid &InGrid, TArray<FS_LinkedBox> &OutBoxes)
+{
+	InGrid.ToLinkedBoxes(OutBoxes);
+}
+
+int32 UCPP_BPL__VolumeAnalysis::VoxelGrid_GetVoxelIndexAt(const FS_VoxelGrid &InGrid, const FVector &WorldLocation)
+{
+	return InGrid.GetVoxelIndexAt(WorldLocation);
+}
+
+bool UCPP_BPL__VolumeAnalysis::VoxelGrid_IsPointVisible(const FS_VoxelGrid &InGrid, const FVector &WorldLocation)
+{
+	return InGrid.IsPointVisible(WorldLocation);
+}
+
+int32 UCPP_BPL__VolumeAnalysis::VoxelGrid_CountVisibleInBox(const FS_VoxelGrid &InGrid, const FBox &WorldBox)
+{
+	return InGrid.CountVisibleInBox(WorldBox);
+}
+
+bool UCPP_BPL__VolumeAnalysis::VoxelGrid_Raymarch(const FS_VoxelGrid &InGrid, const FVector &Start, const FVector &End, bool bFindVisible, FVector &OutHitLocation, int32 &OutVoxelIndex)
+{
+	OutHitLocation = End;
+	return InGrid.Raymarch(Start, End, bFindVisible, OutHitLocation, OutVoxelIndex);
+}
+
+// --- Regions ---
+bool UCPP_BPL__VolumeAnalysis::VoxelGrid_ExtractRegions(const FS_VoxelGrid &InGrid, bool bIncludeHidden, FS_VolumeAnalysisRegions &OutRegions)
+{
+	return OutRegions.Build(InGrid, bIncludeHidden);
+}
+
+int32 UCPP_BPL__VolumeAnalysis::Regions_FindBoxAt(const FS_VolumeAnalysisRegions &Regions, const FVector &WorldLocation)
+{
+	return Regions.FindBoxAt(WorldLocation);
+}
+
+// --- Async ---
+UCPP_OBJ__VolumeAnalysisHandle *UCPP_BPL__VolumeAnalysis::StartVolumeAnalysisAsync(UObject *WorldContextObject, const FBox &Volume, int32 CountX, int32 CountY, int32 CountZ, const FS_VolumeAnalysisSettings &Settings, const TArray<AActor *> &IgnoredActors, bool bTraceComplex)
+{
+	UWorld *World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(VolumeAnalysisAsync), bTraceComplex);
+	QueryParams.AddIgnoredActors(IgnoredActors);
+
+	UCPP_OBJ__VolumeAnalysisHandle *Handle = NewObject<UCPP_OBJ__VolumeAnalysisHandle>(World);
+	if (!Handle->Start(World, Volume, CountX, CountY, CountZ, Settings, QueryParams))
+	{
+		return nullptr;
+	}
+	return Handle;
+}
+
 // --- JSON Serialization ---
+// Boxes are written token by token through TJsonWriter and read back token by token through TJsonReader,
+// so no FJsonObject DOM (or, for files, no intermediate FString) is ever built.
 static FString EnumToString(EE_Box_8Point Corner)
 {
 	if (const UEnum *Enum = StaticEnum<EE_Box_8Point>())
@@ -175,100 +368,98 @@ static FString EnumToString(EE_Box_8Point Corner)
 	return TEXT("");
 }
 
-static TSharedPtr<FJsonObject> MakeJsonFromVector(const FVector &V)
-{
-	TSharedPtr<FJsonObject> Obj = MakeShared<FJsonObject>();
-	Obj->SetNumberField(TEXT("X"), V.X);
-	Obj->SetNumberField(TEXT("Y"), V.Y);
-	Obj->SetNumberField(TEXT("Z"), V.Z);
-	return Obj;
-}
-
-static TSharedPtr<FJsonObject> MakeJsonFromLinkedBox(const FS_LinkedBox &InBox)
+template <typename CharType, typename PrintPolicy>
+static void WriteLinkedBoxJson(TJsonWriter<CharType, PrintPolicy> &Writer, const FS_LinkedBox &InBox)
 {
-	TSharedPtr<FJsonObject> Root = MakeShared<FJsonObject>();
-	Root->SetNumberField(TEXT("VisibilityMask"), static_cast<double>(InBox.VisibilityMask));
+	Writer.WriteObjectStart();
+	Writer.WriteValue(TEXT("VisibilityMask"), static_cast<double>(InBox.VisibilityMask));
 
 	// Points as object mapping enum-name -> {X,Y,Z}
-	TSharedPtr<FJsonObject> PointsObj = MakeShared<FJsonObject>();
+	Writer.WriteObjectStart(TEXT("Points"));
 	for (const TPair<EE_Box_8Point, FS_LinkedSharedPoint> &Pair : InBox.Points)
 	{
 		if (Pair.Value.IsSharedPointValid())
 		{
-			const FString Key = EnumToString(Pair.Key);
 			const FVector P = Pair.Value.GetPoint();
-			PointsObj->SetObjectField(Key, MakeJsonFromVector(P));
+			Writer.WriteObjectStart(EnumToString(Pair.Key));
+			Writer.WriteValue(TEXT("X"), P.X);
+			Writer.WriteValue(TEXT("Y"), P.Y);
+			Writer.WriteValue(TEXT("Z"), P.Z);
+			Writer.WriteObjectEnd();
 		}
 	}
-	Root->SetObjectField(TEXT("Points"), PointsObj);
-	return Root;
+	Writer.WriteObjectEnd();
+	Writer.WriteObjectEnd();
 }
 
-bool UCPP_BPL__VolumeAnalysis::LinkedBox_ToJsonString(const FS_LinkedBox &InBox, FString &OutJson, bool bPretty)
+template <typename CharType, typename PrintPolicy, typename TargetType, typename BodyFnType>
+static bool WriteJsonWithPolicy(TargetType Target, BodyFnType &&Body)
+{
+	TSharedRef<TJsonWriter<CharType, PrintPolicy>> Writer = TJsonWriterFactory<CharType, PrintPolicy>::Create(Target);
+	Body(*Writer);
+	return Writer->Close();
+}
+
+// Target is an FString* (TCHAR) or an FArchive* (UTF8CHAR); Body receives the writer
+template <typename CharType, typename TargetType, typename BodyFnType>
+static bool WriteJson(TargetType Target, bool bPretty, BodyFnType &&Body)
 {
-	OutJson.Reset();
-	const TSharedPtr<FJsonObject> Root = MakeJsonFromLinkedBox(InBox);
-	if (!Root.IsValid())
-	{
-		return false;
-	}
-	bool bOk = false;
 	if (bPretty)
 	{
-		TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&OutJson);
-		bOk = FJsonSerializer::Serialize(Root.ToSharedRef(), Writer);
-	}
-	else
-	{
-		TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&OutJson);
-		bOk = FJsonSerializer::Serialize(Root.ToSharedRef(), Writer);
+		return WriteJsonWithPolicy<CharType, TPrettyJsonPrintPolicy<CharType>>(Target, Body);
 	}
-	return bOk;
+	return WriteJsonWithPolicy<CharType, TCondensedJsonPrintPolicy<CharType>>(Target, Body);
 }
 
-bool UCPP_BPL__VolumeAnalysis::SaveLinkedBoxToJsonFile(const FS_LinkedBox &InBox, const FString &FilePath, bool bPretty)
+// Stream JSON into a UTF-8 file without building the document in memory first
+template <typename BodyFnType>
+static bool WriteJsonFile(const FString &FilePath, bool bPretty, BodyFnType &&Body)
 {
-	FString Json;
-	if (!LinkedBox_ToJsonString(InBox, Json, bPretty))
+	TUniquePtr<FArchive> File(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!File)
 	{
 		return false;
 	}
-	return FFileHelper::SaveStringToFile(Json, *FilePath);
+	const bool bOk = WriteJson<UTF8CHAR>(File.Get(), bPretty, Body);
+	return File->Close() && bOk;
 }
 
-bool UCPP_BPL__VolumeAnalysis::LinkedBoxes_ToJsonString(const TArray<FS_LinkedBox> &InBoxes, FString &OutJson, bool bPretty)
+template <typename WriterType>
+static void WriteLinkedBoxArrayJson(WriterType &Writer, const TArray<FS_LinkedBox> &InBoxes)
 {
-	OutJson.Reset();
-	TArray<TSharedPtr<FJsonValue>> Items;
-	Items.Reserve(InBoxes.Num());
+	Writer.WriteArrayStart();
 	for (const FS_LinkedBox &Box : InBoxes)
 	{
-		TSharedPtr<FJsonObject> Obj = MakeJsonFromLinkedBox(Box);
-		Items.Add(MakeShared<FJsonValueObject>(Obj));
+		WriteLinkedBoxJson(Writer, Box);
 	}
+	Writer.WriteArrayEnd();
+}
+
+bool UCPP_BPL__VolumeAnalysis::LinkedBox_ToJsonString(const FS_LinkedBox &InBox, FString &OutJson, bool bPretty)
+{
+	OutJson.Reset();
+	return WriteJson<TCHAR>(&OutJson, bPretty, [&InBox](auto &Writer)
+							{ WriteLinkedBoxJson(Writer, InBox); });
+}
+
+bool UCPP_BPL__VolumeAnalysis::SaveLinkedBoxToJsonFile(const FS_LinkedBox &InBox, const FString &FilePath, bool bPretty)
+{
+	return WriteJsonFile(FilePath, bPretty, [&InBox](auto &Writer)
+						 { WriteLinkedBoxJson(Writer, InBox); });
+}
+
+bool UCPP_BPL__VolumeAnalysis::LinkedBoxes_ToJsonString(const TArray<FS_LinkedBox> &InBoxes, FString &OutJson, bool bPretty)
+{
+	OutJson.Reset();
 	// Serialize as a JSON array
-	bool bOk = false;
-	if (bPretty)
-	{
-		TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&OutJson);
-		bOk = FJsonSerializer::Serialize(Items, Writer);
-	}
-	else
-	{
-		TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&OutJson);
-		bOk = FJsonSerializer::Serialize(Items, Writer);
-	}
-	return bOk;
+	return WriteJson<TCHAR>(&OutJson, bPretty, [&InBoxes](auto &Writer)
+							{ WriteLinkedBoxArrayJson(Writer, InBoxes); });
 }
 
 bool UCPP_BPL__VolumeAnalysis::SaveLinkedBoxesToJsonFile(const TArray<FS_LinkedBox> &InBoxes, const FString &FilePath, bool bPretty)
 {
-	FString Json;
-	if (!LinkedBoxes_ToJsonString(InBoxes, Json, bPretty))
-	{
-		return false;
-	}
-	return FFileHelper::SaveStringToFile(Json, *FilePath);
+	return WriteJsonFile(FilePath, bPretty, [&InBoxes](auto &Writer)
+						 { WriteLinkedBoxArrayJson(Writer, InBoxes); });
 }
 
 // --- JSON Deserialization ---
@@ -286,123 +477,291 @@ static bool StringToEnum(const FString &Name, EE_Box_8Point &OutCorner)
 	return false;
 }
 
-static bool JsonToVector(const TSharedPtr<FJsonObject> &Obj, FVector &Out)
+// Skip the rest of an object/array whose start token was just read
+template <typename ReaderType>
+static bool SkipJsonContainer(ReaderType &Reader)
 {
-	if (!Obj.IsValid())
-		return false;
-	double X = 0, Y = 0, Z = 0;
-	if (!Obj->TryGetNumberField(TEXT("X"), X))
-		return false;
-	if (!Obj->TryGetNumberField(TEXT("Y"), Y))
-		return false;
-	if (!Obj->TryGetNumberField(TEXT("Z"), Z))
-		return false;
-	Out = FVector((float)X, (float)Y, (float)Z);
-	return true;
+	int32 Depth = 1;
+	EJsonNotation Notation;
+	while (Reader.ReadNext(Notation))
+	{
+		switch (Notation)
+		{
+		case EJsonNotation::ObjectStart:
+		case EJsonNotation::ArrayStart:
+			++Depth;
+			break;
+		case EJsonNotation::ObjectEnd:
+		case EJsonNotation::ArrayEnd:
+			if (--Depth == 0)
+			{
+				return true;
+			}
+			break;
+		case EJsonNotation::Error:
+			return false;
+		default:
+			break;
+		}
+	}
+	return false;
 }
 
-static bool JsonObjectToLinkedBox(const TSharedPtr<FJsonObject> &Root, FS_LinkedBox &OutBox)
+// Read {X,Y,Z} after its ObjectStart; bOutComplete is false if a component is missing
+template <typename ReaderType>
+static bool ReadJsonVector(ReaderType &Reader, FVector &Out, bool &bOutComplete)
 {
-	if (!Root.IsValid())
-		return false;
-	// Visibility
-	double VM = 0.0;
-	if (Root->TryGetNumberField(TEXT("VisibilityMask"), VM))
+	double XYZ[3] = {0.0, 0.0, 0.0};
+	uint8 Found = 0;
+	EJsonNotation Notation;
+	while (Reader.ReadNext(Notation))
 	{
-		OutBox.VisibilityMask = static_cast<uint8>((int32)VM & 0xFF);
-	}
-	else
-	{
-		OutBox.VisibilityMask = 0;
+		switch (Notation)
+		{
+		case EJsonNotation::ObjectEnd:
+			Out = FVector(XYZ[0], XYZ[1], XYZ[2]);
+			bOutComplete = (Found == 0x7);
+			return true;
+		case EJsonNotation::Number:
+		{
+			const FString &Id = Reader.GetIdentifier();
+			const int32 Axis = (Id == TEXT("X")) ? 0 : (Id == TEXT("Y")) ? 1 : (Id == TEXT("Z")) ? 2 : INDEX_NONE;
+			if (Axis != INDEX_NONE)
+			{
+				XYZ[Axis] = Reader.GetValueAsNumber();
+				Found |= 1 << Axis;
+			}
+			break;
+		}
+		case EJsonNotation::ObjectStart:
+		case EJsonNotation::ArrayStart:
+			if (!SkipJsonContainer(Reader))
+			{
+				return false;
+			}
+			break;
+		case EJsonNotation::Error:
+			return false;
+		default:
+			break;
+		}
 	}
-	// Points
-	TSharedPtr<FJsonObject> PointsObj = Root->GetObjectField(TEXT("Points"));
-	if (PointsObj.IsValid())
+	return false;
+}
+
+// Read the "Points" object after its ObjectStart; unknown corners and incomplete vectors are skipped
+template <typename ReaderType>
+static bool ReadJsonBoxPoints(ReaderType &Reader, FS_LinkedBox &OutBox)
+{
+	EJsonNotation Notation;
+	while (Reader.ReadNext(Notation))
 	{
-		for (const auto &Pair : PointsObj->Values)
+		switch (Notation)
+		{
+		case EJsonNotation::ObjectEnd:
+			return true;
+		case EJsonNotation::ObjectStart:
 		{
 			EE_Box_8Point Corner;
-			if (!StringToEnum(Pair.Key, Corner))
+			if (!StringToEnum(Reader.GetIdentifier(), Corner))
 			{
-				continue; // skip unknown keys
+				if (!SkipJsonContainer(Reader))
+				{
+					return false;
+				}
+				break; // skip unknown keys
 			}
-			TSharedPtr<FJsonObject> VecObj = Pair.Value->AsObject();
 			FVector P;
-			if (JsonToVector(VecObj, P))
+			bool bComplete = false;
+			if (!ReadJsonVector(Reader, P, bComplete))
+			{
+				return false;
+			}
+			if (bComplete)
 			{
 				OutBox.SetBoxPoint(Corner, P);
 			}
+			break;
+		}
+		case EJsonNotation::ArrayStart:
+			if (!SkipJsonContainer(Reader))
+			{
+				return false;
+			}
+			break;
+		case EJsonNotation::Error:
+			return false;
+		default:
+			break;
 		}
 	}
-	return true;
+	return false;
 }
 
-bool UCPP_BPL__VolumeAnalysis::LinkedBox_FromJsonString(const FString &InJson, FS_LinkedBox &OutBox)
+// Read one box after its ObjectStart
+template <typename ReaderType>
+static bool ReadLinkedBoxJson(ReaderType &Reader, FS_LinkedBox &OutBox)
 {
-	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(InJson);
-	TSharedPtr<FJsonObject> Root;
-	if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid())
+	OutBox = FS_LinkedBox();
+	EJsonNotation Notation;
+	while (Reader.ReadNext(Notation))
 	{
-		return false;
+		switch (Notation)
+		{
+		case EJsonNotation::ObjectEnd:
+			return true;
+		case EJsonNotation::Number:
+			if (Reader.GetIdentifier() == TEXT("VisibilityMask"))
+			{
+				OutBox.VisibilityMask = static_cast<uint8>(static_cast<int32>(Reader.GetValueAsNumber()) & 0xFF);
+			}
+			break;
+		case EJsonNotation::ObjectStart:
+			if (Reader.GetIdentifier() == TEXT("Points"))
+			{
+				if (!ReadJsonBoxPoints(Reader, OutBox))
+				{
+					return false;
+				}
+			}
+			else if (!SkipJsonContainer(Reader))
+			{
+				return false;
+			}
+			break;
+		case EJsonNotation::ArrayStart:
+			if (!SkipJsonContainer(Reader))
+			{
+				return false;
+			}
+			break;
+		case EJsonNotation::Error:
+			return false;
+		default:
+			break;
+		}
 	}
-	OutBox = FS_LinkedBox();
-	return JsonObjectToLinkedBox(Root, OutBox);
+	return false;
 }
 
-bool UCPP_BPL__VolumeAnalysis::LoadLinkedBoxFromJsonFile(const FString &FilePath, FS_LinkedBox &OutBox)
+// Read either an array of boxes or a single box object in one pass (non-object array entries are ignored)
+template <typename ReaderType>
+static bool ReadLinkedBoxesJson(ReaderType &Reader, TArray<FS_LinkedBox> &OutBoxes)
 {
-	FString Data;
-	if (!FFileHelper::LoadFileToString(Data, *FilePath))
+	OutBoxes.Reset();
+	EJsonNotation Notation;
+	if (!Reader.ReadNext(Notation))
 	{
 		return false;
 	}
-	return LinkedBox_FromJsonString(Data, OutBox);
-}
-
-bool UCPP_BPL__VolumeAnalysis::LinkedBoxes_FromJsonString(const FString &InJson, TArray<FS_LinkedBox> &OutBoxes)
-{
-	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(InJson);
-	TArray<TSharedPtr<FJsonValue>> Arr;
-	if (!FJsonSerializer::Deserialize(Reader, Arr))
+	if (Notation == EJsonNotation::ObjectStart)
 	{
 		// In case file stored a single object, not an array
-		TSharedPtr<FJsonObject> Obj;
-		TSharedRef<TJsonReader<>> Reader2 = TJsonReaderFactory<>::Create(InJson);
-		if (FJsonSerializer::Deserialize(Reader2, Obj) && Obj.IsValid())
+		return ReadLinkedBoxJson(Reader, OutBoxes.AddDefaulted_GetRef());
+	}
+	if (Notation != EJsonNotation::ArrayStart)
+	{
+		return false;
+	}
+	while (Reader.ReadNext(Notation))
+	{
+		switch (Notation)
 		{
-			FS_LinkedBox Single;
-			if (JsonObjectToLinkedBox(Obj, Single))
+		case EJsonNotation::ArrayEnd:
+			return true;
+		case EJsonNotation::ObjectStart:
+			if (!ReadLinkedBoxJson(Reader, OutBoxes.AddDefaulted_GetRef()))
 			{
-				OutBoxes = {Single};
-				return true;
+				OutBoxes.Reset();
+				return false;
+			}
+			break;
+		case EJsonNotation::ArrayStart:
+			if (!SkipJsonContainer(Reader))
+			{
+				OutBoxes.Reset();
+				return false;
 			}
+			break;
+		case EJsonNotation::Error:
+			OutBoxes.Reset();
+			return false;
+		default:
+			break;
 		}
-		return false;
 	}
 	OutBoxes.Reset();
-	OutBoxes.Reserve(Arr.Num());
-	for (const TSharedPtr<FJsonValue> &V : Arr)
-	{
-		if (!V.IsValid())
-			continue;
-		TSharedPtr<FJsonObject> Obj = V->AsObject();
-		if (!Obj.IsValid())
-			continue;
-		FS_LinkedBox B;
-		if (JsonObjectToLinkedBox(Obj, B))
+	return false;
+}
+
+template <typename ReaderType>
+static bool ReadSingleLinkedBoxJson(ReaderType &Reader, FS_LinkedBox &OutBox)
+{
+	EJsonNotation Notation;
+	return Reader.ReadNext(Notation) && Notation == EJsonNotation::ObjectStart && ReadLinkedBoxJson(Reader, OutBox);
+}
+
+// Stream a JSON file through ParseFn(Reader). UTF-8/ANSI files are read incrementally from the archive;
+// UTF-16 files (BOM) are rare and go through the string loader.
+template <typename ParseFnType>
+static bool ReadJsonFile(const FString &FilePath, ParseFnType &&ParseFn)
+{
+	TUniquePtr<FArchive> File(IFileManager::Get().CreateFileReader(*FilePath));
+	if (!File)
+	{
+		return false;
+	}
+	uint8 Bom[3] = {0, 0, 0};
+	const int64 Size = File->TotalSize();
+	File->Serialize(Bom, FMath::Min<int64>(3, Size));
+	if (Size >= 2 && ((Bom[0] == 0xFF && Bom[1] == 0xFE) || (Bom[0] == 0xFE && Bom[1] == 0xFF)))
+	{
+		File.Reset();
+		FString Data;
+		if (!FFileHelper::LoadFileToString(Data, *FilePath))
 		{
-			OutBoxes.Add(MoveTemp(B));
+			return false;
 		}
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Data);
+		return ParseFn(*Reader);
 	}
-	return true;
+	const bool bUtf8Bom = (Size >= 3 && Bom[0] == 0xEF && Bom[1] == 0xBB && Bom[2] == 0xBF);
+	File->Seek(bUtf8Bom ? 3 : 0);
+	TSharedRef<TJsonReader<UTF8CHAR>> Reader = TJsonReaderFactory<UTF8CHAR>::Create(File.Get());
+	return ParseFn(*Reader);
+}
+
+bool UCPP_BPL__VolumeAnalysis::LinkedBox_FromJsonString(const FString &InJson, FS_LinkedBox &OutBox)
+{
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(InJson);
+	return ReadSingleLinkedBoxJson(*Reader, OutBox);
+}
+
+bool UCPP_BPL__VolumeAnalysis::LoadLinkedBoxFromJsonFile(const FString &FilePath, FS_LinkedBox &OutBox)
+{
+	return ReadJsonFile(FilePath, [&OutBox](auto &Reader)
+						{ return ReadSingleLinkedBoxJson(Reader, OutBox); });
+}
+
+bool UCPP_BPL__VolumeAnalysis::LinkedBoxes_FromJsonString(const FString &InJson, TArray<FS_LinkedBox> &OutBoxes)
+{
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(InJson);
+	return ReadLinkedBoxesJson(*Reader, OutBoxes);
 }
 
 bool UCPP_BPL__VolumeAnalysis::LoadLinkedBoxesFromJsonFile(const FString &FilePath, TArray<FS_LinkedBox> &OutBoxes)
 {
-	FString Data;
-	if (!FFileHelper::LoadFileToString(Data, *FilePath))
-	{
-		return false;
-	}
-	return LinkedBoxes_FromJsonString(Data, OutBoxes);
-}
\ No newline at end of file
+	return ReadJsonFile(FilePath, [&OutBoxes](auto &Reader)
+						{ return ReadLinkedBoxesJson(Reader, OutBoxes); });
+}
+
+// --- Binary Serialization ---
+bool UCPP_BPL__VolumeAnalysis::SaveVoxelGridToBinaryFile(const FS_VoxelGrid &InGrid, const FString &FilePath, bool bCompress)
+{
+	return FVolumeAnalysisBinary::SaveToFile(InGrid, FilePath, bCompress);
+}
+
+bool UCPP_BPL__VolumeAnalysis::LoadVoxelGridFromBinaryFile(const FString &FilePath, FS_VoxelGrid &OutGrid)
+{
+	return FVolumeAnalysisBinary::LoadFromFile(FilePath, OutGrid);
+}
@@ -9,8 +9,13 @@
 #include "CoreMinimal.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "Engine/EngineTypes.h"
+#include "CPP_ST__VolumeAnalysisGrid.h"
+#include "CPP_ST__VolumeAnalysisRegions.h"
+#include "CPP_EN__VolumeAnalysisEngine.h"
 #include "CPP_BPL__VolumeAnalysis.generated.h"
 
+class UCPP_OBJ__VolumeAnalysisHandle;
+
 UENUM(BlueprintType)
 enum class EE_Box_8Point : uint8
 {
@@ -97,9 +102,9 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Math|LinkedBox")
 	TMap<EE_Box_8Point, FS_LinkedSharedPoint> Points;
 
-	// Optional: Visibility mask aligned with Points_1D_Array (1 = Visible, 0 = Hidden)
+	// Optional: Visibility mask aligned with Points_1D_Array (1 = Visible, 0 = Hidden; one bit per origin for origin-based runs)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Math|LinkedBox")
-	uint8 VisibilityMask;
+	uint8 VisibilityMask = 0;
 
 	void SetBoxPoint(EE_Box_8Point Corner, const FVector &NewPoint)
 	{
@@ -143,7 +148,8 @@ public:
 	// Compute axis-aligned bounding box from a set of points
 	static FBox MakeBoxFromPoints(const TArray<FVector> &Points);
 
-	// Generate a voxel grid of boxes within the AABB using counts per axis
+	// Generate a voxel grid of boxes within the AABB using counts per axis (Z-Y-X order).
+	// Corners come from one shared (Count+1)^3 lattice, so adjacent boxes reference the same point.
 	static void GenerateVoxelGridBoxes_ByCounts(
 		const FBox &Box,
 		int32 CountX,
@@ -151,6 +157,28 @@ public:
 		int32 CountZ,
 		TArray<FS_LinkedBox> &OutBoxes);
 
+	// Same lattice and order as ByCounts, with the counts derived from a world-space cell size (see ComputeCountsForCellSize)
+	static void GenerateVoxelGridBoxes_ByCellSize(
+		const FBox &Box,
+		const FVector &CellSize,
+		int64 MaxVoxels,
+		TArray<FS_LinkedBox> &OutBoxes);
+
+	// Same lattice and order as ByCounts over explicit cell boundaries per axis (Count + 1 increasing values each)
+	static void GenerateVoxelGridBoxes_ByEdges(
+		const TArray<double> &EdgesX,
+		const TArray<double> &EdgesY,
+		const TArray<double> &EdgesZ,
+		TArray<FS_LinkedBox> &OutBoxes);
+
+	// Counts per axis for cells of about CellSize world units (cells along an axis with CellGrowth above 1 start at
+	// CellSize and grow by that ratio). Grids over MaxVoxels are coarsened evenly until they fit (0 = no cap).
+	UFUNCTION(BlueprintPure, Category = "Punal|VolumeAnalysis|Grid")
+	static FIntVector ComputeCountsForCellSize(const FBox &Box, const FVector &CellSize, int64 MaxVoxels, const FVector &CellGrowth);
+
+	// Count + 1 boundaries from Min to Max whose cells grow by Growth from one to the next (1 or less = even spacing)
+	static void MakeGradedAxisEdges(double Min, double Max, int32 Count, double Growth, TArray<double> &OutEdges);
+
 	// Utility: Get center of a linked box (averaging available corners; falls back to AABB center of valid points)
 	UFUNCTION(BlueprintPure, Category = "Punal|VolumeAnalysis|LinkedBox")
 	static FVector LinkedBox_GetCenter(const FS_LinkedBox &InBox);
@@ -176,6 +204,56 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|LinkedBox")
 	static void LinkedBox_LinkTwoBoxPoint(UPARAM(ref) FS_LinkedBox &BoxA, UPARAM(ref) FS_LinkedBox &BoxB, EE_Box_8Point BoxA_Corner, EE_Box_8Point BoxB_Corner);
 
+	// Utility: FS_VoxelGrid Blueprint wrappers (linked boxes are built on demand)
+	UFUNCTION(BlueprintPure, Category = "Punal|VolumeAnalysis|VoxelGrid")
+	static int32 VoxelGrid_Num(const FS_VoxelGrid &InGrid);
+
+	UFUNCTION(BlueprintPure, Category = "Punal|VolumeAnalysis|VoxelGrid")
+	static bool VoxelGrid_IsVisible(const FS_VoxelGrid &InGrid, int32 Index);
+
+	// Bit i set = seen from visibility origin i (1/0 for grids without origin masks)
+	UFUNCTION(BlueprintPure, Category = "Punal|VolumeAnalysis|VoxelGrid")
+	static int32 VoxelGrid_GetOriginMask(const FS_VoxelGrid &InGrid, int32 Index);
+
+	UFUNCTION(BlueprintPure, Category = "Punal|VolumeAnalysis|VoxelGrid")
+	static FVector VoxelGrid_GetCellCenter(const FS_VoxelGrid &InGrid, int32 X, int32 Y, int32 Z);
+
+	UFUNCTION(BlueprintPure, Category = "Punal|VolumeAnalysis|VoxelGrid")
+	static FBox VoxelGrid_GetCellBox(const FS_VoxelGrid &InGrid, int32 X, int32 Y, int32 Z);
+
+	UFUNCTION(BlueprintPure, Category = "Punal|VolumeAnalysis|VoxelGrid")
+	static FS_LinkedBox VoxelGrid_GetLinkedBox(const FS_VoxelGrid &InGrid, int32 Index);
+
+	UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|VoxelGrid")
+	static void VoxelGrid_ToLinkedBoxes(const FS_VoxelGrid &InGrid, TArray<FS_LinkedBox> &OutBoxes);
+
+	// Spatial queries (constant time per voxel, no allocation)
+	UFUNCTION(BlueprintPure, Category = "Punal|VolumeAnalysis|VoxelGrid|Query")
+	static int32 VoxelGrid_GetVoxelIndexAt(const FS_VoxelGrid &InGrid, const FVector &WorldLocation);
+
+	UFUNCTION(BlueprintPure, Category = "Punal|VolumeAnalysis|VoxelGrid|Query")
+	static bool VoxelGrid_IsPointVisible(const FS_VoxelGrid &InGrid, const FVector &WorldLocation);
+
+	UFUNCTION(BlueprintPure, Category = "Punal|VolumeAnalysis|VoxelGrid|Query")
+	static int32 VoxelGrid_CountVisibleInBox(const FS_VoxelGrid &InGrid, const FBox &WorldBox);
+
+	// First voxel along Start->End whose visibility equals bFindVisible; false if there is none
+	UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|VoxelGrid|Query")
+	static bool VoxelGrid_Raymarch(const FS_VoxelGrid &InGrid, const FVector &Start, const FVector &End, bool bFindVisible, FVector &OutHitLocation, int32 &OutVoxelIndex);
+
+	// Connected components of visible voxels and greedy-merged boxes of equal state; false if the grid is empty
+	UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|VoxelGrid|Regions")
+	static bool VoxelGrid_ExtractRegions(const FS_VoxelGrid &InGrid, bool bIncludeHidden, FS_VolumeAnalysisRegions &OutRegions);
+
+	// Index into Regions.Boxes of the box containing WorldLocation (-1 if none)
+	UFUNCTION(BlueprintPure, Category = "Punal|VolumeAnalysis|VoxelGrid|Regions")
+	static int32 Regions_FindBoxAt(const FS_VolumeAnalysisRegions &Regions, const FVector &WorldLocation);
+
+	// Async: run an analysis on worker threads without spawning an actor; returns null if the world, volume or counts are invalid.
+	// Keep a reference to the handle (it cancels the run when garbage collected); OnComplete fires on the game thread.
+	UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|Async", meta = (WorldContext = "WorldContextObject", AutoCreateRefTerm = "IgnoredActors"))
+	static UCPP_OBJ__VolumeAnalysisHandle *StartVolumeAnalysisAsync(UObject *WorldContextObject, const FBox &Volume, int32 CountX, int32 CountY, int32 CountZ, const FS_VolumeAnalysisSettings &Settings, const TArray<AActor *> &IgnoredActors, bool bTraceComplex = true);
+
 	// JSON Serialization helpers for FS_LinkedBox
 	UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|LinkedBox|JSON")
 	static bool LinkedBox_ToJsonString(const FS_LinkedBox &InBox, FString &OutJson, bool bPretty = true);
@@ -202,4 +280,11 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|LinkedBox|JSON")
 	static bool LoadLinkedBoxesFromJsonFile(const FString &FilePath, TArray<FS_LinkedBox> &OutBoxes);
+
+	// Binary serialization for FS_VoxelGrid (header + packed visibility bits, much smaller and faster than JSON)
+	UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|VoxelGrid|Binary")
+	static bool SaveVoxelGridToBinaryFile(const FS_VoxelGrid &InGrid, const FString &FilePath, bool bCompress = false);
+
+	UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|VoxelGrid|Binary")
+	static bool LoadVoxelGridFromBinaryFile(const FString &FilePath, FS_VoxelGrid &OutGrid);
 };
@@ -0,0 +1,256 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#include "CPP_CMD__VolumeAnalysisBake.h"
+#include "CPP_AT_VolumeAnalysis__Base.h"
+#include "CPP_DA__VolumeAnalysisBakedResults.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPVolBake, Log, All);
+
+#if WITH_EDITOR
+namespace VolumeAnalysisBake
+{
+	struct FOptions
+	{
+		FString OutputDir;
+		FString ShardDir;
+		// Zero = no sharding
+		FIntVector ShardGrid = FIntVector::ZeroValue;
+		int32 Shard = INDEX_NONE;
+		bool bMergeShards = false;
+	};
+
+	static FString GetShardFilePath(const FOptions &Options, const FString &MapShortName, const AActor &Actor, int32 ShardIndex)
+	{
+		return Options.ShardDir / FString::Printf(TEXT("%s_%s.%d.pvag"), *MapShortName, *Actor.GetName(), ShardIndex);
+	}
+
+	// Shard mode: analyse one piece of the actor's grid and write it where the merging machine expects it
+	static bool RunShard(ACPP_AT_VolumeAnalysis_Base &Actor, const FString &MapShortName, const FOptions &Options)
+	{
+		const TArray<FS_VolumeAnalysisShard> Shards = Actor.PlanShards(Options.ShardGrid);
+		if (!Shards.IsValidIndex(Options.Shard))
+		{
+			// Small grids yield fewer shards than asked for; this machine has nothing to do for the actor
+			UE_LOG(LogPVolBake, Display, TEXT("%s: %s has %d shards; skipping shard %d"), *MapShortName, *Actor.GetName(), Shards.Num(), Options.Shard);
+			return true;
+		}
+		const FS_VolumeAnalysisShard &Shard = Shards[Options.Shard];
+		TGuardValue<bool> ShardOnly(Actor.bAnalyzeShardOnly, true);
+		TGuardValue<FIntVector> Min(Actor.ShardMin, Shard.Min);
+		TGuardValue<FIntVector> Max(Actor.ShardMax, Shard.Max);
+		if (!Actor.RunAnalysisToCompletion())
+		{
+			UE_LOG(LogPVolBake, Error, TEXT("%s: Analysis of %s shard %d did not complete"), *MapShortName, *Actor.GetName(), Options.Shard);
+			return false;
+		}
+		const FString FilePath = GetShardFilePath(Options, MapShortName, Actor, Options.Shard);
+		if (!Actor.SaveAnalysisResultsToBinaryFile(FilePath, /*bCompress*/ true))
+		{
+			UE_LOG(LogPVolBake, Error, TEXT("Could not write '%s'"), *FilePath);
+			return false;
+		}
+		UE_LOG(LogPVolBake, Display, TEXT("%s: %s shard %d/%d -> '%s'; %s"), *MapShortName, *Actor.GetName(), Options.Shard, Shards.Num(), *FilePath, *Actor.GetLastRunSummary().ToString());
+		Actor.ClearResults();
+		return true;
+	}
+
+	static bool SavePackageTo(UPackage *Package, UObject *Asset, const FString &Extension)
+	{
+		const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), Extension);
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		if (!UPackage::SavePackage(Package, Asset, *Filename, SaveArgs))
+		{
+			UE_LOG(LogPVolBake, Error, TEXT("Could not save '%s'"), *Filename);
+			return false;
+		}
+		return true;
+	}
+
+	// The actor's asset, or an existing/new one at the default path (assigned to the actor)
+	static UCPP_DA__VolumeAnalysisBakedResults *FindOrCreateAsset(ACPP_AT_VolumeAnalysis_Base &Actor, const FString &MapShortName, const FString &OutputDir, bool &bOutAssigned)
+	{
+		bOutAssigned = false;
+		if (Actor.BakedResults)
+		{
+			return Actor.BakedResults;
+		}
+		const FString PackageName = OutputDir / FString::Printf(TEXT("%s_%s"), *MapShortName, *Actor.GetName());
+		const FString AssetName = FPackageName::GetShortName(PackageName);
+		UCPP_DA__VolumeAnalysisBakedResults *Asset = nullptr;
+		if (FPackageName::DoesPackageExist(PackageName))
+		{
+			Asset = LoadObject<UCPP_DA__VolumeAnalysisBakedResults>(nullptr, *(PackageName + TEXT(".") + AssetName), nullptr, LOAD_NoWarn | LOAD_Quiet);
+		}
+		if (!Asset)
+		{
+			UPackage *Package = CreatePackage(*PackageName);
+			Asset = NewObject<UCPP_DA__VolumeAnalysisBakedResults>(Package, *AssetName, RF_Public | RF_Standalone);
+		}
+		Actor.BakedResults = Asset;
+		Actor.MarkPackageDirty();
+		bOutAssigned = true;
+		return Asset;
+	}
+
+	static bool BakeMap(const FString &MapName, const FOptions &Options)
+	{
+		UPackage *MapPackage = LoadPackage(nullptr, *MapName, LOAD_None);
+		UWorld *World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+		if (!World)
+		{
+			UE_LOG(LogPVolBake, Error, TEXT("Could not load map '%s'"), *MapName);
+			return false;
+		}
+
+		// Collision must be queryable; nothing else is needed to trace the static level
+		World->AddToRoot();
+		if (!World->bIsWorldInitialized)
+		{
+			World->InitWorld(UWorld::InitializationValues()
+								 .InitializeScenes(false)
+								 .AllowAudioPlayback(false)
+								 .CreatePhysicsScene(true)
+								 .CreateNavigation(false)
+								 .CreateAISystem(false)
+								 .ShouldSimulatePhysics(false)
+								 .EnableTraceCollision(true)
+								 .SetTransactional(false)
+								 .CreateFXSystem(false));
+		}
+		FWorldContext &WorldContext = GEngine->CreateNewWorldContext(EWorldType::Editor);
+		WorldContext.SetCurrentWorld(World);
+		World->UpdateWorldComponents(/*bRerunConstructionScripts*/ true, /*bCurrentLevelOnly*/ false);
+
+		const FString MapShortName = FPackageName::GetShortName(MapPackage);
+		bool bAllBaked = true;
+		bool bMapChanged = false;
+		int32 NumActors = 0;
+		for (TActorIterator<ACPP_AT_VolumeAnalysis_Base> It(World); It; ++It)
+		{
+			ACPP_AT_VolumeAnalysis_Base *Actor = *It;
+			++NumActors;
+
+			TGuardValue<bool> NoDebug(Actor->bDrawDebug, false);
+			if (Options.Shard != INDEX_NONE)
+			{
+				bAllBaked &= RunShard(*Actor, MapShortName, Options);
+				continue;
+			}
+			if (Options.bMergeShards)
+			{
+				TArray<FString> ShardFiles;
+				for (const FS_VolumeAnalysisShard &Shard : Actor->PlanShards(Options.ShardGrid))
+				{
+					ShardFiles.Add(GetShardFilePath(Options, MapShortName, *Actor, Shard.Index));
+				}
+				if (!Actor->LoadMergedShardResults(ShardFiles, /*bRefreshDebug*/ false, /*bBroadcastComplete*/ false))
+				{
+					UE_LOG(LogPVolBake, Error, TEXT("%s: Could not merge the %d shards of %s"), *MapShortName, ShardFiles.Num(), *Actor->GetName());
+					bAllBaked = false;
+					continue;
+				}
+			}
+			else if (!Actor->RunAnalysisToCompletion())
+			{
+				UE_LOG(LogPVolBake, Error, TEXT("%s: Analysis of %s did not complete"), *MapShortName, *Actor->GetName());
+				bAllBaked = false;
+				continue;
+			}
+
+			bool bAssigned = false;
+			UCPP_DA__VolumeAnalysisBakedResults *Asset = FindOrCreateAsset(*Actor, MapShortName, Options.OutputDir, bAssigned);
+			bMapChanged |= bAssigned;
+			Asset->SetFromGrid(Actor->GetResultGrid(), Actor->GetLastRunSummary(), Actor->GetResultCacheKey());
+			bAllBaked &= SavePackageTo(Asset->GetPackage(), Asset, FPackageName::GetAssetPackageExtension());
+			UE_LOG(LogPVolBake, Display, TEXT("%s: %s -> '%s'; %s"), *MapShortName, *Actor->GetName(), *Asset->GetPathName(), *Actor->GetLastRunSummary().ToString());
+			Actor->ClearResults();
+		}
+
+		if (bMapChanged)
+		{
+			// New assets are referenced from the level, so it has to be saved too
+			bAllBaked &= SavePackageTo(MapPackage, World, FPackageName::GetMapPackageExtension());
+		}
+		UE_LOG(LogPVolBake, Display, TEXT("%s: Baked %d volume analysis actor(s)"), *MapShortName, NumActors);
+
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(/*bInformEngineOfWorld*/ false);
+		World->RemoveFromRoot();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		return bAllBaked;
+	}
+}
+#endif
+
+UCPP_CMD__VolumeAnalysisBakeCommandlet::UCPP_CMD__VolumeAnalysisBakeCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UCPP_CMD__VolumeAnalysisBakeCommandlet::Main(const FString &Params)
+{
+#if WITH_EDITOR
+	using namespace VolumeAnalysisBake;
+
+	FString MapsParam;
+	FString ShardGridParam;
+	FOptions Options;
+	Options.OutputDir = TEXT("/Game/VolumeAnalysis/Baked");
+	Options.ShardDir = FPaths::ProjectSavedDir() / TEXT("VolumeAnalysis/Shards");
+	FParse::Value(*Params, TEXT("Map="), MapsParam);
+	FParse::Value(*Params, TEXT("OutputDir="), Options.OutputDir);
+	FParse::Value(*Params, TEXT("ShardDir="), Options.ShardDir);
+	FParse::Value(*Params, TEXT("ShardGrid="), ShardGridParam);
+	FParse::Value(*Params, TEXT("Shard="), Options.Shard);
+	Options.bMergeShards = FParse::Param(*Params, TEXT("MergeShards"));
+
+	TArray<FString> ShardGridStrings;
+	ShardGridParam.ParseIntoArray(ShardGridStrings, TEXT(","));
+	if (ShardGridStrings.Num() == 3)
+	{
+		Options.ShardGrid = FIntVector(FCString::Atoi(*ShardGridStrings[0]), FCString::Atoi(*ShardGridStrings[1]), FCString::Atoi(*ShardGridStrings[2]));
+	}
+	const bool bSharded = Options.ShardGrid.X > 0 && Options.ShardGrid.Y > 0 && Options.ShardGrid.Z > 0;
+	const bool bShardRun = Options.Shard != INDEX_NONE;
+	if (((bShardRun || Options.bMergeShards) && !bSharded) || (bShardRun && Options.bMergeShards) || Options.Shard < INDEX_NONE)
+	{
+		UE_LOG(LogPVolBake, Error, TEXT("Bake: -Shard=<index> and -MergeShards each need -ShardGrid=X,Y,Z and exclude each other"));
+		return 1;
+	}
+
+	TArray<FString> Maps;
+	MapsParam.ParseIntoArray(Maps, TEXT(","));
+	if (!GEngine || Maps.Num() == 0 || !FPackageName::IsValidLongPackageName(Options.OutputDir))
+	{
+		UE_LOG(LogPVolBake, Error, TEXT("Bake: Missing engine, -Map=<package>[,<package>...] or a valid -OutputDir=/Game/..."));
+		return 1;
+	}
+
+	bool bAllBaked = true;
+	for (const FString &Map : Maps)
+	{
+		bAllBaked &= BakeMap(Map, Options);
+	}
+	return bAllBaked ? 0 : 1;
+#else
+	UE_LOG(LogPVolBake, Error, TEXT("Bake: Requires an editor build"));
+	return 1;
+#endif
+}
@@ -0,0 +1,36 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "CPP_CMD__VolumeAnalysisBake.generated.h"
+
+/**
+ * Analyses every ACPP_AT_VolumeAnalysis_Base in the given maps and bakes the results into
+ * UCPP_DA__VolumeAnalysisBakedResults assets, so shipping builds load them at BeginPlay instead of tracing.
+ * Actors without an asset get a new one (<OutputDir>/<Map>_<Actor>) and the map is re-saved with the reference.
+ *
+ * UnrealEditor-Cmd <Project> -run=CPP_CMD__VolumeAnalysisBake -Map=/Game/Maps/A,/Game/Maps/B [options]
+ *   -OutputDir=/Game/VolumeAnalysis/Baked   package path for newly created assets
+ * Distributed runs (every machine runs the same maps with the same -ShardGrid):
+ *   -ShardGrid=4,4,1 -Shard=5               analyse only shard 5 of each actor's grid and write it to
+ *                                           <ShardDir>/<Map>_<Actor>.5.pvag; no assets or maps are touched
+ *   -ShardGrid=4,4,1 -MergeShards           bake the merged shard files instead of analysing
+ *   -ShardDir=<path>                        default <ProjectSaved>/VolumeAnalysis/Shards
+ * Returns non-zero if a map failed to load, an analysis did not complete or a package failed to save.
+ */
+UCLASS()
+class P_VOLUMEANALYSIS_API UCPP_CMD__VolumeAnalysisBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UCPP_CMD__VolumeAnalysisBakeCommandlet();
+
+	virtual int32 Main(const FString &Params) override;
+};
@@ -0,0 +1,350 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#include "CPP_CMD__VolumeAnalysisBenchmark.h"
+#include "CPP_AT_VolumeAnalysis__Base.h"
+#include "CPP_BPL__VolumeAnalysis.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPVolBenchmark, Log, All);
+
+namespace VolumeAnalysisBenchmark
+{
+	// All scenes share one 20 m cube so results are comparable across sizes
+	static const FBox Volume(FVector(-1000.0), FVector(1000.0));
+
+	struct FRunResult
+	{
+		FString Scene;
+		int32 Size = 0;
+		bool bSubSampling = false;
+		bool bOverlapTest = false;
+		bool bCompleted = false;
+		double TotalSeconds = 0.0;
+		FS_VolumeAnalysisRunSummary Summary;
+		int64 ResultBytes = 0;
+		int64 UsedPhysicalDelta = 0;
+		int64 PeakUsedPhysical = 0;
+		int64 BinaryBytes = 0;
+		double BinarySaveSeconds = 0.0;
+		double BinaryLoadSeconds = 0.0;
+		int64 JsonBytes = 0;
+		double JsonSaveSeconds = 0.0;
+		double JsonLoadSeconds = 0.0;
+	};
+
+	static double Throughput(int64 Bytes, double Seconds)
+	{
+		return Seconds > 0.0 ? (Bytes / (1024.0 * 1024.0)) / Seconds : 0.0;
+	}
+
+	// Engine cube is 100 cm and centered, so scale = size / 100
+	static void SpawnBlock(UWorld *World, UStaticMesh *Cube, const FBox &Box)
+	{
+		const FTransform Transform(FQuat::Identity, Box.GetCenter(), Box.GetSize() / 100.0);
+		AStaticMeshActor *Block = World->SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Transform);
+		Block->GetStaticMeshComponent()->SetStaticMesh(Cube);
+		Block->FinishSpawning(Transform);
+	}
+
+	static bool BuildScene(UWorld *World, UStaticMesh *Cube, const FString &Scene, int32 Seed)
+	{
+		FRandomStream Rng(Seed);
+		if (Scene == TEXT("Empty"))
+		{
+			return true;
+		}
+		if (Scene == TEXT("Clutter"))
+		{
+			// Many small overlapping props: lots of short trace segments and mixed voxels
+			for (int32 i = 0; i < 150; ++i)
+			{
+				const FVector Center = Rng.RandPointInBox(Volume);
+				const FVector HalfSize(Rng.FRandRange(20.0, 125.0), Rng.FRandRange(20.0, 125.0), Rng.FRandRange(20.0, 125.0));
+				SpawnBlock(World, Cube, FBox(Center - HalfSize, Center + HalfSize));
+			}
+			return true;
+		}
+		if (Scene == TEXT("Maze"))
+		{
+			// Binary-tree maze of full-height walls on an 8 x 8 cell layout: long corridors, traces stop at every wall
+			const int32 Cells = 8;
+			const double CellSize = Volume.GetSize().X / Cells;
+			const double HalfWall = 10.0;
+			for (int32 j = 0; j < Cells; ++j)
+			{
+				for (int32 i = 0; i < Cells; ++i)
+				{
+					const bool bCarveNorth = (j < Cells - 1) && (i == Cells - 1 || Rng.RandBool());
+					const double X0 = Volume.Min.X + i * CellSize;
+					const double Y0 = Volume.Min.Y + j * CellSize;
+					if (bCarveNorth && i < Cells - 1)
+					{
+						SpawnBlock(World, Cube, FBox(FVector(X0 + CellSize - HalfWall, Y0, Volume.Min.Z), FVector(X0 + CellSize + HalfWall, Y0 + CellSize, Volume.Max.Z)));
+					}
+					if (!bCarveNorth && j < Cells - 1)
+					{
+						SpawnBlock(World, Cube, FBox(FVector(X0, Y0 + CellSize - HalfWall, Volume.Min.Z), FVector(X0 + CellSize, Y0 + CellSize + HalfWall, Volume.Max.Z)));
+					}
+				}
+			}
+			return true;
+		}
+		if (Scene == TEXT("Solid"))
+		{
+			// One block filling the central 80% per axis: mostly blocked centers, worst case for sub-sampling
+			SpawnBlock(World, Cube, FBox(Volume.Min * 0.8, Volume.Max * 0.8));
+			return true;
+		}
+		UE_LOG(LogPVolBenchmark, Warning, TEXT("Unknown scene '%s' (expected Empty, Clutter, Maze or Solid)"), *Scene);
+		return false;
+	}
+
+	static void RunOne(UWorld *World, int32 Size, bool bSubSampling, bool bOverlapTest, EE_VolumeAnalysisExecution Execution, int32 JsonMaxSize, const FString &TempDir, FRunResult &Out)
+	{
+		Out.Size = Size;
+		Out.bSubSampling = bSubSampling;
+		Out.bOverlapTest = bOverlapTest;
+
+		ACPP_AT_VolumeAnalysis_Base *Analyzer = World->SpawnActor<ACPP_AT_VolumeAnalysis_Base>();
+		if (!Analyzer)
+		{
+			return;
+		}
+		TArray<FS_LinkedBox> VolumeBoxes;
+		UCPP_BPL__VolumeAnalysis::GenerateVoxelGridBoxes_ByCounts(Volume, 1, 1, 1, VolumeBoxes);
+		Analyzer->VolumeBox = VolumeBoxes[0];
+		Analyzer->SampleCountX = Size;
+		Analyzer->SampleCountY = Size;
+		Analyzer->SampleCountZ = Size;
+		Analyzer->bDrawDebug = false;
+		Analyzer->bEnableSubSampling = bSubSampling;
+		Analyzer->bUseCenterOverlapTest = bOverlapTest;
+		Analyzer->ExecutionMode = Execution;
+		// Game-thread runs still go through the stepping path, just in large slices
+		Analyzer->TickBudgetMs = 50.f;
+
+		const FPlatformMemoryStats MemBefore = FPlatformMemory::GetStats();
+		const double StartSeconds = FPlatformTime::Seconds();
+		Analyzer->StartAnalysis();
+		while (Analyzer->IsAnalysisRunning())
+		{
+			Analyzer->Tick(0.f);
+			if (Execution == EE_VolumeAnalysisExecution::ParallelWorkers)
+			{
+				FPlatformProcess::Sleep(0.001f);
+			}
+		}
+		Out.TotalSeconds = FPlatformTime::Seconds() - StartSeconds;
+		const FPlatformMemoryStats MemAfter = FPlatformMemory::GetStats();
+
+		const FS_VoxelGrid &Grid = Analyzer->GetResultGrid();
+		Out.bCompleted = Grid.IsValid();
+		Out.Summary = Analyzer->GetLastRunSummary();
+		Out.ResultBytes = Grid.VisibilityBits.GetAllocatedSize() + Grid.Flags.GetAllocatedSize();
+		Out.UsedPhysicalDelta = static_cast<int64>(MemAfter.UsedPhysical) - static_cast<int64>(MemBefore.UsedPhysical);
+		Out.PeakUsedPhysical = static_cast<int64>(MemAfter.PeakUsedPhysical);
+
+		if (Out.bCompleted)
+		{
+			const FString BinaryPath = TempDir / TEXT("Result.pvag");
+			double T0 = FPlatformTime::Seconds();
+			if (Analyzer->SaveAnalysisResultsToBinaryFile(BinaryPath))
+			{
+				Out.BinarySaveSeconds = FPlatformTime::Seconds() - T0;
+				Out.BinaryBytes = IFileManager::Get().FileSize(*BinaryPath);
+				FS_VoxelGrid Loaded;
+				T0 = FPlatformTime::Seconds();
+				UCPP_BPL__VolumeAnalysis::LoadVoxelGridFromBinaryFile(BinaryPath, Loaded);
+				Out.BinaryLoadSeconds = FPlatformTime::Seconds() - T0;
+			}
+
+			if (Size <= JsonMaxSize)
+			{
+				const FString JsonPath = TempDir / TEXT("Result.json");
+				const TArray<FS_LinkedBox> Boxes = Analyzer->GetAnalysisResults();
+				T0 = FPlatformTime::Seconds();
+				if (UCPP_BPL__VolumeAnalysis::SaveLinkedBoxesToJsonFile(Boxes, JsonPath, /*bPretty*/ false))
+				{
+					Out.JsonSaveSeconds = FPlatformTime::Seconds() - T0;
+					Out.JsonBytes = IFileManager::Get().FileSize(*JsonPath);
+					TArray<FS_LinkedBox> Loaded;
+					T0 = FPlatformTime::Seconds();
+					UCPP_BPL__VolumeAnalysis::LoadLinkedBoxesFromJsonFile(JsonPath, Loaded);
+					Out.JsonLoadSeconds = FPlatformTime::Seconds() - T0;
+				}
+			}
+		}
+		Analyzer->Destroy();
+	}
+
+	static void WriteRun(TJsonWriter<> &Writer, const FRunResult &Run)
+	{
+		const FS_VolumeAnalysisRunSummary &S = Run.Summary;
+		Writer.WriteObjectStart();
+		Writer.WriteValue(TEXT("scene"), Run.Scene);
+		Writer.WriteValue(TEXT("size"), Run.Size);
+		Writer.WriteValue(TEXT("subSampling"), Run.bSubSampling);
+		Writer.WriteValue(TEXT("overlapTest"), Run.bOverlapTest);
+		Writer.WriteValue(TEXT("completed"), Run.bCompleted);
+		Writer.WriteValue(TEXT("totalSeconds"), Run.TotalSeconds);
+		Writer.WriteValue(TEXT("wallSeconds"), S.WallSeconds);
+		Writer.WriteValue(TEXT("voxels"), S.NumVoxels);
+		Writer.WriteValue(TEXT("visibleVoxels"), S.VisibleVoxels);
+		Writer.WriteValue(TEXT("refinedVoxels"), S.RefinedVoxels);
+		Writer.WriteValue(TEXT("lineTraces"), S.LineTraces);
+		Writer.WriteValue(TEXT("overlapSweeps"), S.OverlapSweeps);
+		Writer.WriteValue(TEXT("overlapCacheHits"), S.OverlapCacheHits);
+		Writer.WriteValue(TEXT("queriesPerSecond"), S.QueriesPerSecond);
+		Writer.WriteValue(TEXT("queriesPerVoxel"), S.QueriesPerVoxel);
+
+		Writer.WriteObjectStart(TEXT("memory"));
+		Writer.WriteValue(TEXT("resultBytes"), Run.ResultBytes);
+		Writer.WriteValue(TEXT("usedPhysicalDeltaBytes"), Run.UsedPhysicalDelta);
+		Writer.WriteValue(TEXT("processPeakUsedPhysicalBytes"), Run.PeakUsedPhysical);
+		Writer.WriteObjectEnd();
+
+		Writer.WriteObjectStart(TEXT("io"));
+		Writer.WriteValue(TEXT("binaryBytes"), Run.BinaryBytes);
+		Writer.WriteValue(TEXT("binarySaveMBps"), Throughput(Run.BinaryBytes, Run.BinarySaveSeconds));
+		Writer.WriteValue(TEXT("binaryLoadMBps"), Throughput(Run.BinaryBytes, Run.BinaryLoadSeconds));
+		Writer.WriteValue(TEXT("jsonBytes"), Run.JsonBytes);
+		Writer.WriteValue(TEXT("jsonSaveMBps"), Throughput(Run.JsonBytes, Run.JsonSaveSeconds));
+		Writer.WriteValue(TEXT("jsonLoadMBps"), Throughput(Run.JsonBytes, Run.JsonLoadSeconds));
+		Writer.WriteObjectEnd();
+		Writer.WriteObjectEnd();
+	}
+}
+
+UCPP_CMD__VolumeAnalysisBenchmarkCommandlet::UCPP_CMD__VolumeAnalysisBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UCPP_CMD__VolumeAnalysisBenchmarkCommandlet::Main(const FString &Params)
+{
+	using namespace VolumeAnalysisBenchmark;
+
+	FString ScenesParam = TEXT("Empty,Clutter,Maze,Solid");
+	FString SizesParam = TEXT("16,32,64,128,256");
+	FString ExecutionParam = TEXT("Parallel");
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("VolumeAnalysis/Benchmark.json");
+	int32 JsonMaxSize = 64;
+	int32 Seed = 1234;
+	FParse::Value(*Params, TEXT("Scenes="), ScenesParam);
+	FParse::Value(*Params, TEXT("Sizes="), SizesParam);
+	FParse::Value(*Params, TEXT("Execution="), ExecutionParam);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	FParse::Value(*Params, TEXT("JsonMaxSize="), JsonMaxSize);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+
+	TArray<FString> Scenes;
+	ScenesParam.ParseIntoArray(Scenes, TEXT(","));
+	TArray<FString> SizeStrings;
+	SizesParam.ParseIntoArray(SizeStrings, TEXT(","));
+	TArray<int32> Sizes;
+	for (const FString &SizeString : SizeStrings)
+	{
+		const int32 Size = FCString::Atoi(*SizeString);
+		if (Size > 0)
+		{
+			Sizes.Add(Size);
+		}
+	}
+	const EE_VolumeAnalysisExecution Execution = ExecutionParam.Equals(TEXT("GameThread"), ESearchCase::IgnoreCase) ? EE_VolumeAnalysisExecution::GameThreadTick : EE_VolumeAnalysisExecution::ParallelWorkers;
+
+	UStaticMesh *Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (!Cube || !GEngine || Scenes.Num() == 0 || Sizes.Num() == 0)
+	{
+		UE_LOG(LogPVolBenchmark, Error, TEXT("Benchmark: Missing engine cube mesh, engine, scenes or sizes"));
+		return 1;
+	}
+
+	const FString TempDir = FPaths::ProjectSavedDir() / TEXT("VolumeAnalysis/BenchmarkTemp");
+	IFileManager::Get().MakeDirectory(*TempDir, /*Tree*/ true);
+
+	TArray<FRunResult> Runs;
+	bool bAllCompleted = true;
+	for (const FString &Scene : Scenes)
+	{
+		// Fresh world per scene so geometry from one layout never leaks into another
+		UWorld *World = UWorld::CreateWorld(EWorldType::Game, /*bInformEngineOfWorld*/ false, *FString::Printf(TEXT("VolumeAnalysisBenchmark_%s"), *Scene));
+		FWorldContext &WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+		World->InitializeActorsForPlay(FURL());
+
+		if (BuildScene(World, Cube, Scene, Seed))
+		{
+			// Let the physics scene pick up the new static bodies before it is queried
+			for (int32 Frame = 0; Frame < 2; ++Frame)
+			{
+				World->Tick(LEVELTICK_All, 1.f / 30.f);
+			}
+
+			for (const int32 Size : Sizes)
+			{
+				for (int32 Config = 0; Config < 4; ++Config)
+				{
+					FRunResult &Run = Runs.AddDefaulted_GetRef();
+					Run.Scene = Scene;
+					RunOne(World, Size, (Config & 1) != 0, (Config & 2) != 0, Execution, JsonMaxSize, TempDir, Run);
+					bAllCompleted &= Run.bCompleted;
+					UE_LOG(LogPVolBenchmark, Display, TEXT("%s %d^3 sub=%d overlap=%d: %s"), *Scene, Size, Run.bSubSampling, Run.bOverlapTest, Run.bCompleted ? *Run.Summary.ToString() : TEXT("FAILED"));
+				}
+			}
+		}
+		else
+		{
+			bAllCompleted = false;
+		}
+
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(/*bInformEngineOfWorld*/ false);
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+	IFileManager::Get().DeleteDirectory(*TempDir, /*RequireExists*/ false, /*Tree*/ true);
+
+	FString Report;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Report);
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("formatVersion"), 1);
+	Writer->WriteValue(TEXT("timestampUtc"), FDateTime::UtcNow().ToIso8601());
+	Writer->WriteValue(TEXT("engineVersion"), FEngineVersion::Current().ToString());
+	Writer->WriteValue(TEXT("logicalCores"), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+	Writer->WriteValue(TEXT("execution"), Execution == EE_VolumeAnalysisExecution::ParallelWorkers ? TEXT("Parallel") : TEXT("GameThread"));
+	Writer->WriteValue(TEXT("seed"), Seed);
+	Writer->WriteArrayStart(TEXT("runs"));
+	for (const FRunResult &Run : Runs)
+	{
+		WriteRun(*Writer, Run);
+	}
+	Writer->WriteArrayEnd();
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	if (!FFileHelper::SaveStringToFile(Report, *OutputPath))
+	{
+		UE_LOG(LogPVolBenchmark, Error, TEXT("Benchmark: Could not write report to '%s'"), *OutputPath);
+		return 1;
+	}
+	UE_LOG(LogPVolBenchmark, Display, TEXT("Benchmark: %d runs written to '%s'"), Runs.Num(), *OutputPath);
+	return bAllCompleted ? 0 : 1;
+}
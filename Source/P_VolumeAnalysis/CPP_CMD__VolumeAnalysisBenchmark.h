@@ -0,0 +1,35 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "CPP_CMD__VolumeAnalysisBenchmark.generated.h"
+
+/**
+ * Runs ACPP_AT_VolumeAnalysis_Base over synthetic scenes at several grid sizes and settings, then writes a
+ * machine-readable JSON report (time, scene query counts, memory, binary/JSON IO throughput).
+ *
+ * UnrealEditor-Cmd <Project> -run=CPP_CMD__VolumeAnalysisBenchmark [options]
+ *   -Scenes=Empty,Clutter,Maze,Solid   scenes to build (default: all)
+ *   -Sizes=16,32,64,128,256            voxels per axis (default: all)
+ *   -Execution=Parallel|GameThread     engine execution mode (default: Parallel)
+ *   -JsonMaxSize=64                    largest size whose linked-box JSON round trip is timed (JSON grows ~1 KB per voxel)
+ *   -Seed=1234                         random seed for scene layout
+ *   -Output=<path>                     report path (default: <ProjectSaved>/VolumeAnalysis/Benchmark.json)
+ * Returns non-zero if any run failed to complete.
+ */
+UCLASS()
+class P_VOLUMEANALYSIS_API UCPP_CMD__VolumeAnalysisBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UCPP_CMD__VolumeAnalysisBenchmarkCommandlet();
+
+	virtual int32 Main(const FString &Params) override;
+};
@@ -0,0 +1,56 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#include "CPP_DA__VolumeAnalysisBakedResults.h"
+
+bool UCPP_DA__VolumeAnalysisBakedResults::HasResults() const
+{
+	const int64 NumVoxels = int64(Counts.X) * Counts.Y * Counts.Z;
+	return Counts.X > 0 && Counts.Y > 0 && Counts.Z > 0 && NumVoxels <= MAX_int32 && VisibilityBits.Num() == FMath::DivideAndRoundUp(static_cast<int32>(NumVoxels), 32);
+}
+
+void UCPP_DA__VolumeAnalysisBakedResults::SetFromGrid(const FS_VoxelGrid &Grid, const FS_VolumeAnalysisRunSummary &InSummary, const FString &InSourceKey)
+{
+	Origin = Grid.Origin;
+	CellSize = Grid.CellSize;
+	Counts = FIntVector(Grid.CountX, Grid.CountY, Grid.CountZ);
+	VisibilityBits = Grid.VisibilityBits;
+	OriginMasks = Grid.HasOriginMasks() ? Grid.OriginMasks : TArray<uint8>();
+	EdgesX = Grid.EdgesX;
+	EdgesY = Grid.EdgesY;
+	EdgesZ = Grid.EdgesZ;
+	Summary = InSummary;
+	SourceKey = InSourceKey;
+	BakedAtUtc = FDateTime::UtcNow();
+}
+
+bool UCPP_DA__VolumeAnalysisBakedResults::CopyToGrid(FS_VoxelGrid &OutGrid) const
+{
+	OutGrid.Reset();
+	if (!HasResults())
+	{
+		return false;
+	}
+	OutGrid.Origin = Origin;
+	OutGrid.CellSize = CellSize;
+	OutGrid.CountX = Counts.X;
+	OutGrid.CountY = Counts.Y;
+	OutGrid.CountZ = Counts.Z;
+	OutGrid.VisibilityBits = VisibilityBits;
+	if (OriginMasks.Num() == OutGrid.Num())
+	{
+		OutGrid.OriginMasks = OriginMasks;
+	}
+	// Edges were taken from a valid grid, so they only need to match its counts
+	const auto AxisEdges = [](const TArray<double> &Edges, int32 Count)
+	{
+		return Edges.Num() == Count + 1 ? Edges : TArray<double>();
+	};
+	OutGrid.EdgesX = AxisEdges(EdgesX, Counts.X);
+	OutGrid.EdgesY = AxisEdges(EdgesY, Counts.Y);
+	OutGrid.EdgesZ = AxisEdges(EdgesZ, Counts.Z);
+	return true;
+}
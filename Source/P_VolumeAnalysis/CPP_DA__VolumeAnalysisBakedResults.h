@@ -0,0 +1,71 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "CPP_ST__VolumeAnalysisGrid.h"
+#include "CPP_EN__VolumeAnalysisEngine.h"
+#include "CPP_DA__VolumeAnalysisBakedResults.generated.h"
+
+/**
+ * Analysis results baked ahead of time (CPP_CMD__VolumeAnalysisBake, or the actor's BakeResults editor action) so
+ * shipping builds never trace at runtime. Only the packed visibility bits (and origin masks of a FromOrigins run)
+ * are stored: 1 bit per voxel, no per-voxel overlap cache.
+ */
+UCLASS(BlueprintType)
+class P_VOLUMEANALYSIS_API UCPP_DA__VolumeAnalysisBakedResults : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Bake")
+	FVector Origin = FVector::ZeroVector;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Bake")
+	FVector CellSize = FVector::ZeroVector;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Bake")
+	FIntVector Counts = FIntVector::ZeroValue;
+
+	// Result cache key of the baking run; differs from the actor's current key once the level or settings changed
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Bake")
+	FString SourceKey;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Bake")
+	FDateTime BakedAtUtc;
+
+	// Stats of the baking run
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Bake")
+	FS_VolumeAnalysisRunSummary Summary;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Bake")
+	bool HasResults() const;
+
+	// Replace the stored results (flags are dropped)
+	void SetFromGrid(const FS_VoxelGrid &Grid, const FS_VolumeAnalysisRunSummary &InSummary, const FString &InSourceKey);
+
+	// Copy the stored results into an owning grid; false if nothing is baked
+	bool CopyToGrid(FS_VoxelGrid &OutGrid) const;
+
+private:
+	UPROPERTY()
+	TArray<uint32> VisibilityBits;
+
+	UPROPERTY()
+	TArray<uint8> OriginMasks;
+
+	// Cell boundaries of non-uniform axes (empty for uniform ones)
+	UPROPERTY()
+	TArray<double> EdgesX;
+
+	UPROPERTY()
+	TArray<double> EdgesY;
+
+	UPROPERTY()
+	TArray<double> EdgesZ;
+};
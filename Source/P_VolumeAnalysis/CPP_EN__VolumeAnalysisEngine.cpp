@@ -0,0 +1,1536 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#include "CPP_EN__VolumeAnalysisEngine.h"
+#include "CPP_EN__VolumeAnalysisStats.h"
+#include "CPP_BPL__VolumeAnalysis.h"
+#include "Engine/World.h"
+#include "DrawDebugHelpers.h"
+#include "Components/LineBatchComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Async/ParallelFor.h"
+#include "Algo/StableSort.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPVolEngine, Log, All);
+
+DEFINE_STAT(STAT_PVol_PrePass);
+DEFINE_STAT(STAT_PVol_ScanX);
+DEFINE_STAT(STAT_PVol_ScanY);
+DEFINE_STAT(STAT_PVol_ScanZ);
+DEFINE_STAT(STAT_PVol_Adaptive);
+DEFINE_STAT(STAT_PVol_OriginRays);
+DEFINE_STAT(STAT_PVol_OverlapTest);
+DEFINE_STAT(STAT_PVol_GatherPrimitives);
+DEFINE_STAT(STAT_PVol_SubSampling);
+DEFINE_STAT(STAT_PVol_Finalize);
+DEFINE_STAT(STAT_PVol_DebugDraw);
+DEFINE_STAT(STAT_PVol_LineTraces);
+DEFINE_STAT(STAT_PVol_Sweeps);
+DEFINE_STAT(STAT_PVol_OverlapCacheHits);
+DEFINE_STAT(STAT_PVol_PrimitiveTests);
+
+FString FS_VolumeAnalysisRunSummary::ToString() const
+{
+    return FString::Printf(TEXT("%.3fs, %d voxels (%d visible, %d refined), %lld traces + %lld sweeps (%lld cache hits), %.0f queries/s, %.2f queries/voxel%s"),
+                           WallSeconds, NumVoxels, VisibleVoxels, RefinedVoxels, LineTraces, OverlapSweeps, OverlapCacheHits, QueriesPerSecond, QueriesPerVoxel, bIncremental ? TEXT(" [incremental]") : TEXT(""));
+}
+
+FVolumeAnalysisEngine::FVolumeAnalysisEngine(UWorld *InWorld, const FS_VolumeAnalysisSettings &InSettings, const FCollisionQueryParams &InQueryParams)
+    : World(InWorld), Settings(InSettings), QueryParams(InQueryParams)
+{
+}
+
+bool FVolumeAnalysisEngine::Init(const FBox &Volume, int32 CountX, int32 CountY, int32 CountZ, const FVector &CellGrowth)
+{
+    // Generate voxel grid (all voxels start hidden) with a fresh per-voxel overlap cache
+    Grid.Init(Volume, CountX, CountY, CountZ);
+    if (!World || !Grid.IsValid())
+    {
+        return false;
+    }
+    const FIntVector Counts(CountX, CountY, CountZ);
+    for (int32 Axis = 0; Axis < 3; ++Axis)
+    {
+        if (CellGrowth[Axis] > 1.0)
+        {
+            TArray<double> Edges;
+            UCPP_BPL__VolumeAnalysis::MakeGradedAxisEdges(Volume.Min[Axis], Volume.Max[Axis], Counts[Axis], CellGrowth[Axis], Edges);
+            Grid.SetAxisEdges(Axis, MoveTemp(Edges));
+        }
+    }
+    Grid.AllocateFlags();
+
+    bRestricted = false;
+    DirtyRanges.Reset();
+    ResolveRunSettings();
+    ResetRunState();
+    return true;
+}
+
+bool FVolumeAnalysisEngine::InitIncremental(const FS_VoxelGrid &PreviousGrid, TConstArrayView<FBox> DirtyBounds, TArray<uint8> &&OverlapCache)
+{
+    Grid = PreviousGrid;
+    if (!World || !Grid.IsValid())
+    {
+        return false;
+    }
+    if (OverlapCache.Num() == Grid.Num())
+    {
+        Grid.Flags = MoveTemp(OverlapCache);
+    }
+    else if (!Grid.HasFlags())
+    {
+        // Results loaded from disk, or published without the cache, start with every center untested
+        Grid.AllocateFlags();
+    }
+    ResolveRunSettings();
+
+    // Overlap spheres reach past the changed geometry, so grow each range; adaptive mode works in whole root cells
+    const int32 Dilation = 1 + FMath::FloorToInt(OverlapRadius / FMath::Max(KINDA_SMALL_NUMBER, static_cast<float>(Grid.CellSize.GetMin())));
+    if (bFromOrigins)
+    {
+        // Any change can move a shadow anywhere in the grid: a full run that keeps the overlap cache outside the bounds
+        bool bTouched = false;
+        for (const FBox &Bounds : DirtyBounds)
+        {
+            bTouched |= !Grid.GetVoxelRange(Bounds, Dilation).IsEmpty();
+        }
+        if (!bTouched)
+        {
+            return false;
+        }
+        Grid.ResetVisibility();
+        for (const FBox &Bounds : DirtyBounds)
+        {
+            const FVoxelRange Range = Grid.GetVoxelRange(Bounds, Dilation);
+            for (int32 Z = Range.Min.Z; Z < Range.Max.Z; ++Z)
+            {
+                for (int32 Y = Range.Min.Y; Y < Range.Max.Y; ++Y)
+                {
+                    for (int32 X = Range.Min.X; X < Range.Max.X; ++X)
+                    {
+                        Grid.Flags[Grid.Index(X, Y, Z)] = 0;
+                    }
+                }
+            }
+        }
+        bRestricted = false;
+        DirtyRanges.Reset();
+        ResetRunState();
+        return true;
+    }
+
+    const int32 RootSize = bAdaptive ? (1 << FMath::Clamp(Settings.AdaptiveMaxDepth, 0, 10)) : 1;
+    const FIntVector Counts(Grid.CountX, Grid.CountY, Grid.CountZ);
+    DirtyRanges.Reset();
+    for (const FBox &Bounds : DirtyBounds)
+    {
+        FVoxelRange Range = Grid.GetVoxelRange(Bounds, Dilation);
+        if (Range.IsEmpty())
+        {
+            continue;
+        }
+        for (int32 Axis = 0; Axis < 3; ++Axis)
+        {
+            Range.Min[Axis] = (Range.Min[Axis] / RootSize) * RootSize;
+            Range.Max[Axis] = FMath::Min(FMath::DivideAndRoundUp(Range.Max[Axis], RootSize) * RootSize, Counts[Axis]);
+        }
+        DirtyRanges.Add(Range);
+    }
+    if (DirtyRanges.Num() == 0)
+    {
+        return false;
+    }
+
+    // Forget visibility and cached overlap results inside the ranges; everything else is still valid
+    for (const FVoxelRange &Range : DirtyRanges)
+    {
+        for (int32 Z = Range.Min.Z; Z < Range.Max.Z; ++Z)
+        {
+            for (int32 Y = Range.Min.Y; Y < Range.Max.Y; ++Y)
+            {
+                for (int32 X = Range.Min.X; X < Range.Max.X; ++X)
+                {
+                    const int32 VoxelIdx = Grid.Index(X, Y, Z);
+                    Grid.SetVisible(VoxelIdx, false);
+                    Grid.Flags[VoxelIdx] = 0;
+                }
+            }
+        }
+    }
+
+    bRestricted = true;
+    BuildRestrictedRows();
+    ResetRunState();
+    return true;
+}
+
+// Voxels per axis of an adaptive root cell, or 1 when the run's results do not depend on how the grid is cut
+static int32 GetShardAlignment(const FS_VolumeAnalysisSettings &InSettings)
+{
+    const bool bAdaptiveRun = InSettings.Visibility != EE_VolumeAnalysisVisibility::FromOrigins && InSettings.Refinement == EE_VolumeAnalysisRefinement::Adaptive;
+    return bAdaptiveRun ? (1 << FMath::Clamp(InSettings.AdaptiveMaxDepth, 0, 10)) : 1;
+}
+
+FVoxelRange FVolumeAnalysisEngine::GetShardComputeRange(const FS_VolumeAnalysisSettings &InSettings, const FIntVector &Counts, const FVoxelRange &Range)
+{
+    // Uniform rows reach every voxel whatever their traces hit and sub-sampling stays inside its box, and origin rays
+    // start at fixed points, so those results are per voxel. Adaptive classification depends on the root cells.
+    const int32 Align = GetShardAlignment(InSettings);
+    FVoxelRange Compute;
+    for (int32 Axis = 0; Axis < 3; ++Axis)
+    {
+        const int32 Min = FMath::Clamp(Range.Min[Axis], 0, Counts[Axis]);
+        const int32 Max = FMath::Clamp(Range.Max[Axis], 0, Counts[Axis]);
+        Compute.Min[Axis] = (Min / Align) * Align;
+        Compute.Max[Axis] = FMath::Min(FMath::DivideAndRoundUp(Max, Align) * Align, Counts[Axis]);
+    }
+    return Compute;
+}
+
+void FVolumeAnalysisEngine::PlanShards(const FS_VolumeAnalysisSettings &InSettings, const FIntVector &Counts, const FIntVector &ShardsPerAxis, TArray<FS_VolumeAnalysisShard> &OutShards)
+{
+    OutShards.Reset();
+    if (Counts.X <= 0 || Counts.Y <= 0 || Counts.Z <= 0)
+    {
+        return;
+    }
+    const int32 Align = GetShardAlignment(InSettings);
+    TArray<int32, TInlineAllocator<16>> Cuts[3];
+    for (int32 Axis = 0; Axis < 3; ++Axis)
+    {
+        const int32 NumCuts = FMath::Clamp(ShardsPerAxis[Axis], 1, FMath::DivideAndRoundUp(Counts[Axis], Align));
+        Cuts[Axis].Add(0);
+        for (int32 i = 1; i < NumCuts; ++i)
+        {
+            const int32 Cut = FMath::RoundToInt32(static_cast<double>(Counts[Axis]) * i / (NumCuts * Align)) * Align;
+            if (Cut > Cuts[Axis].Last() && Cut < Counts[Axis])
+            {
+                Cuts[Axis].Add(Cut);
+            }
+        }
+        Cuts[Axis].Add(Counts[Axis]);
+    }
+
+    for (int32 Z = 0; Z + 1 < Cuts[2].Num(); ++Z)
+    {
+        for (int32 Y = 0; Y + 1 < Cuts[1].Num(); ++Y)
+        {
+            for (int32 X = 0; X + 1 < Cuts[0].Num(); ++X)
+            {
+                FS_VolumeAnalysisShard &Shard = OutShards.AddDefaulted_GetRef();
+                Shard.Index = OutShards.Num() - 1;
+                Shard.Min = FIntVector(Cuts[0][X], Cuts[1][Y], Cuts[2][Z]);
+                Shard.Max = FIntVector(Cuts[0][X + 1], Cuts[1][Y + 1], Cuts[2][Z + 1]);
+                const FVoxelRange Compute = GetShardComputeRange(InSettings, Counts, FVoxelRange(Shard.Min, Shard.Max));
+                Shard.ComputeMin = Compute.Min;
+                Shard.ComputeMax = Compute.Max;
+            }
+        }
+    }
+}
+
+void FVolumeAnalysisEngine::ResolveRunSettings()
+{
+    // Resolve the center overlap radius and refinement mode once per run
+    const float AutoR = 0.25f * FMath::Max(0.001f, static_cast<float>(Grid.CellSize.GetMin()));
+    OverlapRadius = (Settings.CenterOverlapRadius > 0.f) ? Settings.CenterOverlapRadius : AutoR;
+    Primitives.Reset();
+    RowCentersX.Reset();
+    if (Settings.bUseCenterOverlapTest && Settings.bClassifyPrimitiveShapes)
+    {
+        // Gathered on the calling thread; workers only read the result
+        SCOPE_CYCLE_COUNTER(STAT_PVol_GatherPrimitives);
+        Primitives.Gather(*World, Grid.GetBounds(), Settings.TraceChannel, QueryParams, OverlapRadius);
+        RowCentersX.SetNumUninitialized(Grid.CountX);
+        for (int32 X = 0; X < Grid.CountX; ++X)
+        {
+            RowCentersX[X] = Grid.GetAxisCenter(0, X);
+        }
+        UE_LOG(LogPVolEngine, Verbose, TEXT("Classifying centers against %d primitive shapes (%d complex bounds left to sweeps)"), Primitives.GetNumShapes(), Primitives.GetNumComplexBounds());
+    }
+    bFromOrigins = (Settings.Visibility == EE_VolumeAnalysisVisibility::FromOrigins);
+    bAdaptive = !bFromOrigins && (Settings.Refinement == EE_VolumeAnalysisRefinement::Adaptive);
+
+    // Every free voxel is reached by the first scan phase, so later phases mostly skip resolved voxels; starting with
+    // the longest rows resolves the open space with the fewest rows (and traces)
+    PhaseAxes[0] = 0;
+    PhaseAxes[1] = 1;
+    PhaseAxes[2] = 2;
+    if (!bAdaptive && !bFromOrigins && Settings.PhaseOrder == EE_VolumeAnalysisPhaseOrder::LongestAxisFirst)
+    {
+        const FIntVector Counts(Grid.CountX, Grid.CountY, Grid.CountZ);
+        Algo::StableSort(PhaseAxes, [&Counts](int32 A, int32 B)
+                         { return Counts[A] > Counts[B]; });
+    }
+    OriginRays.Reset();
+    if (!bFromOrigins)
+    {
+        Grid.OriginMasks.Empty();
+        return;
+    }
+    if (Settings.Origins.Num() == 0)
+    {
+        UE_LOG(LogPVolEngine, Warning, TEXT("Visibility is FromOrigins but no origins are set; every voxel stays hidden"));
+    }
+    else if (Settings.Origins.Num() > 8)
+    {
+        UE_LOG(LogPVolEngine, Warning, TEXT("%d visibility origins set; only the first 8 fit in the origin mask"), Settings.Origins.Num());
+    }
+    Grid.OriginMasks.Reset();
+    Grid.OriginMasks.SetNumZeroed(Grid.Num());
+    BuildOriginBatches();
+}
+
+bool FVolumeAnalysisEngine::FOriginRays::IsInView(const FVector &Point) const
+{
+    if (!bFrustum)
+    {
+        return true;
+    }
+    // View space: X forward, Y right, Z up
+    const FVector Local = InvRotation.RotateVector(Point - Location);
+    return Local.X > 0.0 && FMath::Abs(Local.Y) <= Local.X * TanHalfFovX && FMath::Abs(Local.Z) <= Local.X * TanHalfFovY;
+}
+
+void FVolumeAnalysisEngine::BuildOriginBatches()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FVolumeAnalysisEngine::BuildOriginBatches);
+    OriginBrickCounts = FIntVector(FMath::DivideAndRoundUp(Grid.CountX, OriginBrickSize), FMath::DivideAndRoundUp(Grid.CountY, OriginBrickSize), FMath::DivideAndRoundUp(Grid.CountZ, OriginBrickSize));
+    const int32 NumBricks = OriginBrickCounts.X * OriginBrickCounts.Y * OriginBrickCounts.Z;
+
+    // Rays into one brick share most of their BVH path; walking bricks in elevation bands, with azimuth reversed on
+    // every other band, keeps consecutive batches pointing in neighbouring directions as well
+    constexpr int32 NumBands = 16;
+    const int32 NumOrigins = FMath::Min(Settings.Origins.Num(), 8);
+    OriginRays.SetNum(NumOrigins);
+    TArray<uint64> Keys;
+    Keys.SetNumUninitialized(NumBricks);
+    for (int32 OriginIndex = 0; OriginIndex < NumOrigins; ++OriginIndex)
+    {
+        const FS_VolumeAnalysisOrigin &Origin = Settings.Origins[OriginIndex];
+        FOriginRays &Rays = OriginRays[OriginIndex];
+        Rays.Location = Origin.Location;
+        Rays.InvRotation = Origin.Rotation.Quaternion().Inverse();
+        Rays.bFrustum = Origin.FieldOfView > 0.f;
+        const double HalfFov = FMath::DegreesToRadians(FMath::Clamp(static_cast<double>(Origin.FieldOfView), 1.0, 179.0)) * 0.5;
+        Rays.TanHalfFovX = FMath::Tan(HalfFov);
+        Rays.TanHalfFovY = Rays.TanHalfFovX / FMath::Max(static_cast<double>(Origin.AspectRatio), 0.1);
+
+        for (int32 Brick = 0; Brick < NumBricks; ++Brick)
+        {
+            const FIntVector B(Brick % OriginBrickCounts.X, (Brick / OriginBrickCounts.X) % OriginBrickCounts.Y, Brick / (OriginBrickCounts.X * OriginBrickCounts.Y));
+            const FIntVector BrickMin = B * OriginBrickSize;
+            const FIntVector BrickMax(FMath::Min(BrickMin.X + OriginBrickSize, Grid.CountX), FMath::Min(BrickMin.Y + OriginBrickSize, Grid.CountY), FMath::Min(BrickMin.Z + OriginBrickSize, Grid.CountZ));
+            const FVector Center = Grid.GetRangeBounds(FVoxelRange(BrickMin, BrickMax)).GetCenter();
+            const FVector Dir = (Center - Rays.Location).GetSafeNormal();
+            const double Elevation = FMath::Asin(FMath::Clamp(Dir.Z, -1.0, 1.0));
+            const int32 Band = FMath::Clamp(FMath::FloorToInt32((Elevation / UE_DOUBLE_PI + 0.5) * NumBands), 0, NumBands - 1);
+            double Azimuth = (FMath::Atan2(Dir.Y, Dir.X) / UE_DOUBLE_TWO_PI) + 0.5;
+            if (Band & 1)
+            {
+                Azimuth = 1.0 - Azimuth;
+            }
+            const uint64 AzimuthKey = static_cast<uint64>(FMath::Clamp(Azimuth, 0.0, 1.0) * double(MAX_uint32));
+            Keys[Brick] = (static_cast<uint64>(Band) << 32) | AzimuthKey;
+        }
+        Rays.BrickOrder.SetNumUninitialized(NumBricks);
+        for (int32 Brick = 0; Brick < NumBricks; ++Brick)
+        {
+            Rays.BrickOrder[Brick] = Brick;
+        }
+        Rays.BrickOrder.Sort([&Keys](int32 A, int32 B)
+                             { return Keys[A] < Keys[B]; });
+    }
+}
+
+void FVolumeAnalysisEngine::ProcessOriginBatch(int32 BatchIndex)
+{
+    const int32 NumBricks = OriginBrickCounts.X * OriginBrickCounts.Y * OriginBrickCounts.Z;
+    const int32 OriginIndex = BatchIndex / NumBricks;
+    const FOriginRays &Rays = OriginRays[OriginIndex];
+    const int32 Brick = Rays.BrickOrder[BatchIndex % NumBricks];
+    const FIntVector Min = FIntVector(Brick % OriginBrickCounts.X, (Brick / OriginBrickCounts.X) % OriginBrickCounts.Y, Brick / (OriginBrickCounts.X * OriginBrickCounts.Y)) * OriginBrickSize;
+    const FIntVector Max(FMath::Min(Min.X + OriginBrickSize, Grid.CountX), FMath::Min(Min.Y + OriginBrickSize, Grid.CountY), FMath::Min(Min.Z + OriginBrickSize, Grid.CountZ));
+
+    for (int32 Z = Min.Z; Z < Max.Z; ++Z)
+    {
+        for (int32 Y = Min.Y; Y < Max.Y; ++Y)
+        {
+            for (int32 X = Min.X; X < Max.X; ++X)
+            {
+                const int32 VoxelIdx = Grid.Index(X, Y, Z);
+                const FVector Center = Grid.GetCellCenter(X, Y, Z);
+                if (!IsTestedByOrigin(OriginIndex, Center))
+                {
+                    continue;
+                }
+                // The pre-pass resolved every center some origin tests, so this is a read even when batches run in parallel
+                if (!IsVoxelCenterFree(VoxelIdx))
+                {
+                    continue;
+                }
+                FHitResult Hit;
+                if (!LineTrace(Hit, Rays.Location, Center))
+                {
+                    Grid.AddOriginBitAtomic(VoxelIdx, OriginIndex);
+                    Grid.SetVisibleAtomic(VoxelIdx);
+                    if (bCanDebugDraw && DebugDraw.bDrawRays)
+                    {
+                        DrawLine(Rays.Location, Center, FColor::Green, DebugDraw.LineThickness);
+                    }
+                }
+                else if (bCanDebugDraw && DebugDraw.bDrawRays)
+                {
+                    DrawLine(Rays.Location, Hit.ImpactPoint, FColor::Green, DebugDraw.LineThickness);
+                    DrawLine(Hit.ImpactPoint, Center, FColor::Red, DebugDraw.LineThickness);
+                }
+            }
+        }
+    }
+}
+
+bool FVolumeAnalysisEngine::IsTestedByOrigin(int32 OriginIndex, const FVector &Center) const
+{
+    const FOriginRays &Rays = OriginRays[OriginIndex];
+    return Rays.IsInView(Center) && (Settings.MaxTraceDistance <= 0.f || FVector::DistSquared(Rays.Location, Center) <= FMath::Square(static_cast<double>(Settings.MaxTraceDistance)));
+}
+
+void FVolumeAnalysisEngine::BuildRestrictedRows()
+{
+    // Row index layouts match ProcessPhaseRow: slot 0/1 = Z*CountY+Y, slot 2 = Z*CountX+X, slot 3 = Y*CountX+X
+    const auto Collect = [this](int32 Slot, int32 RowCount, int32 Stride, int32 AxisA, int32 AxisB)
+    {
+        TBitArray<> Marked(false, RowCount);
+        for (const FVoxelRange &Range : DirtyRanges)
+        {
+            for (int32 B = Range.Min[AxisB]; B < Range.Max[AxisB]; ++B)
+            {
+                for (int32 A = Range.Min[AxisA]; A < Range.Max[AxisA]; ++A)
+                {
+                    Marked[B * Stride + A] = true;
+                }
+            }
+        }
+        RestrictedRows[Slot].Reset();
+        for (TConstSetBitIterator<> It(Marked); It; ++It)
+        {
+            RestrictedRows[Slot].Add(It.GetIndex());
+        }
+    };
+
+    for (TArray<int32> &Rows : RestrictedRows)
+    {
+        Rows.Reset();
+    }
+    if (bAdaptive)
+    {
+        // Phase 0 runs over root cells; ranges are root-aligned so each maps to whole roots
+        const int32 RootSize = 1 << FMath::Clamp(Settings.AdaptiveMaxDepth, 0, 10);
+        const FIntVector Roots(FMath::DivideAndRoundUp(Grid.CountX, RootSize), FMath::DivideAndRoundUp(Grid.CountY, RootSize), FMath::DivideAndRoundUp(Grid.CountZ, RootSize));
+        TBitArray<> Marked(false, Roots.X * Roots.Y * Roots.Z);
+        for (const FVoxelRange &Range : DirtyRanges)
+        {
+            for (int32 RZ = Range.Min.Z / RootSize; RZ < FMath::DivideAndRoundUp(Range.Max.Z, RootSize); ++RZ)
+            {
+                for (int32 RY = Range.Min.Y / RootSize; RY < FMath::DivideAndRoundUp(Range.Max.Y, RootSize); ++RY)
+                {
+                    for (int32 RX = Range.Min.X / RootSize; RX < FMath::DivideAndRoundUp(Range.Max.X, RootSize); ++RX)
+                    {
+                        Marked[(RZ * Roots.Y + RY) * Roots.X + RX] = true;
+                    }
+                }
+            }
+        }
+        for (TConstSetBitIterator<> It(Marked); It; ++It)
+        {
+            RestrictedRows[1].Add(It.GetIndex());
+        }
+        return;
+    }
+    Collect(0, Grid.CountY * Grid.CountZ, Grid.CountY, 1, 2);
+    Collect(1, Grid.CountY * Grid.CountZ, Grid.CountY, 1, 2);
+    Collect(2, Grid.CountX * Grid.CountZ, Grid.CountX, 0, 2);
+    Collect(3, Grid.CountX * Grid.CountY, Grid.CountX, 0, 1);
+}
+
+void FVolumeAnalysisEngine::ResetRunState()
+{
+    // Origin batches from different origins share voxels, so their overlap states must be resolved up front.
+    // Primitive classification is cheap enough to run over every row before the scans.
+    CurrentPhase = (!bAdaptive && Settings.bUseCenterOverlapTest && (Settings.bCenterOverlapPrePass || bFromOrigins || Primitives.IsActive())) ? -1 : 0;
+    CurrentPhaseRowIndex = 0;
+    bIsSubSampling = false;
+    HiddenBoxIndices.Reset();
+    CurrentHiddenIndex = 0;
+    AvgRowSeconds = 0.0;
+    AvgRefineSeconds = 0.0;
+
+    MainPassWork = 0;
+    for (int32 Phase = CurrentPhase; Phase < 3; ++Phase)
+    {
+        MainPassWork += GetPhaseRowCount(Phase);
+    }
+    int32 MaxHidden = Grid.Num();
+    if (bRestricted)
+    {
+        MaxHidden = 0;
+        for (const FVoxelRange &Range : DirtyRanges)
+        {
+            MaxHidden += static_cast<int32>(Range.Num());
+        }
+        MaxHidden = FMath::Min(MaxHidden, Grid.Num());
+    }
+    TotalWork = MainPassWork + ((Settings.bEnableSubSampling && !bAdaptive && !bFromOrigins) ? MaxHidden : 0);
+    CompletedWork = 0;
+
+    NumLineTraces = 0;
+    NumSweeps = 0;
+    NumOverlapCacheHits = 0;
+    RunStartSeconds = FPlatformTime::Seconds();
+    RunEndSeconds = 0.0;
+
+    bCancelled = false;
+    bComplete = false;
+}
+
+void FVolumeAnalysisEngine::MarkComplete()
+{
+    RunEndSeconds = FPlatformTime::Seconds();
+    bComplete = true;
+}
+
+FS_VolumeAnalysisRunSummary FVolumeAnalysisEngine::GetRunSummary() const
+{
+    FS_VolumeAnalysisRunSummary Summary;
+    Summary.WallSeconds = static_cast<float>((bComplete ? RunEndSeconds : FPlatformTime::Seconds()) - RunStartSeconds);
+    Summary.NumVoxels = Grid.Num();
+    Summary.VisibleVoxels = Grid.CountVisible();
+    Summary.RefinedVoxels = HiddenBoxIndices.Num();
+    Summary.LineTraces = NumLineTraces.load(std::memory_order_relaxed);
+    Summary.OverlapSweeps = NumSweeps.load(std::memory_order_relaxed);
+    Summary.OverlapCacheHits = NumOverlapCacheHits.load(std::memory_order_relaxed);
+    const double Queries = static_cast<double>(Summary.LineTraces + Summary.OverlapSweeps);
+    Summary.QueriesPerSecond = Summary.WallSeconds > 0.f ? static_cast<float>(Queries / Summary.WallSeconds) : 0.f;
+    Summary.QueriesPerVoxel = Summary.NumVoxels > 0 ? static_cast<float>(Queries / Summary.NumVoxels) : 0.f;
+    Summary.bIncremental = bRestricted;
+    return Summary;
+}
+
+bool FVolumeAnalysisEngine::LineTrace(FHitResult &OutHit, const FVector &Start, const FVector &End) const
+{
+    NumLineTraces.fetch_add(1, std::memory_order_relaxed);
+    INC_DWORD_STAT(STAT_PVol_LineTraces);
+    return World->LineTraceSingleByChannel(OutHit, Start, End, Settings.TraceChannel, QueryParams);
+}
+
+void FVolumeAnalysisEngine::TraceRowIntervals(const FVector &Start, const FVector &End, FRowIntervals &OutSolid) const
+{
+    OutSolid.Reset();
+    // Reused per worker thread; a multi-hit trace cannot take an inline allocator
+    static thread_local TArray<FHitResult> Hits;
+    const FCollisionResponseParams AllTouch(ECR_Overlap);
+    const ECollisionChannel Channel = Settings.TraceChannel;
+    const double Length = FVector::Distance(Start, End);
+
+    // Touches include geometry that only overlaps the channel; only blockers count. The response is the hit body's
+    // (bones and instances may override their component's)
+    const auto IsBlocker = [Channel](const FHitResult &Hit)
+    {
+        const UPrimitiveComponent *Component = Hit.GetComponent();
+        if (!Component)
+        {
+            return false;
+        }
+        const FBodyInstance *Body = Component->GetBodyInstance(Hit.BoneName, /*bGetWelded*/ true, Hit.Item);
+        return (Body ? Body->GetResponseToChannel(Channel) : Component->GetCollisionResponseToChannel(Channel)) == ECR_Block;
+    };
+
+    // (distance from Start, +1 entering / -1 leaving a blocker)
+    TArray<TPair<double, int32>, TInlineAllocator<32>> Events;
+    NumLineTraces.fetch_add(1, std::memory_order_relaxed);
+    INC_DWORD_STAT(STAT_PVol_LineTraces);
+    Hits.Reset();
+    World->LineTraceMultiByChannel(Hits, Start, End, Channel, QueryParams, AllTouch);
+    for (const FHitResult &Hit : Hits)
+    {
+        if (IsBlocker(Hit))
+        {
+            Events.Emplace(Hit.Time * Length, 1);
+        }
+    }
+    if (Events.Num() == 0)
+    {
+        // Like a single-hit trace, a segment with no entries is open
+        return;
+    }
+    // Entries seen from End are the exits
+    NumLineTraces.fetch_add(1, std::memory_order_relaxed);
+    INC_DWORD_STAT(STAT_PVol_LineTraces);
+    Hits.Reset();
+    World->LineTraceMultiByChannel(Hits, End, Start, Channel, QueryParams, AllTouch);
+    for (const FHitResult &Hit : Hits)
+    {
+        if (IsBlocker(Hit))
+        {
+            Events.Emplace((1.0 - Hit.Time) * Length, -1);
+        }
+    }
+    Events.Sort([](const TPair<double, int32> &A, const TPair<double, int32> &B)
+                { return A.Key < B.Key || (A.Key == B.Key && A.Value < B.Value); });
+
+    // An exit without an earlier entry means Start is inside a blocker; start deep enough that depth never goes negative
+    int32 Depth = 0;
+    int32 MinDepth = 0;
+    for (const TPair<double, int32> &Event : Events)
+    {
+        Depth += Event.Value;
+        MinDepth = FMath::Min(MinDepth, Depth);
+    }
+    Depth = -MinDepth;
+    double SolidStart = 0.0;
+    for (const TPair<double, int32> &Event : Events)
+    {
+        const int32 Before = Depth;
+        Depth += Event.Value;
+        if (Before <= 0 && Depth > 0)
+        {
+            SolidStart = Event.Key;
+        }
+        else if (Before > 0 && Depth <= 0)
+        {
+            OutSolid.Emplace(SolidStart, Event.Key);
+        }
+    }
+    if (Depth > 0)
+    {
+        // End lies inside a blocker
+        OutSolid.Emplace(SolidStart, Length);
+    }
+}
+
+float FVolumeAnalysisEngine::GetProgress() const
+{
+    if (bComplete)
+    {
+        return 1.f;
+    }
+    const int32 Total = TotalWork;
+    return (Total > 0) ? FMath::Clamp(static_cast<float>(CompletedWork) / static_cast<float>(Total), 0.f, 1.f) : 0.f;
+}
+
+bool FVolumeAnalysisEngine::FStepBudget::HasRoomFor(double UnitEstimate) const
+{
+    if (UnitsDone >= MaxUnits)
+    {
+        return false;
+    }
+    return EndTime <= 0.0 || UnitsDone == 0 || Now + UnitEstimate <= EndTime;
+}
+
+void FVolumeAnalysisEngine::FStepBudget::Consume(double StartTime, double &AvgSeconds)
+{
+    Now = FPlatformTime::Seconds();
+    const double Cost = Now - StartTime;
+    AvgSeconds = (AvgSeconds > 0.0) ? FMath::Lerp(AvgSeconds, Cost, 0.25) : Cost;
+    ++UnitsDone;
+}
+
+bool FVolumeAnalysisEngine::ProcessRowsStep(int32 MaxRowsPerStep, double TimeBudgetSeconds)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FVolumeAnalysisEngine::ProcessRowsStep);
+    if (bComplete || bCancelled)
+    {
+        return bComplete;
+    }
+    bCanDebugDraw = true;
+
+    FStepBudget Budget;
+    Budget.Now = FPlatformTime::Seconds();
+    if (TimeBudgetSeconds > 0.0)
+    {
+        Budget.EndTime = Budget.Now + TimeBudgetSeconds;
+    }
+    else
+    {
+        Budget.MaxUnits = FMath::Max(1, MaxRowsPerStep);
+    }
+
+    if (!bIsSubSampling)
+    {
+        while (CurrentPhase < 3 && Budget.HasRoomFor(AvgRowSeconds))
+        {
+            if (CurrentPhaseRowIndex >= GetPhaseRowCount(CurrentPhase))
+            {
+                ++CurrentPhase;
+                CurrentPhaseRowIndex = 0;
+                continue;
+            }
+            const double RowStart = Budget.Now;
+            ProcessPhaseRow(CurrentPhase, CurrentPhaseRowIndex);
+            ++CurrentPhaseRowIndex;
+            Budget.Consume(RowStart, AvgRowSeconds);
+        }
+
+        // progress log
+        if (CurrentPhase < 3)
+        {
+            UE_LOG(LogPVolEngine, VeryVerbose, TEXT("ProcessRowsStep: Phase=%d Row=%d"), CurrentPhase, CurrentPhaseRowIndex);
+            return false;
+        }
+        BeginSubSampling();
+    }
+
+    if (bIsSubSampling)
+    {
+        if (Budget.HasRoomFor(AvgRefineSeconds))
+        {
+            ProcessRowsStep_SubSampling(Budget);
+        }
+        else
+        {
+            UE_LOG(LogPVolEngine, VeryVerbose, TEXT("SubSampling: Deferring to next step (no remaining budget)"));
+        }
+    }
+    return bComplete;
+}
+
+void FVolumeAnalysisEngine::RunParallel()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FVolumeAnalysisEngine::RunParallel);
+    bCanDebugDraw = false;
+    if (bComplete)
+    {
+        return;
+    }
+
+    // Rows within a phase touch disjoint voxels, so they run unordered; phases stay sequential
+    for (; CurrentPhase < 3 && !bCancelled; ++CurrentPhase)
+    {
+        const int32 Phase = CurrentPhase;
+        TRACE_CPUPROFILER_EVENT_SCOPE(FVolumeAnalysisEngine::RunParallel_MainPhase);
+        ParallelFor(GetPhaseRowCount(Phase), [this, Phase](int32 RowIndex)
+                    {
+                        if (!bCancelled)
+                        {
+                            ProcessPhaseRow(Phase, RowIndex);
+                        } });
+        CurrentPhaseRowIndex = 0;
+    }
+    if (bCancelled)
+    {
+        return;
+    }
+
+    if (!bIsSubSampling)
+    {
+        BeginSubSampling();
+    }
+    if (bIsSubSampling)
+    {
+        // Hidden boxes are independent; each worker task allocates one scratch cache up front and reuses it for every box
+        const int32 SubTotal = Settings.SubSampleCountX * Settings.SubSampleCountY * Settings.SubSampleCountZ;
+        const int32 FirstHidden = CurrentHiddenIndex;
+        TRACE_CPUPROFILER_EVENT_SCOPE(FVolumeAnalysisEngine::RunParallel_SubSampling);
+        TArray<TArray<EE_CenterOverlapState>> TaskScratch;
+        ParallelForWithTaskContext(
+            TaskScratch, HiddenBoxIndices.Num() - FirstHidden, [SubTotal](int32 /*ContextIndex*/, int32 /*NumContexts*/)
+            {
+                TArray<EE_CenterOverlapState> Scratch;
+                Scratch.SetNumUninitialized(SubTotal);
+                return Scratch; },
+            [this, FirstHidden](TArray<EE_CenterOverlapState> &Scratch, int32 HiddenIndex)
+            {
+                if (bCancelled)
+                {
+                    return;
+                }
+                RefineHiddenBox(HiddenBoxIndices[FirstHidden + HiddenIndex], Scratch);
+                ++CompletedWork; });
+        if (bCancelled)
+        {
+            return;
+        }
+        CurrentHiddenIndex = HiddenBoxIndices.Num();
+        bIsSubSampling = false;
+        MarkComplete();
+    }
+}
+
+int32 FVolumeAnalysisEngine::GetPhaseRowCount(int32 Phase) const
+{
+    if (bRestricted)
+    {
+        return (Phase >= -1 && Phase < 3) ? RestrictedRows[GetPhaseAxis(Phase) + 1].Num() : 0;
+    }
+    if (bFromOrigins && Phase >= 0)
+    {
+        return (Phase == 0) ? OriginRays.Num() * OriginBrickCounts.X * OriginBrickCounts.Y * OriginBrickCounts.Z : 0;
+    }
+    if (bAdaptive)
+    {
+        const FIntVector Roots = GetAdaptiveRootCounts();
+        return (Phase == 0) ? Roots.X * Roots.Y * Roots.Z : 0;
+    }
+    switch (GetPhaseAxis(Phase))
+    {
+    case -1:
+    case 0:
+        return Grid.CountY * Grid.CountZ;
+    case 1:
+        return Grid.CountX * Grid.CountZ;
+    case 2:
+        return Grid.CountX * Grid.CountY;
+    default:
+        return 0;
+    }
+}
+
+void FVolumeAnalysisEngine::ProcessPhaseRow(int32 Phase, int32 RowIndex)
+{
+    if (bRestricted)
+    {
+        RowIndex = RestrictedRows[GetPhaseAxis(Phase) + 1][RowIndex];
+    }
+    if (bAdaptive)
+    {
+        SCOPE_CYCLE_COUNTER(STAT_PVol_Adaptive);
+        ProcessAdaptiveRoot(RowIndex);
+        ++CompletedWork;
+        return;
+    }
+    if (bFromOrigins && Phase == 0)
+    {
+        SCOPE_CYCLE_COUNTER(STAT_PVol_OriginRays);
+        ProcessOriginBatch(RowIndex);
+        ++CompletedWork;
+        return;
+    }
+    switch (GetPhaseAxis(Phase))
+    {
+    case -1:
+    {
+        SCOPE_CYCLE_COUNTER(STAT_PVol_PrePass);
+        if (Primitives.IsActive())
+        {
+            ClassifyRowCenters(RowIndex);
+        }
+        if (Settings.bCenterOverlapPrePass || bFromOrigins)
+        {
+            // Batched center overlap pre-pass: resolve one X-row of voxels, in memory order. With origins, only the
+            // centers at least one origin traces to are needed.
+            const int32 RowStart = RowIndex * Grid.CountX;
+            const int32 Y = RowIndex % Grid.CountY;
+            const int32 Z = RowIndex / Grid.CountY;
+            for (int32 X = 0; X < Grid.CountX; ++X)
+            {
+                if (bFromOrigins)
+                {
+                    const FVector Center = Grid.GetCellCenter(X, Y, Z);
+                    bool bTested = false;
+                    for (int32 OriginIndex = 0; OriginIndex < OriginRays.Num() && !bTested; ++OriginIndex)
+                    {
+                        bTested = IsTestedByOrigin(OriginIndex, Center);
+                    }
+                    if (!bTested)
+                    {
+                        continue;
+                    }
+                }
+                IsVoxelCenterFree(RowStart + X);
+            }
+        }
+        break;
+    }
+    case 0:
+    {
+        SCOPE_CYCLE_COUNTER(STAT_PVol_ScanX);
+        ScanAxisRow<0>(FIntVector(0, RowIndex % Grid.CountY, RowIndex / Grid.CountY));
+        break;
+    }
+    case 1:
+    {
+        SCOPE_CYCLE_COUNTER(STAT_PVol_ScanY);
+        ScanAxisRow<1>(FIntVector(RowIndex % Grid.CountX, 0, RowIndex / Grid.CountX));
+        break;
+    }
+    case 2:
+    {
+        SCOPE_CYCLE_COUNTER(STAT_PVol_ScanZ);
+        ScanAxisRow<2>(FIntVector(RowIndex % Grid.CountX, RowIndex / Grid.CountX, 0));
+        break;
+    }
+    default:
+        break;
+    }
+    ++CompletedWork;
+}
+
+// Main-pass row policy: positions are voxels along Axis, reached voxels with a free center become visible
+template <int32 Axis>
+struct FVolumeAnalysisEngine::TMainRowPolicy
+{
+    FVolumeAnalysisEngine &Engine;
+    FIntVector RowStart;
+    int32 BaseIndex;
+    int32 Stride;
+
+    TMainRowPolicy(FVolumeAnalysisEngine &InEngine, const FIntVector &InRowStart)
+        : Engine(InEngine), RowStart(InRowStart)
+    {
+        const FS_VoxelGrid &Grid = Engine.Grid;
+        RowStart[Axis] = 0;
+        BaseIndex = Grid.Index(RowStart.X, RowStart.Y, RowStart.Z);
+        Stride = (Axis == 0) ? 1 : (Axis == 1) ? Grid.CountX : Grid.CountX * Grid.CountY;
+    }
+
+    FORCEINLINE FVector CenterAt(int32 i) const
+    {
+        FIntVector Coord = RowStart;
+        Coord[Axis] = i;
+        return Engine.Grid.GetCellCenter(Coord.X, Coord.Y, Coord.Z);
+    }
+
+    FORCEINLINE double PositionAt(int32 i) const { return Engine.Grid.GetAxisCenter(Axis, i); }
+
+    FORCEINLINE bool Trace(FHitResult &OutHit, const FVector &Start, const FVector &End) const
+    {
+        return Engine.LineTrace(OutHit, Start, End);
+    }
+
+    // Returns true to stop the scan; every voxel of a main-pass row must be visited
+    FORCEINLINE bool Reach(int32 i) const
+    {
+        const int32 VoxelIdx = BaseIndex + i * Stride;
+        if (Engine.IsVoxelCenterFree(VoxelIdx))
+            Engine.Grid.SetVisibleAtomic(VoxelIdx);
+        return false;
+    }
+
+    // Visible, or known to have a blocked center: no later trace can change it. Only this row's own voxels are read, but
+    // their visibility words are shared with neighbouring rows that set bits atomically, hence the relaxed atomic load;
+    // this row's flags bytes are written by no other row of the phase.
+    FORCEINLINE bool IsResolved(int32 i) const
+    {
+        const int32 VoxelIdx = BaseIndex + i * Stride;
+        return Engine.Grid.IsVisibleAtomic(VoxelIdx) || (Engine.Settings.bUseCenterOverlapTest && Engine.Grid.GetCenterOverlapState(VoxelIdx) == EE_CenterOverlapState::Blocked);
+    }
+
+    FORCEINLINE bool IsDone() const { return false; }
+
+    static constexpr bool bSubSample = false;
+};
+
+// One hidden box being refined: analytic sub-voxel centers plus the per-box overlap cache in Scratch
+struct FVolumeAnalysisEngine::FSubSampleBox
+{
+    FVolumeAnalysisEngine &Engine;
+    TArrayView<EE_CenterOverlapState> Scratch;
+    FIntVector Counts;
+    FVector SubOrigin;
+    FVector SubCell;
+    bool bAnyVisible = false;
+
+    FORCEINLINE int32 IndexSub(const FIntVector &S) const
+    {
+        return S.Z * (Counts.Y * Counts.X) + S.Y * Counts.X + S.X;
+    }
+
+    FORCEINLINE FVector CenterAt(const FIntVector &S) const
+    {
+        return SubOrigin + SubCell * FVector(S.X + 0.5, S.Y + 0.5, S.Z + 0.5);
+    }
+
+    bool IsCenterFree(const FIntVector &S)
+    {
+        if (!Engine.Settings.bUseCenterOverlapTest)
+        {
+            return true;
+        }
+        EE_CenterOverlapState &State = Scratch[IndexSub(S)];
+        if (State == EE_CenterOverlapState::Unknown)
+        {
+            State = Engine.TestCenterOverlap(CenterAt(S)) ? EE_CenterOverlapState::Blocked : EE_CenterOverlapState::Free;
+        }
+        else
+        {
+            Engine.NumOverlapCacheHits.fetch_add(1, std::memory_order_relaxed);
+            INC_DWORD_STAT(STAT_PVol_OverlapCacheHits);
+        }
+        return State == EE_CenterOverlapState::Free;
+    }
+};
+
+// Sub-sample row policy: positions are sub-voxels along Axis of one hidden box; stops at the first free reachable center
+template <int32 Axis>
+struct FVolumeAnalysisEngine::TSubRowPolicy
+{
+    FSubSampleBox &Box;
+    FIntVector RowStart;
+
+    FORCEINLINE FIntVector CoordAt(int32 i) const
+    {
+        FIntVector Coord = RowStart;
+        Coord[Axis] = i;
+        return Coord;
+    }
+
+    FORCEINLINE FVector CenterAt(int32 i) const { return Box.CenterAt(CoordAt(i)); }
+
+    FORCEINLINE double PositionAt(int32 i) const { return Box.SubOrigin[Axis] + Box.SubCell[Axis] * (i + 0.5); }
+
+    FORCEINLINE bool Trace(FHitResult &OutHit, const FVector &Start, const FVector &End) const
+    {
+        return Box.Engine.LineTrace(OutHit, Start, End);
+    }
+
+    FORCEINLINE bool Reach(int32 i)
+    {
+        if (Box.IsCenterFree(CoordAt(i)))
+            Box.bAnyVisible = true;
+        return Box.bAnyVisible;
+    }
+
+    FORCEINLINE bool IsResolved(int32 /*i*/) const { return false; }
+
+    FORCEINLINE bool IsDone() const { return Box.bAnyVisible; }
+
+    static constexpr bool bSubSample = true;
+};
+
+// Last position in [From, To] whose center lies within Distance of From's along the row (centers increase with i).
+// The small tolerance of a position step keeps a hit exactly on a center from dropping that position.
+template <typename PolicyType>
+static int32 LastPositionWithin(const PolicyType &Policy, int32 From, int32 To, double Distance)
+{
+    if (To <= From)
+    {
+        return From;
+    }
+    const double Base = Policy.PositionAt(From);
+    const double Limit = Base + Distance + 1e-3 * (Policy.PositionAt(From + 1) - Base);
+    int32 Lo = From;
+    int32 Hi = To;
+    while (Lo < Hi)
+    {
+        const int32 Mid = Lo + (Hi - Lo + 1) / 2;
+        if (Policy.PositionAt(Mid) <= Limit)
+        {
+            Lo = Mid;
+        }
+        else
+        {
+            Hi = Mid - 1;
+        }
+    }
+    return Lo;
+}
+
+// Segmented row scan using long traces: trace to the row end (or MaxTraceDistance), reach every position up to the
+// hit, then restart just past it
+template <typename PolicyType>
+void FVolumeAnalysisEngine::ScanSegmentedRow(PolicyType &Policy, int32 Count) const
+{
+    if (Count <= 0)
+        return;
+    if (Count == 1)
+    {
+        if (!Policy.IsResolved(0))
+            Policy.Reach(0);
+        return;
+    }
+
+    int32 StartI = 0;
+    while (StartI < Count && !Policy.IsDone())
+    {
+        // Runs of resolved positions need no trace; a row with nothing left to resolve costs no queries at all
+        while (StartI < Count && Policy.IsResolved(StartI))
+        {
+            ++StartI;
+        }
+        if (StartI >= Count)
+        {
+            break;
+        }
+        int32 TargetI = Count - 1;
+        if (Settings.MaxTraceDistance > 0.f)
+        {
+            // At least one step, so every segment makes progress
+            TargetI = FMath::Min(FMath::Max(LastPositionWithin(Policy, StartI, Count - 1, Settings.MaxTraceDistance), StartI + 1), Count - 1);
+        }
+        while (TargetI > StartI && Policy.IsResolved(TargetI))
+        {
+            --TargetI;
+        }
+        if (PolicyType::bSubSample || Settings.RowTrace != EE_VolumeAnalysisRowTrace::MultiHit)
+        {
+            StartI = FMath::Min(TraceSegment(Policy, StartI, TargetI) + 1, Count);
+            continue;
+        }
+
+        // Positions outside every blocker's span are open and reached from the pair of multi-hit queries; each span
+        // is then scanned with single-hit traces, which find the walls inside it that the multi-hit traces skip
+        const FVector StartC = Policy.CenterAt(StartI);
+        const FVector EndC = Policy.CenterAt(TargetI);
+        FRowIntervals Spans;
+        TraceRowIntervals(StartC, EndC, Spans);
+        const double Base = Policy.PositionAt(StartI);
+        int32 Next = 0;
+        for (int32 i = StartI; i <= TargetI;)
+        {
+            const double Dist = Policy.PositionAt(i) - Base;
+            while (Next < Spans.Num() && Spans[Next].Max <= Dist)
+            {
+                ++Next;
+            }
+            if (Next >= Spans.Num() || Spans[Next].Min > Dist)
+            {
+                if (!Policy.IsResolved(i) && Policy.Reach(i))
+                    return;
+                ++i;
+                continue;
+            }
+            int32 SpanLast = i;
+            while (SpanLast < TargetI && Policy.PositionAt(SpanLast + 1) - Base < Spans[Next].Max)
+            {
+                ++SpanLast;
+            }
+            while (i <= SpanLast && !Policy.IsDone())
+            {
+                while (i <= SpanLast && Policy.IsResolved(i))
+                {
+                    ++i;
+                }
+                if (i <= SpanLast)
+                {
+                    const int32 SpanTarget = (i < SpanLast) ? SpanLast : FMath::Min(SpanLast + 1, TargetI);
+                    i = FMath::Min(TraceSegment(Policy, i, SpanTarget), SpanLast) + 1;
+                }
+            }
+            if (Policy.IsDone())
+                return;
+        }
+        if (bCanDebugDraw && DebugDraw.bDrawRays)
+        {
+            const FVector Dir = (EndC - StartC).GetSafeNormal();
+            double From = 0.0;
+            for (const TInterval<double> &Span : Spans)
+            {
+                DrawLine(StartC + Dir * From, StartC + Dir * Span.Min, FColor::Green, DebugDraw.LineThickness);
+                From = Span.Max;
+            }
+            DrawLine(StartC + Dir * From, EndC, FColor::Green, DebugDraw.LineThickness);
+        }
+        StartI = TargetI + 1;
+    }
+}
+
+template <typename PolicyType>
+int32 FVolumeAnalysisEngine::TraceSegment(PolicyType &Policy, int32 StartI, int32 TargetI) const
+{
+    const FVector StartC = Policy.CenterAt(StartI);
+    const FVector EndC = Policy.CenterAt(TargetI);
+    FHitResult Hit;
+    const bool bHit = Policy.Trace(Hit, StartC, EndC);
+    int32 LastI = TargetI;
+    if (bHit)
+    {
+        const float SegmentLen = FVector::Distance(StartC, EndC);
+        const float HitDist = FMath::Clamp(Hit.Time * SegmentLen, 0.f, SegmentLen);
+        LastI = LastPositionWithin(Policy, StartI, TargetI, HitDist);
+    }
+    for (int32 i = StartI; i <= LastI; ++i)
+    {
+        if (!Policy.IsResolved(i) && Policy.Reach(i))
+            break;
+    }
+    if (bCanDebugDraw && DebugDraw.bDrawRays)
+    {
+        const FColor ClearColor = PolicyType::bSubSample ? FColor::Cyan : FColor::Green;
+        const float Thickness = PolicyType::bSubSample ? DebugDraw.LineThickness * 0.6f : DebugDraw.LineThickness;
+        if (!bHit)
+        {
+            DrawLine(StartC, EndC, ClearColor, Thickness);
+        }
+        else
+        {
+            const FVector HitPoint = StartC + (EndC - StartC) * Hit.Time;
+            DrawLine(StartC, HitPoint, ClearColor, Thickness);
+            DrawLine(HitPoint, EndC, FColor::Red, Thickness);
+        }
+    }
+    return LastI;
+}
+
+template <int32 Axis>
+void FVolumeAnalysisEngine::ScanAxisRow(const FIntVector &RowStart)
+{
+    TMainRowPolicy<Axis> Policy(*this, RowStart);
+    const int32 Count = (Axis == 0) ? Grid.CountX : (Axis == 1) ? Grid.CountY : Grid.CountZ;
+    ScanSegmentedRow(Policy, Count);
+}
+
+void FVolumeAnalysisEngine::BeginSubSampling()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FVolumeAnalysisEngine::BeginSubSampling);
+    // Adaptive mode refines mixed leaves inline, so there is no separate sub-sampling pass; origin masks are per voxel center
+    if (Settings.bEnableSubSampling && !bAdaptive && !bFromOrigins)
+    {
+        const int32 NumVoxels = Grid.Num();
+        const int32 TmpVisible = Grid.CountVisible();
+        HiddenBoxIndices.Reset();
+        if (bRestricted)
+        {
+            // Only voxels that were reset can have changed; ranges may overlap, so deduplicate
+            TBitArray<> Seen(false, NumVoxels);
+            for (const FVoxelRange &Range : DirtyRanges)
+            {
+                for (int32 Z = Range.Min.Z; Z < Range.Max.Z; ++Z)
+                {
+                    for (int32 Y = Range.Min.Y; Y < Range.Max.Y; ++Y)
+                    {
+                        for (int32 X = Range.Min.X; X < Range.Max.X; ++X)
+                        {
+                            const int32 VoxelIdx = Grid.Index(X, Y, Z);
+                            if (!Seen[VoxelIdx] && !Grid.IsVisible(VoxelIdx))
+                            {
+                                Seen[VoxelIdx] = true;
+                                HiddenBoxIndices.Add(VoxelIdx);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        else
+        {
+            HiddenBoxIndices.Reserve(NumVoxels - TmpVisible);
+            for (int32 i = 0; i < NumVoxels; ++i)
+            {
+                if (!Grid.IsVisible(i))
+                {
+                    HiddenBoxIndices.Add(i);
+                }
+            }
+        }
+        const int32 TmpHidden = HiddenBoxIndices.Num();
+        TotalWork = MainPassWork + TmpHidden;
+        bIsSubSampling = TmpHidden > 0;
+        CurrentHiddenIndex = 0;
+        if (bIsSubSampling)
+        {
+            UE_LOG(LogPVolEngine, Display, TEXT("SubSampling: %d hidden boxes to refine (Visible after main=%d, Hidden=%d)"), HiddenBoxIndices.Num(), TmpVisible, TmpHidden);
+            return;
+        }
+        UE_LOG(LogPVolEngine, Display, TEXT("SubSampling: Skipped (no hidden boxes). Main pass: Visible=%d Hidden=%d"), TmpVisible, TmpHidden);
+    }
+    MarkComplete();
+}
+
+// Sub-sampling step extension
+void FVolumeAnalysisEngine::ProcessRowsStep_SubSampling(FStepBudget &Budget)
+{
+    const int32 SubTotal = Settings.SubSampleCountX * Settings.SubSampleCountY * Settings.SubSampleCountZ;
+    SubCenterCache.SetNumUninitialized(SubTotal);
+
+    while (!bCancelled && CurrentHiddenIndex < HiddenBoxIndices.Num() && Budget.HasRoomFor(AvgRefineSeconds))
+    {
+        const int32 BoxIdx = HiddenBoxIndices[CurrentHiddenIndex];
+        ++CurrentHiddenIndex;
+        ++CompletedWork;
+        if (Grid.IsVisible(BoxIdx))
+        {
+            continue; // already flipped by earlier refinement
+        }
+        const double RefineStart = Budget.Now;
+        RefineHiddenBox(BoxIdx, SubCenterCache);
+        Budget.Consume(RefineStart, AvgRefineSeconds);
+    }
+
+    // If sub-sampling finished, the run is complete
+    if (CurrentHiddenIndex >= HiddenBoxIndices.Num())
+    {
+        bIsSubSampling = false;
+        MarkComplete();
+    }
+}
+
+FIntVector FVolumeAnalysisEngine::GetAdaptiveRootCounts() const
+{
+    const int32 RootSize = 1 << FMath::Clamp(Settings.AdaptiveMaxDepth, 0, 10);
+    return FIntVector(FMath::DivideAndRoundUp(Grid.CountX, RootSize), FMath::DivideAndRoundUp(Grid.CountY, RootSize), FMath::DivideAndRoundUp(Grid.CountZ, RootSize));
+}
+
+void FVolumeAnalysisEngine::ProcessAdaptiveRoot(int32 RootIndex)
+{
+    const int32 RootSize = 1 << FMath::Clamp(Settings.AdaptiveMaxDepth, 0, 10);
+    const FIntVector Roots = GetAdaptiveRootCounts();
+    const FIntVector R(RootIndex % Roots.X, (RootIndex / Roots.X) % Roots.Y, RootIndex / (Roots.X * Roots.Y));
+    const FIntVector Min = R * RootSize;
+    const FIntVector Max(FMath::Min(Min.X + RootSize, Grid.CountX), FMath::Min(Min.Y + RootSize, Grid.CountY), FMath::Min(Min.Z + RootSize, Grid.CountZ));
+
+    // Root cells touch disjoint voxels, so each one gets its own sub-sampling scratch
+    TArray<EE_CenterOverlapState, TInlineAllocator<64>> Scratch;
+    if (Settings.bEnableSubSampling)
+    {
+        Scratch.SetNumUninitialized(Settings.SubSampleCountX * Settings.SubSampleCountY * Settings.SubSampleCountZ);
+    }
+    ClassifyAdaptiveNode(Min, Max, Scratch);
+}
+
+void FVolumeAnalysisEngine::ClassifyAdaptiveNode(const FIntVector &Min, const FIntVector &Max, TArrayView<EE_CenterOverlapState> Scratch)
+{
+    const FBox NodeBox = Grid.GetRangeBounds(FVoxelRange(Min, Max));
+    if (bCanDebugDraw && DebugDraw.bDrawSubBoxes)
+    {
+        DrawLattice(NodeBox, 1, 1, 1, FColor(0, 255, 255));
+    }
+
+    // Fully open: nothing blocking anywhere in the cell, so every voxel is visible with a free center
+    NumSweeps.fetch_add(1, std::memory_order_relaxed);
+    INC_DWORD_STAT(STAT_PVol_Sweeps);
+    if (!World->OverlapBlockingTestByChannel(NodeBox.GetCenter(), FQuat::Identity, Settings.TraceChannel, FCollisionShape::MakeBox(NodeBox.GetExtent()), QueryParams))
+    {
+        for (int32 Z = Min.Z; Z < Max.Z; ++Z)
+        {
+            for (int32 Y = Min.Y; Y < Max.Y; ++Y)
+            {
+                for (int32 X = Min.X; X < Max.X; ++X)
+                {
+                    const int32 VoxelIdx = Grid.Index(X, Y, Z);
+                    Grid.SetVisibleAtomic(VoxelIdx);
+                    if (Grid.GetCenterOverlapState(VoxelIdx) == EE_CenterOverlapState::Unknown)
+                    {
+                        Grid.SetCenterOverlapState(VoxelIdx, false);
+                    }
+                }
+            }
+        }
+        return;
+    }
+
+    const FIntVector Size = Max - Min;
+    if (Size.X == 1 && Size.Y == 1 && Size.Z == 1)
+    {
+        // Mixed leaf voxel: same rule as the uniform pass, then the usual sub-sample refinement
+        const int32 VoxelIdx = Grid.Index(Min.X, Min.Y, Min.Z);
+        if (IsVoxelCenterFree(VoxelIdx))
+        {
+            Grid.SetVisibleAtomic(VoxelIdx);
+        }
+        else if (Settings.bEnableSubSampling)
+        {
+            RefineHiddenBox(VoxelIdx, Scratch);
+        }
+        return;
+    }
+
+    // Fully solid: voxels stay hidden without further queries
+    if (Settings.bAdaptiveSolidCulling && IsAdaptiveNodeSolid(NodeBox))
+    {
+        return;
+    }
+
+    // Mixed: split every axis longer than one voxel at its midpoint and recurse
+    const FIntVector Mid(Min.X + FMath::Max(1, Size.X / 2), Min.Y + FMath::Max(1, Size.Y / 2), Min.Z + FMath::Max(1, Size.Z / 2));
+    for (int32 CZ = 0; CZ < 2; ++CZ)
+    {
+        const int32 Z0 = CZ ? Mid.Z : Min.Z;
+        const int32 Z1 = CZ ? Max.Z : Mid.Z;
+        for (int32 CY = 0; CY < 2; ++CY)
+        {
+            const int32 Y0 = CY ? Mid.Y : Min.Y;
+            const int32 Y1 = CY ? Max.Y : Mid.Y;
+            for (int32 CX = 0; CX < 2; ++CX)
+            {
+                const int32 X0 = CX ? Mid.X : Min.X;
+                const int32 X1 = CX ? Max.X : Mid.X;
+                if (X0 < X1 && Y0 < Y1 && Z0 < Z1)
+                {
+                    ClassifyAdaptiveNode(FIntVector(X0, Y0, Z0), FIntVector(X1, Y1, Z1), Scratch);
+                }
+            }
+        }
+    }
+}
+
+bool FVolumeAnalysisEngine::IsAdaptiveNodeSolid(const FBox &NodeBox) const
+{
+    if (!TestCenterOverlap(NodeBox.GetCenter()))
+    {
+        return false;
+    }
+    for (int32 Corner = 0; Corner < 8; ++Corner)
+    {
+        const FVector P((Corner & 1) ? NodeBox.Max.X : NodeBox.Min.X, (Corner & 2) ? NodeBox.Max.Y : NodeBox.Min.Y, (Corner & 4) ? NodeBox.Max.Z : NodeBox.Min.Z);
+        if (!TestCenterOverlap(P))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FVolumeAnalysisEngine::RefineHiddenBox(int32 BoxIdx, TArrayView<EE_CenterOverlapState> Scratch)
+{
+    SCOPE_CYCLE_COUNTER(STAT_PVol_SubSampling);
+    const FIntVector Counts(Settings.SubSampleCountX, Settings.SubSampleCountY, Settings.SubSampleCountZ);
+
+    // Build sub-voxel grid within this box's AABB
+    const FBox BoxAABB = Grid.GetCellBox(BoxIdx);
+    if (bCanDebugDraw && DebugDraw.bDrawSubBoxes)
+    {
+        // cyan sub-box wireframes
+        DrawLattice(BoxAABB, Counts.X, Counts.Y, Counts.Z, FColor(0, 255, 255));
+    }
+
+    // Sub-voxel centers are computed analytically from the parent cell
+    FSubSampleBox Box{*this, Scratch, Counts, BoxAABB.Min, BoxAABB.GetSize() / FVector(Counts)};
+
+    // Per-box overlap cache so the X/Y/Z sub-scans query each sub-center at most once
+    for (EE_CenterOverlapState &State : Scratch)
+    {
+        State = EE_CenterOverlapState::Unknown;
+    }
+    if (Settings.bUseCenterOverlapTest && (Counts.X & Counts.Y & Counts.Z & 1))
+    {
+        // With odd counts the middle sub-voxel shares the parent's center, so reuse the main-pass result
+        Scratch[Box.IndexSub(Counts / 2)] = Grid.GetCenterOverlapState(BoxIdx);
+    }
+
+    // X-axis rows at fixed (y,z), then Y-axis rows at fixed (x,z), then Z-axis columns at fixed (x,y);
+    // the box is resolved as soon as any free sub-center is reached, so the remaining rows are skipped
+    for (int32 z = 0; z < Counts.Z && !Box.bAnyVisible; ++z)
+    {
+        for (int32 y = 0; y < Counts.Y && !Box.bAnyVisible; ++y)
+        {
+            TSubRowPolicy<0> Row{Box, FIntVector(0, y, z)};
+            ScanSegmentedRow(Row, Counts.X);
+        }
+    }
+    for (int32 z = 0; z < Counts.Z && !Box.bAnyVisible; ++z)
+    {
+        for (int32 x = 0; x < Counts.X && !Box.bAnyVisible; ++x)
+        {
+            TSubRowPolicy<1> Row{Box, FIntVector(x, 0, z)};
+            ScanSegmentedRow(Row, Counts.Y);
+        }
+    }
+    for (int32 y = 0; y < Counts.Y && !Box.bAnyVisible; ++y)
+    {
+        for (int32 x = 0; x < Counts.X && !Box.bAnyVisible; ++x)
+        {
+            TSubRowPolicy<2> Row{Box, FIntVector(x, y, 0)};
+            ScanSegmentedRow(Row, Counts.Z);
+        }
+    }
+
+    if (Box.bAnyVisible)
+    {
+        Grid.SetVisibleAtomic(BoxIdx);
+    }
+    return Box.bAnyVisible;
+}
+
+void FVolumeAnalysisEngine::DrawLine(const FVector &Start, const FVector &End, const FColor &Color, float Thickness) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_PVol_DebugDraw);
+    if (DebugDraw.LineBuffer)
+    {
+        // A zero lifetime would never expire in a line batcher; one tick is the closest match to a single frame
+        DebugDraw.LineBuffer->Emplace(Start, End, FLinearColor(Color), DebugDraw.Duration > 0.f ? DebugDraw.Duration : SMALL_NUMBER, Thickness, SDPG_World);
+        return;
+    }
+    DrawDebugLine(World, Start, End, Color, DebugDraw.Duration > 0.f, DebugDraw.Duration, 0, Thickness);
+}
+
+void FVolumeAnalysisEngine::DrawLattice(const FBox &Box, int32 CountX, int32 CountY, int32 CountZ, const FColor &Color) const
+{
+    const FVector Step = Box.GetSize() / FVector(CountX, CountY, CountZ);
+    const auto At = [&](int32 X, int32 Y, int32 Z)
+    {
+        return Box.Min + Step * FVector(X, Y, Z);
+    };
+    // One line per lattice edge row along each axis instead of 12 edges per cell
+    for (int32 Z = 0; Z <= CountZ; ++Z)
+    {
+        for (int32 Y = 0; Y <= CountY; ++Y)
+        {
+            DrawLine(At(0, Y, Z), At(CountX, Y, Z), Color, DebugDraw.LineThickness);
+        }
+        for (int32 X = 0; X <= CountX; ++X)
+        {
+            DrawLine(At(X, 0, Z), At(X, CountY, Z), Color, DebugDraw.LineThickness);
+        }
+    }
+    for (int32 Y = 0; Y <= CountY; ++Y)
+    {
+        for (int32 X = 0; X <= CountX; ++X)
+        {
+            DrawLine(At(X, Y, 0), At(X, Y, CountZ), Color, DebugDraw.LineThickness);
+        }
+    }
+}
+
+bool FVolumeAnalysisEngine::TestCenterOverlap(const FVector &Center) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_PVol_OverlapTest);
+    if (Primitives.IsActive())
+    {
+        const EE_CenterOverlapState State = Primitives.Classify(Center);
+        if (State != EE_CenterOverlapState::Unknown)
+        {
+            INC_DWORD_STAT(STAT_PVol_PrimitiveTests);
+            return State == EE_CenterOverlapState::Blocked;
+        }
+    }
+    NumSweeps.fetch_add(1, std::memory_order_relaxed);
+    INC_DWORD_STAT(STAT_PVol_Sweeps);
+    const FCollisionShape Shape = FCollisionShape::MakeSphere(OverlapRadius);
+    FHitResult Hit;
+    return World->SweepSingleByChannel(Hit, Center, Center, FQuat::Identity, Settings.TraceChannel, Shape, QueryParams);
+}
+
+bool FVolumeAnalysisEngine::IsVoxelCenterFree(int32 VoxelIndex)
+{
+    if (!Settings.bUseCenterOverlapTest)
+    {
+        return true;
+    }
+    // Each voxel belongs to exactly one row per phase, so this flag write never races
+    const EE_CenterOverlapState State = Grid.GetCenterOverlapState(VoxelIndex);
+    if (State != EE_CenterOverlapState::Unknown)
+    {
+        NumOverlapCacheHits.fetch_add(1, std::memory_order_relaxed);
+        INC_DWORD_STAT(STAT_PVol_OverlapCacheHits);
+        return State == EE_CenterOverlapState::Free;
+    }
+    const bool bBlocked = TestCenterOverlap(Grid.GetCellCenter(VoxelIndex));
+    Grid.SetCenterOverlapState(VoxelIndex, bBlocked);
+    return !bBlocked;
+}
+
+void FVolumeAnalysisEngine::ClassifyRowCenters(int32 RowIndex)
+{
+    const int32 Y = RowIndex % Grid.CountY;
+    const int32 Z = RowIndex / Grid.CountY;
+    TArray<EE_CenterOverlapState, TInlineAllocator<512>> States;
+    States.SetNumUninitialized(Grid.CountX);
+    Primitives.ClassifyRow(RowCentersX, Grid.GetAxisCenter(1, Y), Grid.GetAxisCenter(2, Z), States);
+
+    // Keep states an incremental run carried over; Unknown centers are swept on first use as before
+    const int32 RowStart = RowIndex * Grid.CountX;
+    int32 NumDecided = 0;
+    for (int32 X = 0; X < Grid.CountX; ++X)
+    {
+        if (States[X] != EE_CenterOverlapState::Unknown && Grid.GetCenterOverlapState(RowStart + X) == EE_CenterOverlapState::Unknown)
+        {
+            Grid.SetCenterOverlapState(RowStart + X, States[X] == EE_CenterOverlapState::Blocked);
+            ++NumDecided;
+        }
+    }
+    INC_DWORD_STAT_BY(STAT_PVol_PrimitiveTests, NumDecided);
+}
@@ -0,0 +1,496 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "CollisionQueryParams.h"
+#include "Math/Interval.h"
+#include "CPP_ST__VolumeAnalysisGrid.h"
+#include "CPP_EN__VolumeAnalysisPrimitives.h"
+#include <atomic>
+#include "CPP_EN__VolumeAnalysisEngine.generated.h"
+
+class UWorld;
+struct FBatchedLine;
+
+/** How an analysis run is executed */
+UENUM(BlueprintType)
+enum class EE_VolumeAnalysisExecution : uint8
+{
+    // Rows are processed on the game thread from Tick, throttled per frame (supports per-ray debug draw)
+    GameThreadTick UMETA(DisplayName = "Game Thread (Tick)"),
+    // Rows of each phase and hidden boxes are dispatched across worker threads; per-ray debug draw is skipped
+    ParallelWorkers UMETA(DisplayName = "Parallel (Worker Threads)")
+};
+
+/** How hidden space is refined below the voxel grid */
+UENUM(BlueprintType)
+enum class EE_VolumeAnalysisRefinement : uint8
+{
+    // Multi-axis row scan of the whole grid, then a fixed SubSampleCount refinement of every hidden voxel
+    Uniform UMETA(DisplayName = "Uniform (Row Scan + Sub-Sampling)"),
+    // Coarse-to-fine octree: whole cells are classified open/solid/mixed by box overlap and only mixed cells are subdivided
+    Adaptive UMETA(DisplayName = "Adaptive (Octree)")
+};
+
+/** How the analysis grid's resolution is chosen */
+UENUM(BlueprintType)
+enum class EE_VolumeAnalysisGridSizing : uint8
+{
+    // SampleCount cells per axis whatever the volume's size
+    ByCounts UMETA(DisplayName = "By Counts"),
+    // Cells of a fixed world size; counts follow the volume's size, capped by a voxel budget
+    ByCellSize UMETA(DisplayName = "By Cell Size")
+};
+
+/** How the row scans query the scene along each row */
+UENUM(BlueprintType)
+enum class EE_VolumeAnalysisRowTrace : uint8
+{
+    // One single-hit trace per segment; the row restarts after every hit
+    Segmented UMETA(DisplayName = "Segmented (Single Hit)"),
+    // Blockers are queried as overlaps so nothing ends the trace: one forward and one reverse multi-hit trace per
+    // segment give each blocking shape's first entry and last exit (one if it crosses none). Open stretches between
+    // shapes are reached from those two queries; the span of each shape is then scanned Segmented, since a shape can
+    // hold several walls (a complex-traced mesh reports one touch per trace). Results match Segmented; the saving
+    // grows with the open space between shapes.
+    MultiHit UMETA(DisplayName = "Multi-Hit (Shape Spans)")
+};
+
+/** Order of the main-pass axis scans */
+UENUM(BlueprintType)
+enum class EE_VolumeAnalysisPhaseOrder : uint8
+{
+    // X rows, then Y rows, then Z columns
+    Fixed UMETA(DisplayName = "Fixed (X, Y, Z)"),
+    // Axis with the longest rows first: fewest rows to trace, later phases skip what it already resolved
+    LongestAxisFirst UMETA(DisplayName = "Longest Axis First")
+};
+
+/** What a voxel's visibility means */
+UENUM(BlueprintType)
+enum class EE_VolumeAnalysisVisibility : uint8
+{
+    // Multi-axis row scans: a voxel is visible when an unobstructed row reaches it (open space connectivity)
+    Connectivity UMETA(DisplayName = "Connectivity (Axis Scan)"),
+    // Line of sight from each of Settings.Origins; bit N of a voxel's origin mask is set when origin N sees its center
+    FromOrigins UMETA(DisplayName = "From Origins (Line of Sight)")
+};
+
+/** A point (optionally with a view frustum) that voxels are tested for line of sight from */
+USTRUCT(BlueprintType)
+struct P_VOLUMEANALYSIS_API FS_VolumeAnalysisOrigin
+{
+    GENERATED_BODY()
+
+public:
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Origins")
+    FVector Location = FVector::ZeroVector;
+
+    // View direction; ignored when FieldOfView is 0
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Origins")
+    FRotator Rotation = FRotator::ZeroRotator;
+
+    // Horizontal field of view in degrees (0 = omnidirectional, voxels in every direction are traced)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Origins", meta = (ClampMin = "0.0", ClampMax = "179.0", UIMin = "0.0", UIMax = "179.0", Units = "deg"))
+    float FieldOfView = 0.f;
+
+    // Width / height of the frustum
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Origins", meta = (ClampMin = "0.1", UIMin = "0.1"))
+    float AspectRatio = 16.f / 9.f;
+};
+
+/** Trace and refinement settings for one analysis run (snapshot taken at start) */
+USTRUCT(BlueprintType)
+struct P_VOLUMEANALYSIS_API FS_VolumeAnalysisSettings
+{
+    GENERATED_BODY()
+
+public:
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Trace")
+    TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
+
+    // Max distance for line traces (0 = unlimited)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Trace", meta = (ClampMin = "0", UIMin = "0"))
+    float MaxTraceDistance = 0.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Trace")
+    EE_VolumeAnalysisRowTrace RowTrace = EE_VolumeAnalysisRowTrace::Segmented;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Trace")
+    EE_VolumeAnalysisPhaseOrder PhaseOrder = EE_VolumeAnalysisPhaseOrder::Fixed;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Visibility")
+    bool bUseCenterOverlapTest = true;
+
+    // <= 0 means auto from cell size (25% of the smallest axis)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Visibility", meta = (ClampMin = "0.0", UIMin = "0.0"))
+    float CenterOverlapRadius = 0.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Visibility")
+    bool bCenterOverlapPrePass = false;
+
+    // Resolve center overlaps in memory against the blocking boxes, spheres, capsules and convex hulls gathered at
+    // start; sweeps remain only near other geometry
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Visibility")
+    bool bClassifyPrimitiveShapes = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Origins")
+    EE_VolumeAnalysisVisibility Visibility = EE_VolumeAnalysisVisibility::Connectivity;
+
+    // FromOrigins only: one origin mask bit each, so at most 8 are used. Refinement and sub-sampling do not apply.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Origins")
+    TArray<FS_VolumeAnalysisOrigin> Origins;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|SubSampling")
+    bool bEnableSubSampling = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|SubSampling", meta = (ClampMin = "1", UIMin = "1"))
+    int32 SubSampleCountX = 2;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|SubSampling", meta = (ClampMin = "1", UIMin = "1"))
+    int32 SubSampleCountY = 2;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|SubSampling", meta = (ClampMin = "1", UIMin = "1"))
+    int32 SubSampleCountZ = 2;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Adaptive")
+    EE_VolumeAnalysisRefinement Refinement = EE_VolumeAnalysisRefinement::Uniform;
+
+    // Octree levels above the voxel grid: root cells span 2^Depth voxels per axis
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Adaptive", meta = (ClampMin = "0", ClampMax = "10", UIMin = "0", UIMax = "6"))
+    int32 AdaptiveMaxDepth = 3;
+
+    // Treat a mixed cell as fully solid when its center and all 8 corners are inside blocking geometry (heuristic; can miss enclosed pockets)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Adaptive")
+    bool bAdaptiveSolidCulling = true;
+};
+
+/** Debug draw options honored by the engine when stepping on the game thread */
+struct FVolumeAnalysisDebugDraw
+{
+    bool bDrawRays = false;
+    bool bDrawSubBoxes = false;
+    float LineThickness = 0.5f;
+    float Duration = 2.0f;
+    // When set, lines are appended here for the owner to submit in one batch instead of one DrawDebug call each
+    TArray<FBatchedLine> *LineBuffer = nullptr;
+};
+
+/** Cost and query statistics of one completed run */
+USTRUCT(BlueprintType)
+struct P_VOLUMEANALYSIS_API FS_VolumeAnalysisRunSummary
+{
+    GENERATED_BODY()
+
+public:
+    // From Init until the run completed
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Stats")
+    float WallSeconds = 0.f;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Stats")
+    int32 NumVoxels = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Stats")
+    int32 VisibleVoxels = 0;
+
+    // Hidden voxels handed to sub-sampling after the main pass
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Stats")
+    int32 RefinedVoxels = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Stats")
+    int64 LineTraces = 0;
+
+    // Center overlap sweeps and adaptive cell overlap tests
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Stats")
+    int64 OverlapSweeps = 0;
+
+    // Center overlap lookups answered from the per-run cache instead of a sweep
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Stats")
+    int64 OverlapCacheHits = 0;
+
+    // (LineTraces + OverlapSweeps) / WallSeconds
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Stats")
+    float QueriesPerSecond = 0.f;
+
+    // (LineTraces + OverlapSweeps) / NumVoxels
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Stats")
+    float QueriesPerVoxel = 0.f;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Stats")
+    bool bIncremental = false;
+
+    FString ToString() const;
+};
+
+/** One piece of a grid split for distributed runs, in voxel indices of the full grid */
+USTRUCT(BlueprintType)
+struct P_VOLUMEANALYSIS_API FS_VolumeAnalysisShard
+{
+    GENERATED_BODY()
+
+public:
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Shard")
+    int32 Index = 0;
+
+    // Voxels [Min, Max) this shard is responsible for
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Shard")
+    FIntVector Min = FIntVector::ZeroValue;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Shard")
+    FIntVector Max = FIntVector::ZeroValue;
+
+    // Voxels it analyses: [Min, Max) plus the halo needed to match a full run (see GetShardComputeRange)
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Shard")
+    FIntVector ComputeMin = FIntVector::ZeroValue;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Shard")
+    FIntVector ComputeMax = FIntVector::ZeroValue;
+};
+
+/**
+ * Volume analysis engine: owns the voxel grid and scan state for a single run.
+ * Runs either incrementally on the game thread (ProcessRowsStep) or in one go on worker threads (RunParallel).
+ * The world must outlive the run; owners cancel and wait before tearing it down.
+ */
+class P_VOLUMEANALYSIS_API FVolumeAnalysisEngine
+{
+public:
+    FVolumeAnalysisEngine(UWorld *InWorld, const FS_VolumeAnalysisSettings &InSettings, const FCollisionQueryParams &InQueryParams);
+
+    // Build the voxel grid for the volume and reset scan state; false if the volume or counts are invalid.
+    // Axes with CellGrowth above 1 get graded cells, finest at the volume's min side.
+    bool Init(const FBox &Volume, int32 CountX, int32 CountY, int32 CountZ, const FVector &CellGrowth = FVector::OneVector);
+
+    // Re-run only what changed geometry inside DirtyBounds can affect, starting from a previous result of this layout:
+    // voxels in the (dilated) bounds are reset, rows/columns crossing them are rescanned in every phase and only
+    // their hidden voxels are refined. False if the grid is invalid or no bounds touch it.
+    // FromOrigins runs cannot be restricted (a change can move a shadow anywhere): they fall back to a full re-trace
+    // that only re-tests centers inside the bounds, and IsIncremental() stays false.
+    // OverlapCache is the previous run's (from TakeGrid); without it every center is tested again.
+    bool InitIncremental(const FS_VoxelGrid &PreviousGrid, TConstArrayView<FBox> DirtyBounds, TArray<uint8> &&OverlapCache = TArray<uint8>());
+
+    bool IsIncremental() const { return bRestricted; }
+
+    // Distributed runs: voxels a run must cover so that, inside Range of a Counts grid, it finds exactly what a full
+    // run would. Grid-independent modes need no halo; adaptive runs grow Range to whole octree root cells.
+    static FVoxelRange GetShardComputeRange(const FS_VolumeAnalysisSettings &InSettings, const FIntVector &Counts, const FVoxelRange &Range);
+
+    // Split a Counts grid into up to ShardsPerAxis pieces per axis (on root cell boundaries in adaptive mode, so
+    // shards do not overlap), in Z-Y-X order
+    static void PlanShards(const FS_VolumeAnalysisSettings &InSettings, const FIntVector &Counts, const FIntVector &ShardsPerAxis, TArray<FS_VolumeAnalysisShard> &OutShards);
+
+    // Game thread: process up to MaxRowsPerStep rows/cells, or as many as fit in TimeBudgetSeconds when > 0
+    // (the row count is then ignored); returns true once the run is complete
+    bool ProcessRowsStep(int32 MaxRowsPerStep, double TimeBudgetSeconds = 0.0);
+
+    // Any thread: run all remaining phases, distributing rows and hidden boxes across worker threads (blocking)
+    void RunParallel();
+
+    // Request cancellation; in-flight rows finish, remaining work is skipped
+    void Cancel() { bCancelled = true; }
+
+    bool IsCancelled() const { return bCancelled; }
+
+    bool IsComplete() const { return bComplete; }
+
+    // Fraction of work units (main-pass rows + hidden boxes) done, 0..1; safe from any thread.
+    // Until the main pass ends every voxel counts as a potential hidden box, so progress never moves backward.
+    float GetProgress() const;
+
+    const FS_VoxelGrid &GetGrid() const { return Grid; }
+
+    // Timing and query counts so far (call before TakeGrid)
+    FS_VolumeAnalysisRunSummary GetRunSummary() const;
+
+    // Move the grid out of a completed run. The per-voxel overlap cache (Flags) is not part of a result: it moves to
+    // OutOverlapCache for a later InitIncremental, or is freed.
+    FS_VoxelGrid TakeGrid(TArray<uint8> *OutOverlapCache = nullptr)
+    {
+        if (OutOverlapCache)
+        {
+            *OutOverlapCache = MoveTemp(Grid.Flags);
+        }
+        Grid.Flags.Empty();
+        return MoveTemp(Grid);
+    }
+
+    // Debug draw, only used while stepping on the game thread
+    FVolumeAnalysisDebugDraw DebugDraw;
+
+private:
+    // Per-step work limit for the game-thread path (row count and/or wall-clock deadline)
+    struct FStepBudget
+    {
+        int32 MaxUnits = MAX_int32;
+        // 0 = no deadline
+        double EndTime = 0.0;
+        double Now = 0.0;
+        int32 UnitsDone = 0;
+
+        // Always allows one unit per step; otherwise stops when the next unit is predicted to overrun
+        bool HasRoomFor(double UnitEstimate) const;
+        // Account one unit started at StartTime and fold its cost into AvgSeconds
+        void Consume(double StartTime, double &AvgSeconds);
+    };
+
+    // Shared by Init/InitIncremental once the grid and flags are in place
+    void ResolveRunSettings();
+    void ResetRunState();
+
+    // Incremental runs only: collect the rows of every phase that cross DirtyRanges
+    void BuildRestrictedRows();
+
+    // FromOrigins: per origin, the grid's bricks ordered by direction so consecutive rays stay coherent
+    void BuildOriginBatches();
+    // Trace from one origin to every free voxel center of one brick (BatchIndex = Origin * NumBricks + order slot)
+    void ProcessOriginBatch(int32 BatchIndex);
+
+    // Whether origin OriginIndex traces to a voxel center at all (inside its frustum and within MaxTraceDistance)
+    bool IsTestedByOrigin(int32 OriginIndex, const FVector &Center) const;
+
+    // Axis scanned by a main-pass phase (-1 stays the pre-pass); phases follow Settings.PhaseOrder
+    int32 GetPhaseAxis(int32 Phase) const { return (Phase >= 0 && Phase < 3) ? PhaseAxes[Phase] : Phase; }
+
+    // Rows in a main-pass phase (-1 = center overlap pre-pass, then the X-rows, Y-rows and Z-columns in phase order)
+    int32 GetPhaseRowCount(int32 Phase) const;
+    void ProcessPhaseRow(int32 Phase, int32 RowIndex);
+
+    // Segmented long-trace scan shared by main-pass rows and sub-sample rows. The policy maps row positions to
+    // centers (and their coordinate along the row, which need not be evenly spaced), issues the traces and marks
+    // reached positions (and may end the scan early).
+    template <int32 Axis>
+    struct TMainRowPolicy;
+    struct FSubSampleBox;
+    template <int32 Axis>
+    struct TSubRowPolicy;
+    template <typename PolicyType>
+    void ScanSegmentedRow(PolicyType &Policy, int32 Count) const;
+
+    // One single-hit trace from position StartI to TargetI: reaches every position up to the hit and returns the last
+    // one covered (TargetI when nothing was hit)
+    template <typename PolicyType>
+    int32 TraceSegment(PolicyType &Policy, int32 StartI, int32 TargetI) const;
+
+    // Main-pass row along Axis (0 = X, 1 = Y, 2 = Z) through RowStart (RowStart[Axis] is ignored)
+    template <int32 Axis>
+    void ScanAxisRow(const FIntVector &RowStart);
+
+    // Collect boxes still hidden after the main pass; completes the run if there is nothing to refine
+    void BeginSubSampling();
+    void ProcessRowsStep_SubSampling(FStepBudget &Budget);
+
+    // Adaptive mode: root cell count and recursive open/solid/mixed classification of a voxel range [Min, Max)
+    FIntVector GetAdaptiveRootCounts() const;
+    void ProcessAdaptiveRoot(int32 RootIndex);
+    void ClassifyAdaptiveNode(const FIntVector &Min, const FIntVector &Max, TArrayView<EE_CenterOverlapState> Scratch);
+    bool IsAdaptiveNodeSolid(const FBox &NodeBox) const;
+
+    // Refine one hidden box using Scratch (SubSampleCount X*Y*Z entries) as its sub-center overlap cache
+    bool RefineHiddenBox(int32 BoxIndex, TArrayView<EE_CenterOverlapState> Scratch);
+
+    // Counted scene queries
+    bool LineTrace(FHitResult &OutHit, const FVector &Start, const FVector &End) const;
+
+    // RowTrace == MultiHit: intervals [Min, Max) of Start->End (as distances from Start) spanned by geometry that blocks
+    // the trace channel, from each blocking shape's first entry (forward multi-hit trace) to its last exit (reverse
+    // trace). Outside them the segment is open; inside them it may still be (a trimesh reports one touch per trace).
+    using FRowIntervals = TArray<TInterval<double>, TInlineAllocator<16>>;
+    void TraceRowIntervals(const FVector &Start, const FVector &End, FRowIntervals &OutSolid) const;
+
+    // Mark the run finished and stamp its end time
+    void MarkComplete();
+
+    // Debug draw helpers (route to DebugDraw.LineBuffer when set)
+    void DrawLine(const FVector &Start, const FVector &End, const FColor &Color, float Thickness) const;
+    // Wireframe of a CountX x CountY x CountZ lattice of cells spanning Box (shared edges drawn once)
+    void DrawLattice(const FBox &Box, int32 CountX, int32 CountY, int32 CountZ, const FColor &Color) const;
+
+    // Raw center overlap query (true if blocking geometry overlaps the sphere at Center)
+    bool TestCenterOverlap(const FVector &Center) const;
+
+    // Memoized center overlap test for a main-grid voxel (queries physics only on first use per run)
+    bool IsVoxelCenterFree(int32 VoxelIndex);
+
+    // Pre-pass with primitives: record the overlap state of every center of one X-row the primitives can decide
+    void ClassifyRowCenters(int32 RowIndex);
+
+    UWorld *World = nullptr;
+    FS_VolumeAnalysisSettings Settings;
+    FCollisionQueryParams QueryParams;
+
+    FS_VoxelGrid Grid;
+    float OverlapRadius = 0.f;
+    bool bAdaptive = false;
+
+    // Settings.bClassifyPrimitiveShapes: shapes gathered for this run and the grid's X centers (shared by all X-rows)
+    FVolumeAnalysisPrimitives Primitives;
+    TArray<double> RowCentersX;
+
+    // FromOrigins mode: phase 0 runs one batch per (origin, brick) instead of the axis scans
+    struct FOriginRays
+    {
+        FVector Location = FVector::ZeroVector;
+        FQuat InvRotation = FQuat::Identity;
+        double TanHalfFovX = 0.0;
+        double TanHalfFovY = 0.0;
+        bool bFrustum = false;
+        // Brick indices sorted by direction from Location
+        TArray<int32> BrickOrder;
+
+        bool IsInView(const FVector &Point) const;
+    };
+    static constexpr int32 OriginBrickSize = 8;
+    bool bFromOrigins = false;
+    TArray<FOriginRays> OriginRays;
+    FIntVector OriginBrickCounts = FIntVector::ZeroValue;
+
+    // Main-pass multi-axis scan state
+    // Phase -1 = center overlap pre-pass and/or primitive classification (optional, CountY * CountZ rows of voxels)
+    // Phase 0 = X-rows (CountY * CountZ)
+    // Phase 1 = Y-rows (CountX * CountZ)
+    // Phase 2 = Z-columns (CountX * CountY)
+    // (in Fixed order; PhaseAxes reorders phases 0..2 for LongestAxisFirst)
+    // Adaptive mode runs a single phase 0 over octree root cells instead
+    int32 CurrentPhase = 0;
+    int32 CurrentPhaseRowIndex = 0;
+    // Axis (0 = X-rows, 1 = Y-rows, 2 = Z-columns) run by each of phases 0..2
+    int32 PhaseAxes[3] = {0, 1, 2};
+
+    // Incremental run state: voxel ranges that were reset and the row indices to scan per phase (slot = Phase + 1)
+    bool bRestricted = false;
+    TArray<FVoxelRange> DirtyRanges;
+    TArray<int32> RestrictedRows[4];
+
+    // Sub-sampling phase state
+    bool bIsSubSampling = false;
+    TArray<int32> HiddenBoxIndices;
+    int32 CurrentHiddenIndex = 0;
+    TArray<EE_CenterOverlapState> SubCenterCache;
+
+    // Per-ray debug draw is only legal on the game thread
+    bool bCanDebugDraw = false;
+
+    // Smoothed cost of one main-pass row / one hidden box refinement, used to stop before overrunning a time budget
+    double AvgRowSeconds = 0.0;
+    double AvgRefineSeconds = 0.0;
+
+    int32 MainPassWork = 0;
+    std::atomic<int32> TotalWork{0};
+    std::atomic<int32> CompletedWork{0};
+
+    // Query counters for the run summary (relaxed; only read once the run is over)
+    mutable std::atomic<int64> NumLineTraces{0};
+    mutable std::atomic<int64> NumSweeps{0};
+    mutable std::atomic<int64> NumOverlapCacheHits{0};
+    double RunStartSeconds = 0.0;
+    double RunEndSeconds = 0.0;
+
+    std::atomic<bool> bCancelled{false};
+    std::atomic<bool> bComplete{false};
+};
@@ -0,0 +1,317 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#include "CPP_EN__VolumeAnalysisPrimitives.h"
+#include "Engine/World.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/StaticMesh.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Algo/BinarySearch.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+namespace
+{
+    constexpr uint8 LaneBlocked = 1 << 0;
+    constexpr uint8 LaneNeedsSweep = 1 << 1;
+}
+
+void FVolumeAnalysisPrimitives::Reset()
+{
+    Shapes.Reset();
+    Planes.Reset();
+    ComplexBounds.Reset();
+    OverlapRadius = 0.0;
+    bActive = false;
+}
+
+void FVolumeAnalysisPrimitives::Gather(const UWorld &World, const FBox &Volume, ECollisionChannel Channel, const FCollisionQueryParams &QueryParams, double InOverlapRadius)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FVolumeAnalysisPrimitives::Gather);
+    Reset();
+    OverlapRadius = InOverlapRadius;
+
+    // Any blocker touching a center sphere overlaps this box, so nothing outside the results can block a center
+    const FBox QueryBox = Volume.ExpandBy(OverlapRadius);
+    TArray<FOverlapResult> Overlaps;
+    World.OverlapMultiByChannel(Overlaps, QueryBox.GetCenter(), FQuat::Identity, Channel, FCollisionShape::MakeBox(QueryBox.GetExtent()), QueryParams);
+
+    TSet<TPair<const UPrimitiveComponent *, int32>> Seen;
+    for (const FOverlapResult &Overlap : Overlaps)
+    {
+        UPrimitiveComponent *Component = Overlap.GetComponent();
+        // The sweep only reports blocking hits
+        if (!Component || !Overlap.bBlockingHit)
+        {
+            continue;
+        }
+        const UInstancedStaticMeshComponent *Instanced = Cast<UInstancedStaticMeshComponent>(Component);
+        bool bAlreadySeen = false;
+        Seen.Add(TPair<const UPrimitiveComponent *, int32>(Component, Instanced ? Overlap.ItemIndex : INDEX_NONE), &bAlreadySeen);
+        if (bAlreadySeen)
+        {
+            continue;
+        }
+
+        FTransform BodyTM = Component->GetComponentTransform();
+        const bool bHasBodyTM = !Instanced || Instanced->GetInstanceTransform(Overlap.ItemIndex, BodyTM, /*bWorldSpace*/ true);
+        const UBodySetup *BodySetup = Component->GetBodySetup();
+        if (bHasBodyTM && BodySetup && !Component->IsA<USkinnedMeshComponent>() && AddBody(*Component, *BodySetup, BodyTM, QueryParams.bTraceComplex))
+        {
+            continue;
+        }
+        FBox Bounds = Component->Bounds.GetBox();
+        if (bHasBodyTM && Instanced && Instanced->GetStaticMesh())
+        {
+            Bounds = Instanced->GetStaticMesh()->GetBounds().GetBox().TransformBy(BodyTM);
+        }
+        ComplexBounds.Add(Bounds.ExpandBy(OverlapRadius));
+    }
+    bActive = true;
+}
+
+bool FVolumeAnalysisPrimitives::AddBody(const UPrimitiveComponent &Component, const UBodySetup &BodySetup, const FTransform &BodyTM, bool bTraceComplex)
+{
+    const FKAggregateGeom &Geom = BodySetup.AggGeom;
+    const int32 NumElems = Geom.BoxElems.Num() + Geom.SphereElems.Num() + Geom.SphylElems.Num() + Geom.ConvexElems.Num();
+    // Triangle meshes traced as complex collision (and tapered capsules, level sets, ...) are left to the sweep
+    const ECollisionTraceFlag TraceFlag = BodySetup.GetCollisionTraceFlag();
+    const bool bComplex = TraceFlag == CTF_UseComplexAsSimple || (bTraceComplex && TraceFlag != CTF_UseSimpleAsComplex && Component.IsA<UStaticMeshComponent>());
+    if (NumElems == 0 || NumElems != Geom.GetElementCount() || bComplex)
+    {
+        return false;
+    }
+
+    // Non-uniform scale shears rotated elements, and capsules do not stay capsules under it
+    const FVector Scale = BodyTM.GetScale3D().GetAbs();
+    const bool bUniform = Scale.AllComponentsEqual(KINDA_SMALL_NUMBER);
+    const FQuat BodyRotation = BodyTM.GetRotation();
+    const FVector Reach(OverlapRadius);
+    TArray<FShape, TInlineAllocator<8>> NewShapes;
+    TArray<FPlane, TInlineAllocator<32>> NewPlanes;
+
+    for (const FKBoxElem &Elem : Geom.BoxElems)
+    {
+        if (!bUniform && !Elem.Rotation.IsNearlyZero())
+        {
+            return false;
+        }
+        const FQuat Rotation = BodyRotation * Elem.Rotation.Quaternion();
+        FShape &Shape = NewShapes.AddDefaulted_GetRef();
+        Shape.Kind = EShapeKind::Box;
+        Shape.Center = BodyTM.TransformPosition(Elem.Center);
+        Shape.AxisX = Rotation.GetAxisX();
+        Shape.AxisY = Rotation.GetAxisY();
+        Shape.AxisZ = Rotation.GetAxisZ();
+        Shape.HalfExtent = 0.5 * FVector(Elem.X, Elem.Y, Elem.Z) * Scale;
+        const FVector Extent = Shape.AxisX.GetAbs() * Shape.HalfExtent.X + Shape.AxisY.GetAbs() * Shape.HalfExtent.Y + Shape.AxisZ.GetAbs() * Shape.HalfExtent.Z + Reach;
+        Shape.Bounds = FBox(Shape.Center - Extent, Shape.Center + Extent);
+    }
+    for (const FKSphereElem &Elem : Geom.SphereElems)
+    {
+        FShape &Shape = NewShapes.AddDefaulted_GetRef();
+        Shape.Kind = EShapeKind::Sphere;
+        Shape.Center = BodyTM.TransformPosition(Elem.Center);
+        // Physics keeps spheres round by using the smallest scale
+        const double Radius = Elem.Radius * Scale.GetMin() + OverlapRadius;
+        Shape.ReachSq = FMath::Square(Radius);
+        Shape.Bounds = FBox(Shape.Center - FVector(Radius), Shape.Center + FVector(Radius));
+    }
+    for (const FKSphylElem &Elem : Geom.SphylElems)
+    {
+        if (!bUniform)
+        {
+            return false;
+        }
+        FShape &Shape = NewShapes.AddDefaulted_GetRef();
+        Shape.Kind = EShapeKind::Capsule;
+        Shape.Center = BodyTM.TransformPosition(Elem.Center);
+        Shape.AxisZ = (BodyRotation * Elem.Rotation.Quaternion()).GetAxisZ();
+        Shape.HalfLength = 0.5 * Elem.Length * Scale.X;
+        const double Radius = Elem.Radius * Scale.X + OverlapRadius;
+        Shape.ReachSq = FMath::Square(Radius);
+        const FVector Extent = Shape.AxisZ.GetAbs() * Shape.HalfLength + FVector(Radius);
+        Shape.Bounds = FBox(Shape.Center - Extent, Shape.Center + Extent);
+    }
+    for (const FKConvexElem &Elem : Geom.ConvexElems)
+    {
+        TArray<FPlane> LocalPlanes;
+        Elem.GetPlanes(LocalPlanes);
+        if (LocalPlanes.Num() == 0)
+        {
+            // Not cooked
+            return false;
+        }
+        const FTransform ElemTM = Elem.GetTransform() * BodyTM;
+        const FMatrix ElemMatrix = ElemTM.ToMatrixWithScale();
+        FShape &Shape = NewShapes.AddDefaulted_GetRef();
+        Shape.Kind = EShapeKind::Convex;
+        Shape.Bounds = Elem.ElemBox.TransformBy(ElemTM).ExpandBy(OverlapRadius);
+        Shape.FirstPlane = NewPlanes.Num();
+        Shape.NumPlanes = LocalPlanes.Num();
+        for (const FPlane &LocalPlane : LocalPlanes)
+        {
+            const FPlane WorldPlane = LocalPlane.TransformBy(ElemMatrix);
+            const double Length = WorldPlane.GetNormal().Size();
+            if (Length <= UE_SMALL_NUMBER)
+            {
+                return false;
+            }
+            NewPlanes.Add(FPlane(WorldPlane.GetNormal() / Length, WorldPlane.W / Length));
+        }
+    }
+
+    for (FShape &Shape : NewShapes)
+    {
+        Shape.FirstPlane += Planes.Num();
+    }
+    Shapes.Append(NewShapes);
+    Planes.Append(NewPlanes);
+    return true;
+}
+
+void FVolumeAnalysisPrimitives::ClassifyLanes(const FShape &Shape, const double *X, int32 Begin, int32 End, double Y, double Z, uint8 *LaneBits) const
+{
+    // Structure of arrays: four X lanes per register, Y and Z are shared by the row and folded into scalar terms
+    const double DY = Y - Shape.Center.Y;
+    const double DZ = Z - Shape.Center.Z;
+    const VectorRegister4Double Zero = VectorZeroDouble();
+    const VectorRegister4Double CenterX = VectorSetFloat1(Shape.Center.X);
+    const VectorRegister4Double ReachSq = VectorSetFloat1(Shape.ReachSq);
+    const VectorRegister4Double RadiusSq = VectorSetFloat1(FMath::Square(OverlapRadius));
+
+    // Axis . (P - Center) per lane
+    const auto Project = [DY, DZ](const FVector &Axis, const VectorRegister4Double &DX)
+    {
+        return VectorMultiplyAdd(VectorSetFloat1(Axis.X), DX, VectorSetFloat1(Axis.Y * DY + Axis.Z * DZ));
+    };
+
+    for (int32 i = Begin; i < End; i += 4)
+    {
+        // The tail repeats the last center; the bits of the extra lanes are dropped
+        const int32 NumLanes = FMath::Min(4, End - i);
+        VectorRegister4Double PX;
+        if (NumLanes == 4)
+        {
+            PX = VectorLoad(X + i);
+        }
+        else
+        {
+            double Tail[4];
+            for (int32 k = 0; k < 4; ++k)
+            {
+                Tail[k] = X[i + FMath::Min(k, NumLanes - 1)];
+            }
+            PX = VectorLoad(Tail);
+        }
+        const VectorRegister4Double DX = VectorSubtract(PX, CenterX);
+
+        int32 Blocked = 0;
+        int32 NeedsSweep = 0;
+        switch (Shape.Kind)
+        {
+        case EShapeKind::Box:
+        {
+            // Squared distance from the point to the box: length of the per-axis excess over the half extent
+            const VectorRegister4Double QX = VectorMax(VectorSubtract(VectorAbs(Project(Shape.AxisX, DX)), VectorSetFloat1(Shape.HalfExtent.X)), Zero);
+            const VectorRegister4Double QY = VectorMax(VectorSubtract(VectorAbs(Project(Shape.AxisY, DX)), VectorSetFloat1(Shape.HalfExtent.Y)), Zero);
+            const VectorRegister4Double QZ = VectorMax(VectorSubtract(VectorAbs(Project(Shape.AxisZ, DX)), VectorSetFloat1(Shape.HalfExtent.Z)), Zero);
+            const VectorRegister4Double DistSq = VectorMultiplyAdd(QX, QX, VectorMultiplyAdd(QY, QY, VectorMultiply(QZ, QZ)));
+            Blocked = VectorMaskBits(VectorCompareLE(DistSq, RadiusSq));
+            break;
+        }
+        case EShapeKind::Sphere:
+        {
+            const VectorRegister4Double DistSq = VectorMultiplyAdd(DX, DX, VectorSetFloat1(DY * DY + DZ * DZ));
+            Blocked = VectorMaskBits(VectorCompareLE(DistSq, ReachSq));
+            break;
+        }
+        case EShapeKind::Capsule:
+        {
+            // Distance to the segment: perpendicular part plus the overshoot past either end
+            const VectorRegister4Double T = Project(Shape.AxisZ, DX);
+            const VectorRegister4Double Clamped = VectorMin(VectorMax(T, VectorSetFloat1(-Shape.HalfLength)), VectorSetFloat1(Shape.HalfLength));
+            const VectorRegister4Double Over = VectorSubtract(T, Clamped);
+            const VectorRegister4Double PerpSq = VectorSubtract(VectorMultiplyAdd(DX, DX, VectorSetFloat1(DY * DY + DZ * DZ)), VectorMultiply(T, T));
+            const VectorRegister4Double DistSq = VectorMultiplyAdd(Over, Over, PerpSq);
+            Blocked = VectorMaskBits(VectorCompareLE(DistSq, ReachSq));
+            break;
+        }
+        case EShapeKind::Convex:
+        {
+            // Largest plane distance: <= 0 inside, > radius clear of the hull; in between depends on edges and corners
+            VectorRegister4Double MaxDist = VectorSetFloat1(-UE_BIG_NUMBER);
+            for (int32 p = Shape.FirstPlane; p < Shape.FirstPlane + Shape.NumPlanes; ++p)
+            {
+                const FPlane &Plane = Planes[p];
+                MaxDist = VectorMax(MaxDist, VectorMultiplyAdd(VectorSetFloat1(Plane.X), PX, VectorSetFloat1(Plane.Y * Y + Plane.Z * Z - Plane.W)));
+            }
+            Blocked = VectorMaskBits(VectorCompareLE(MaxDist, Zero));
+            NeedsSweep = VectorMaskBits(VectorCompareLE(MaxDist, VectorSetFloat1(OverlapRadius))) & ~Blocked;
+            break;
+        }
+        }
+
+        for (int32 k = 0; k < NumLanes; ++k)
+        {
+            LaneBits[i + k] |= (((Blocked >> k) & 1) ? LaneBlocked : 0) | (((NeedsSweep >> k) & 1) ? LaneNeedsSweep : 0);
+        }
+    }
+}
+
+void FVolumeAnalysisPrimitives::ClassifyRow(TConstArrayView<double> X, double Y, double Z, TArrayView<EE_CenterOverlapState> OutStates) const
+{
+    check(OutStates.Num() == X.Num());
+    TArray<uint8, TInlineAllocator<512>> LaneBits;
+    LaneBits.SetNumZeroed(X.Num());
+
+    // Lanes whose centers lie inside Bounds
+    const auto LaneRange = [X, Y, Z](const FBox &Bounds, int32 &OutBegin, int32 &OutEnd)
+    {
+        if (Y < Bounds.Min.Y || Y > Bounds.Max.Y || Z < Bounds.Min.Z || Z > Bounds.Max.Z)
+        {
+            return false;
+        }
+        OutBegin = Algo::LowerBound(X, Bounds.Min.X);
+        OutEnd = Algo::UpperBound(X, Bounds.Max.X);
+        return OutBegin < OutEnd;
+    };
+
+    int32 Begin = 0;
+    int32 End = 0;
+    for (const FBox &Bounds : ComplexBounds)
+    {
+        if (LaneRange(Bounds, Begin, End))
+        {
+            for (int32 i = Begin; i < End; ++i)
+            {
+                LaneBits[i] |= LaneNeedsSweep;
+            }
+        }
+    }
+    for (const FShape &Shape : Shapes)
+    {
+        if (LaneRange(Shape.Bounds, Begin, End))
+        {
+            ClassifyLanes(Shape, X.GetData(), Begin, End, Y, Z, LaneBits.GetData());
+        }
+    }
+
+    // Any blocking shape decides; otherwise a nearby shape that could not be resolved here needs the sweep
+    for (int32 i = 0; i < X.Num(); ++i)
+    {
+        OutStates[i] = (LaneBits[i] & LaneBlocked) ? EE_CenterOverlapState::Blocked : ((LaneBits[i] & LaneNeedsSweep) ? EE_CenterOverlapState::Unknown : EE_CenterOverlapState::Free);
+    }
+}
+
+EE_CenterOverlapState FVolumeAnalysisPrimitives::Classify(const FVector &Point) const
+{
+    EE_CenterOverlapState State = EE_CenterOverlapState::Unknown;
+    ClassifyRow(TConstArrayView<double>(&Point.X, 1), Point.Y, Point.Z, TArrayView<EE_CenterOverlapState>(&State, 1));
+    return State;
+}
@@ -0,0 +1,86 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "CollisionQueryParams.h"
+#include "CPP_ST__VolumeAnalysisGrid.h"
+
+class UWorld;
+class UPrimitiveComponent;
+class UBodySetup;
+
+/**
+ * In-memory stand-in for the center overlap sweep. Blocking boxes, spheres, capsules and convex hulls overlapping the
+ * volume are gathered once per run and voxel centers are classified against them four at a time (VectorRegister4Double,
+ * SSE/AVX/NEON). Everything else (meshes traced complex, landscapes, skeletal bodies, sheared elements) is kept as a
+ * bounding box: centers inside it stay Unknown and are left to the physics sweep.
+ * Read-only after Gather, so any number of worker threads may classify concurrently.
+ */
+class P_VOLUMEANALYSIS_API FVolumeAnalysisPrimitives
+{
+public:
+    // Collect what blocks Channel inside Volume (grown by the overlap radius) with the same rules as the sweep
+    void Gather(const UWorld &World, const FBox &Volume, ECollisionChannel Channel, const FCollisionQueryParams &QueryParams, double InOverlapRadius);
+
+    void Reset();
+
+    // False when there is nothing to classify against (the sweep is used as before)
+    bool IsActive() const { return bActive; }
+
+    int32 GetNumShapes() const { return Shapes.Num(); }
+
+    int32 GetNumComplexBounds() const { return ComplexBounds.Num(); }
+
+    // Centers (X[i], Y, Z) for a row of ascending X; OutStates must hold X.Num() entries
+    void ClassifyRow(TConstArrayView<double> X, double Y, double Z, TArrayView<EE_CenterOverlapState> OutStates) const;
+
+    // One point; Unknown when it is near geometry that needs the sweep
+    EE_CenterOverlapState Classify(const FVector &Point) const;
+
+private:
+    enum class EShapeKind : uint8
+    {
+        Box,
+        Sphere,
+        Capsule,
+        Convex
+    };
+
+    struct FShape
+    {
+        EShapeKind Kind = EShapeKind::Box;
+        // Shape bounds grown by the overlap radius; centers outside cannot touch it
+        FBox Bounds = FBox(ForceInit);
+        FVector Center = FVector::ZeroVector;
+        // Box: rows of the world-to-local rotation; Capsule: AxisZ is the segment direction
+        FVector AxisX = FVector::XAxisVector;
+        FVector AxisY = FVector::YAxisVector;
+        FVector AxisZ = FVector::ZAxisVector;
+        FVector HalfExtent = FVector::ZeroVector;
+        // Sphere/Capsule: (shape radius + overlap radius)^2
+        double ReachSq = 0.0;
+        // Capsule: half the segment length
+        double HalfLength = 0.0;
+        // Convex: outward unit planes in Planes
+        int32 FirstPlane = 0;
+        int32 NumPlanes = 0;
+    };
+
+    // Blocking simple elements of one body at BodyTM; false if the body needs the sweep
+    bool AddBody(const UPrimitiveComponent &Component, const UBodySetup &BodySetup, const FTransform &BodyTM, bool bTraceComplex);
+
+    // Per-lane bit 0 = blocked, bit 1 = needs the sweep, for lanes [Begin, End) of one row
+    void ClassifyLanes(const FShape &Shape, const double *X, int32 Begin, int32 End, double Y, double Z, uint8 *LaneBits) const;
+
+    TArray<FShape> Shapes;
+    TArray<FPlane> Planes;
+    TArray<FBox> ComplexBounds;
+    double OverlapRadius = 0.0;
+    bool bActive = false;
+};
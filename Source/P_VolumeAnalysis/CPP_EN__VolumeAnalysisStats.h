@@ -0,0 +1,33 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+// "stat VolumeAnalysis" in the console; scopes also show up in Unreal Insights CPU tracks
+DECLARE_STATS_GROUP(TEXT("VolumeAnalysis"), STATGROUP_VolumeAnalysis, STATCAT_Advanced);
+
+// Cycle counters per phase
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Overlap Pre-Pass"), STAT_PVol_PrePass, STATGROUP_VolumeAnalysis, P_VOLUMEANALYSIS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Scan X Rows"), STAT_PVol_ScanX, STATGROUP_VolumeAnalysis, P_VOLUMEANALYSIS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Scan Y Rows"), STAT_PVol_ScanY, STATGROUP_VolumeAnalysis, P_VOLUMEANALYSIS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Scan Z Columns"), STAT_PVol_ScanZ, STATGROUP_VolumeAnalysis, P_VOLUMEANALYSIS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Adaptive Cells"), STAT_PVol_Adaptive, STATGROUP_VolumeAnalysis, P_VOLUMEANALYSIS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Origin Rays"), STAT_PVol_OriginRays, STATGROUP_VolumeAnalysis, P_VOLUMEANALYSIS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Center Overlap Tests"), STAT_PVol_OverlapTest, STATGROUP_VolumeAnalysis, P_VOLUMEANALYSIS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Gather Primitives"), STAT_PVol_GatherPrimitives, STATGROUP_VolumeAnalysis, P_VOLUMEANALYSIS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Sub-Sampling"), STAT_PVol_SubSampling, STATGROUP_VolumeAnalysis, P_VOLUMEANALYSIS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Finalize"), STAT_PVol_Finalize, STATGROUP_VolumeAnalysis, P_VOLUMEANALYSIS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Debug Draw"), STAT_PVol_DebugDraw, STATGROUP_VolumeAnalysis, P_VOLUMEANALYSIS_API);
+
+// Scene queries issued per frame
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Line Traces"), STAT_PVol_LineTraces, STATGROUP_VolumeAnalysis, P_VOLUMEANALYSIS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Overlap Sweeps"), STAT_PVol_Sweeps, STATGROUP_VolumeAnalysis, P_VOLUMEANALYSIS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Overlap Cache Hits"), STAT_PVol_OverlapCacheHits, STATGROUP_VolumeAnalysis, P_VOLUMEANALYSIS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Primitive Center Tests"), STAT_PVol_PrimitiveTests, STATGROUP_VolumeAnalysis, P_VOLUMEANALYSIS_API);
@@ -0,0 +1,402 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#include "CPP_IO__VolumeAnalysisBinary.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/Compression.h"
+#include "Misc/Crc.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPVolBinary, Log, All);
+
+static void SerializeVector(FArchive &Ar, FVector &V)
+{
+	// Always doubles, independent of the archive's large-world-coordinate versioning
+	double X = V.X, Y = V.Y, Z = V.Z;
+	Ar << X << Y << Z;
+	V = FVector(X, Y, Z);
+}
+
+bool FVolumeAnalysisBinaryHeader::IsValid() const
+{
+	if (FileMagic != Magic || Version == 0 || Version > CurrentVersion)
+	{
+		return false;
+	}
+	if (CountX <= 0 || CountY <= 0 || CountZ <= 0 || GetNumVoxels() > MAX_int32)
+	{
+		return false;
+	}
+	if (NumWords != FMath::DivideAndRoundUp(static_cast<int32>(GetNumVoxels()), 32) || PayloadSize <= 0 || PayloadSize > MAX_int32)
+	{
+		return false;
+	}
+	if ((HasMasks() && Version < 2) || (HasEdges() && Version < 3))
+	{
+		return false;
+	}
+	return IsCompressed() || PayloadSize == int64(NumWords) * sizeof(uint32);
+}
+
+void FVolumeAnalysisBinaryHeader::Serialize(FArchive &Ar)
+{
+	const int64 Start = Ar.Tell();
+	Ar << FileMagic << Version << Flags;
+	SerializeVector(Ar, Origin);
+	SerializeVector(Ar, CellSize);
+	Ar << CountX << CountY << CountZ << NumWords << PayloadSize << BitsCrc << MasksCrc << EdgesCrc;
+
+	// Zero padding up to the fixed header size keeps the payload aligned and leaves room for future fields
+	uint8 Pad[HeaderSize] = {};
+	const int64 Used = Ar.Tell() - Start;
+	check(Used <= HeaderSize);
+	Ar.Serialize(Pad, HeaderSize - Used);
+}
+
+// Every axis's Count + 1 boundaries, X then Y then Z (uniform axes included, so readers need no special case)
+static void GatherAxisEdges(const FS_VoxelGrid &Grid, TArray<double> &OutEdges)
+{
+	const FIntVector Counts(Grid.CountX, Grid.CountY, Grid.CountZ);
+	OutEdges.Reset(Counts.X + Counts.Y + Counts.Z + 3);
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		for (int32 I = 0; I <= Counts[Axis]; ++I)
+		{
+			OutEdges.Add(Grid.GetEdge(Axis, I));
+		}
+	}
+}
+
+// Give a grid whose origin and counts are set the stored boundaries; false if they do not describe its extent
+static bool ApplyAxisEdges(FS_VoxelGrid &Grid, const double *Edges)
+{
+	const FIntVector Counts(Grid.CountX, Grid.CountY, Grid.CountZ);
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		// The header stores the smallest cell; SetAxisEdges checks the edges against the even spacing of the extent
+		Grid.CellSize[Axis] = (Edges[Counts[Axis]] - Edges[0]) / Counts[Axis];
+		if (!Grid.SetAxisEdges(Axis, TArray<double>(Edges, Counts[Axis] + 1)))
+		{
+			return false;
+		}
+		Edges += Counts[Axis] + 1;
+	}
+	return true;
+}
+
+bool FVolumeAnalysisBinary::SaveToFile(const FS_VoxelGrid &Grid, const FString &FilePath, bool bCompress)
+{
+	if (!Grid.IsValid() || Grid.VisibilityBits.Num() != FMath::DivideAndRoundUp(Grid.Num(), 32))
+	{
+		UE_LOG(LogPVolBinary, Warning, TEXT("SaveToFile: Grid is empty or inconsistent"));
+		return false;
+	}
+
+	FVolumeAnalysisBinaryHeader Header;
+	Header.Origin = Grid.Origin;
+	Header.CellSize = Grid.CellSize;
+	Header.CountX = Grid.CountX;
+	Header.CountY = Grid.CountY;
+	Header.CountZ = Grid.CountZ;
+	Header.NumWords = Grid.VisibilityBits.Num();
+	const int32 RawSize = Header.NumWords * sizeof(uint32);
+	Header.BitsCrc = FCrc::MemCrc32(Grid.VisibilityBits.GetData(), RawSize);
+
+	const uint8 *Payload = reinterpret_cast<const uint8 *>(Grid.VisibilityBits.GetData());
+	Header.PayloadSize = RawSize;
+	TArray<uint8> Compressed;
+	if (bCompress)
+	{
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, RawSize);
+		Compressed.SetNumUninitialized(CompressedSize);
+		if (FCompression::CompressMemory(NAME_Zlib, Compressed.GetData(), CompressedSize, Payload, RawSize) && CompressedSize < RawSize)
+		{
+			Header.Flags |= FVolumeAnalysisBinaryHeader::Compressed;
+			Header.PayloadSize = CompressedSize;
+			Payload = Compressed.GetData();
+		}
+		// Otherwise store raw; incompressible data is not worth the decode cost
+	}
+	if (Grid.HasOriginMasks())
+	{
+		Header.Flags |= FVolumeAnalysisBinaryHeader::HasOriginMasks;
+		Header.MasksCrc = FCrc::MemCrc32(Grid.OriginMasks.GetData(), Grid.OriginMasks.Num());
+	}
+	TArray<double> Edges;
+	if (!Grid.IsUniform())
+	{
+		GatherAxisEdges(Grid, Edges);
+		Header.Flags |= FVolumeAnalysisBinaryHeader::HasAxisEdges;
+		Header.EdgesCrc = FCrc::MemCrc32(Edges.GetData(), Edges.Num() * sizeof(double));
+	}
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(FilePath), /*Tree*/ true);
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!Writer)
+	{
+		UE_LOG(LogPVolBinary, Warning, TEXT("SaveToFile: Could not open '%s' for writing"), *FilePath);
+		return false;
+	}
+	Header.Serialize(*Writer);
+	Writer->Serialize(const_cast<uint8 *>(Payload), Header.PayloadSize);
+	if (Header.HasMasks())
+	{
+		Writer->Serialize(const_cast<uint8 *>(Grid.OriginMasks.GetData()), Header.GetOriginMaskSize());
+	}
+	if (Header.HasEdges())
+	{
+		Writer->Serialize(Edges.GetData(), Edges.Num() * sizeof(double));
+	}
+	return Writer->Close();
+}
+
+// Decode a payload into Words (Header.NumWords entries) and verify its CRC
+static bool DecodePayload(const FVolumeAnalysisBinaryHeader &Header, const uint8 *Payload, uint32 *Words)
+{
+	const int32 RawSize = Header.NumWords * sizeof(uint32);
+	if (Header.IsCompressed())
+	{
+		if (!FCompression::UncompressMemory(NAME_Zlib, Words, RawSize, Payload, static_cast<int32>(Header.PayloadSize)))
+		{
+			return false;
+		}
+	}
+	else if (Payload != reinterpret_cast<const uint8 *>(Words))
+	{
+		FMemory::Memcpy(Words, Payload, RawSize);
+	}
+	return FCrc::MemCrc32(Words, RawSize) == Header.BitsCrc;
+}
+
+bool FVolumeAnalysisBinary::ReadHeader(const FString &FilePath, FVolumeAnalysisBinaryHeader &OutHeader)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+	if (!Reader || Reader->TotalSize() < FVolumeAnalysisBinaryHeader::HeaderSize)
+	{
+		return false;
+	}
+	OutHeader.Serialize(*Reader);
+	return OutHeader.IsValid() && Reader->TotalSize() >= OutHeader.GetFileSize();
+}
+
+bool FVolumeAnalysisBinary::LoadFromFile(const FString &FilePath, FS_VoxelGrid &OutGrid)
+{
+	OutGrid.Reset();
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+	if (!Reader || Reader->TotalSize() < FVolumeAnalysisBinaryHeader::HeaderSize)
+	{
+		UE_LOG(LogPVolBinary, Warning, TEXT("LoadFromFile: Could not open '%s'"), *FilePath);
+		return false;
+	}
+
+	FVolumeAnalysisBinaryHeader Header;
+	Header.Serialize(*Reader);
+	if (!Header.IsValid() || Reader->TotalSize() < Header.GetFileSize())
+	{
+		UE_LOG(LogPVolBinary, Warning, TEXT("LoadFromFile: '%s' is not a valid volume analysis binary (or is truncated)"), *FilePath);
+		return false;
+	}
+
+	OutGrid.Origin = Header.Origin;
+	OutGrid.CellSize = Header.CellSize;
+	OutGrid.CountX = Header.CountX;
+	OutGrid.CountY = Header.CountY;
+	OutGrid.CountZ = Header.CountZ;
+	OutGrid.VisibilityBits.SetNumUninitialized(Header.NumWords);
+
+	bool bOk;
+	if (Header.IsCompressed())
+	{
+		TArray<uint8> Payload;
+		Payload.SetNumUninitialized(static_cast<int32>(Header.PayloadSize));
+		Reader->Serialize(Payload.GetData(), Header.PayloadSize);
+		bOk = !Reader->IsError() && DecodePayload(Header, Payload.GetData(), OutGrid.VisibilityBits.GetData());
+	}
+	else
+	{
+		// Raw payload: read straight into the grid's storage
+		Reader->Serialize(OutGrid.VisibilityBits.GetData(), Header.PayloadSize);
+		bOk = !Reader->IsError() && DecodePayload(Header, reinterpret_cast<const uint8 *>(OutGrid.VisibilityBits.GetData()), OutGrid.VisibilityBits.GetData());
+	}
+	if (bOk && Header.HasMasks())
+	{
+		OutGrid.OriginMasks.SetNumUninitialized(static_cast<int32>(Header.GetOriginMaskSize()));
+		Reader->Serialize(OutGrid.OriginMasks.GetData(), Header.GetOriginMaskSize());
+		bOk = !Reader->IsError() && FCrc::MemCrc32(OutGrid.OriginMasks.GetData(), OutGrid.OriginMasks.Num()) == Header.MasksCrc;
+	}
+	if (bOk && Header.HasEdges())
+	{
+		TArray<double> Edges;
+		Edges.SetNumUninitialized(Header.GetNumAxisEdges());
+		Reader->Serialize(Edges.GetData(), Edges.Num() * sizeof(double));
+		bOk = !Reader->IsError() && FCrc::MemCrc32(Edges.GetData(), Edges.Num() * sizeof(double)) == Header.EdgesCrc && ApplyAxisEdges(OutGrid, Edges.GetData());
+	}
+	if (!bOk)
+	{
+		UE_LOG(LogPVolBinary, Warning, TEXT("LoadFromFile: '%s' payload is corrupt"), *FilePath);
+		OutGrid.Reset();
+	}
+	return bOk;
+}
+
+FVolumeAnalysisMappedGrid::FVolumeAnalysisMappedGrid() = default;
+
+FVolumeAnalysisMappedGrid::~FVolumeAnalysisMappedGrid()
+{
+	Close();
+}
+
+bool FVolumeAnalysisMappedGrid::Open(const FString &FilePath)
+{
+	Close();
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FilePath));
+	if (MappedFile && MappedFile->GetFileSize() >= FVolumeAnalysisBinaryHeader::HeaderSize)
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	}
+	if (!MappedRegion)
+	{
+		// Not mappable here: read it into owned buffers (LoadFromFile verifies the CRCs)
+		MappedFile.Reset();
+		FS_VoxelGrid Loaded;
+		if (!FVolumeAnalysisBinary::ReadHeader(FilePath, Header) || !FVolumeAnalysisBinary::LoadFromFile(FilePath, Loaded))
+		{
+			UE_LOG(LogPVolBinary, Warning, TEXT("MappedGrid: Could not read '%s'"), *FilePath);
+			Close();
+			return false;
+		}
+		OwnedBits = MoveTemp(Loaded.VisibilityBits);
+		OwnedMasks = MoveTemp(Loaded.OriginMasks);
+		if (!Loaded.IsUniform())
+		{
+			GatherAxisEdges(Loaded, Edges);
+		}
+		Bits = OwnedBits.GetData();
+		Masks = OwnedMasks.Num() > 0 ? OwnedMasks.GetData() : nullptr;
+		return true;
+	}
+
+	const uint8 *Data = MappedRegion->GetMappedPtr();
+	FMemoryReaderView HeaderReader(TArrayView<const uint8>(Data, FVolumeAnalysisBinaryHeader::HeaderSize));
+	Header.Serialize(HeaderReader);
+	if (!Header.IsValid() || MappedFile->GetFileSize() < Header.GetFileSize())
+	{
+		UE_LOG(LogPVolBinary, Warning, TEXT("MappedGrid: '%s' is not a valid volume analysis binary (or is truncated)"), *FilePath);
+		Close();
+		return false;
+	}
+
+	const uint8 *Payload = Data + FVolumeAnalysisBinaryHeader::HeaderSize;
+	const uint8 *MaskData = Header.HasMasks() ? Payload + Header.PayloadSize : nullptr;
+	if (MaskData && FCrc::MemCrc32(MaskData, static_cast<int32>(Header.GetOriginMaskSize())) != Header.MasksCrc)
+	{
+		UE_LOG(LogPVolBinary, Warning, TEXT("MappedGrid: '%s' origin masks are corrupt"), *FilePath);
+		Close();
+		return false;
+	}
+	if (Header.HasEdges())
+	{
+		const uint8 *EdgeData = Payload + Header.PayloadSize + Header.GetOriginMaskSize();
+		const int32 EdgeBytes = Header.GetNumAxisEdges() * sizeof(double);
+		if (FCrc::MemCrc32(EdgeData, EdgeBytes) != Header.EdgesCrc)
+		{
+			UE_LOG(LogPVolBinary, Warning, TEXT("MappedGrid: '%s' cell edges are corrupt"), *FilePath);
+			Close();
+			return false;
+		}
+		Edges.SetNumUninitialized(Header.GetNumAxisEdges());
+		FMemory::Memcpy(Edges.GetData(), EdgeData, EdgeBytes);
+	}
+	if (Header.IsCompressed())
+	{
+		OwnedBits.SetNumUninitialized(Header.NumWords);
+		const bool bOk = DecodePayload(Header, Payload, OwnedBits.GetData());
+		if (bOk && MaskData)
+		{
+			OwnedMasks = TArray<uint8>(MaskData, static_cast<int32>(Header.GetOriginMaskSize()));
+			Masks = OwnedMasks.GetData();
+		}
+
+		// The mapping is not needed once decoded
+		MappedRegion.Reset();
+		MappedFile.Reset();
+		if (!bOk)
+		{
+			UE_LOG(LogPVolBinary, Warning, TEXT("MappedGrid: '%s' payload is corrupt"), *FilePath);
+			Close();
+			return false;
+		}
+		Bits = OwnedBits.GetData();
+		return true;
+	}
+
+	// Raw payloads are served in place once their CRC matches
+	if (FCrc::MemCrc32(Payload, Header.NumWords * sizeof(uint32)) != Header.BitsCrc)
+	{
+		UE_LOG(LogPVolBinary, Warning, TEXT("MappedGrid: '%s' payload is corrupt"), *FilePath);
+		Close();
+		return false;
+	}
+	Bits = reinterpret_cast<const uint32 *>(Payload);
+	Masks = MaskData;
+	return true;
+}
+
+int32 FVolumeAnalysisMappedGrid::CountVisibleInRange(const FVoxelRange &Range) const
+{
+	if (!IsOpen() || Range.IsEmpty())
+	{
+		return 0;
+	}
+	int32 Count = 0;
+	for (int32 Z = Range.Min.Z; Z < Range.Max.Z; ++Z)
+	{
+		for (int32 Y = Range.Min.Y; Y < Range.Max.Y; ++Y)
+		{
+			const int32 RowStart = Index(Range.Min.X, Y, Z);
+			Count += FS_VoxelGrid::CountBitsInRange(Bits, RowStart, RowStart + (Range.Max.X - Range.Min.X));
+		}
+	}
+	return Count;
+}
+
+void FVolumeAnalysisMappedGrid::Close()
+{
+	Bits = nullptr;
+	Masks = nullptr;
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	OwnedBits.Empty();
+	OwnedMasks.Empty();
+	Edges.Empty();
+	Header = FVolumeAnalysisBinaryHeader();
+}
+
+void FVolumeAnalysisMappedGrid::CopyToGrid(FS_VoxelGrid &OutGrid) const
+{
+	OutGrid.Reset();
+	if (!IsOpen())
+	{
+		return;
+	}
+	OutGrid.Origin = Header.Origin;
+	OutGrid.CellSize = Header.CellSize;
+	OutGrid.CountX = Header.CountX;
+	OutGrid.CountY = Header.CountY;
+	OutGrid.CountZ = Header.CountZ;
+	OutGrid.VisibilityBits = TArray<uint32>(Bits, Header.NumWords);
+	if (Masks)
+	{
+		OutGrid.OriginMasks = TArray<uint8>(Masks, Num());
+	}
+	if (Edges.Num() > 0 && !ApplyAxisEdges(OutGrid, Edges.GetData()))
+	{
+		OutGrid.Reset();
+	}
+}
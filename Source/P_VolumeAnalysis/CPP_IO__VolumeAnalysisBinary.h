@@ -0,0 +1,168 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CPP_ST__VolumeAnalysisGrid.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Versioned binary result file (.pvag):
+ *   Header (HeaderSize bytes, little-endian) : magic, version, flags, origin, cell size, counts, word count, payload size, CRC
+ *   Payload                                  : packed visibility bits (uint32 words), optionally compressed
+ *   Origin masks (version 2, HasOriginMasks) : one raw uint8 per voxel, right after the payload
+ *   Cell edges (version 3, HasAxisEdges)     : Count + 1 raw doubles per axis (X, Y, Z) of a non-uniform grid, last
+ * Uncompressed payloads start at a 16-byte aligned offset so they can be read in place from a memory mapping.
+ */
+struct P_VOLUMEANALYSIS_API FVolumeAnalysisBinaryHeader
+{
+	static constexpr uint32 Magic = 0x47415650; // "PVAG"
+	static constexpr uint16 CurrentVersion = 3;
+	static constexpr int64 HeaderSize = 96;
+
+	enum EFlags : uint16
+	{
+		None = 0,
+		// Payload is compressed with FCompression (NAME_Zlib)
+		Compressed = 1 << 0,
+		// Per-voxel origin masks of a FromOrigins run follow the payload
+		HasOriginMasks = 1 << 1,
+		// Cell boundaries of a non-uniform grid follow the payload and masks
+		HasAxisEdges = 1 << 2,
+	};
+
+	uint32 FileMagic = Magic;
+	uint16 Version = CurrentVersion;
+	uint16 Flags = None;
+	FVector Origin = FVector::ZeroVector;
+	FVector CellSize = FVector::ZeroVector;
+	int32 CountX = 0;
+	int32 CountY = 0;
+	int32 CountZ = 0;
+	// Uncompressed visibility word count
+	int32 NumWords = 0;
+	// Bytes stored after the header (compressed size when Compressed is set)
+	int64 PayloadSize = 0;
+	// CRC32 of the uncompressed visibility words
+	uint32 BitsCrc = 0;
+	// CRC32 of the origin masks (version 2; reserved padding in version 1 files, so always 0 there)
+	uint32 MasksCrc = 0;
+	// CRC32 of the cell edges (version 3; reserved padding before)
+	uint32 EdgesCrc = 0;
+
+	bool IsCompressed() const { return (Flags & Compressed) != 0; }
+
+	bool HasMasks() const { return (Flags & HasOriginMasks) != 0; }
+
+	bool HasEdges() const { return (Flags & HasAxisEdges) != 0; }
+
+	// Bytes of origin masks stored after the payload
+	int64 GetOriginMaskSize() const { return HasMasks() ? GetNumVoxels() : 0; }
+
+	// Doubles of cell edges stored after the origin masks
+	int32 GetNumAxisEdges() const { return HasEdges() ? CountX + CountY + CountZ + 3 : 0; }
+
+	// Header, payload, origin masks and cell edges
+	int64 GetFileSize() const { return HeaderSize + PayloadSize + GetOriginMaskSize() + int64(GetNumAxisEdges()) * sizeof(double); }
+
+	int64 GetNumVoxels() const { return int64(CountX) * CountY * CountZ; }
+
+	// Magic, version and layout consistency (does not check the payload)
+	bool IsValid() const;
+
+	// Serializes exactly HeaderSize bytes (reserved bytes are zero-padded)
+	void Serialize(FArchive &Ar);
+};
+
+/** Save/load of FS_VoxelGrid in the binary result format */
+struct P_VOLUMEANALYSIS_API FVolumeAnalysisBinary
+{
+	static bool SaveToFile(const FS_VoxelGrid &Grid, const FString &FilePath, bool bCompress = false);
+
+	// Reads the header and payload straight into OutGrid's storage (no intermediate file buffer)
+	static bool LoadFromFile(const FString &FilePath, FS_VoxelGrid &OutGrid);
+
+	static bool ReadHeader(const FString &FilePath, FVolumeAnalysisBinaryHeader &OutHeader);
+};
+
+/**
+ * Read-only, memory-mapped view of a binary result file. Visibility queries read straight from the mapping, so the
+ * bits are never duplicated in memory; opening reads the file once to verify its CRCs. Compressed files cannot be
+ * viewed in place and are decompressed into an owned buffer instead, as are files that cannot be mapped (e.g. in paks).
+ */
+class P_VOLUMEANALYSIS_API FVolumeAnalysisMappedGrid
+{
+public:
+	FVolumeAnalysisMappedGrid();
+	~FVolumeAnalysisMappedGrid();
+
+	FVolumeAnalysisMappedGrid(const FVolumeAnalysisMappedGrid &) = delete;
+	FVolumeAnalysisMappedGrid &operator=(const FVolumeAnalysisMappedGrid &) = delete;
+
+	bool Open(const FString &FilePath);
+	void Close();
+
+	bool IsOpen() const { return Bits != nullptr; }
+
+	// True when the bits are served from the file mapping rather than an owned buffer
+	bool IsMapped() const { return MappedRegion.IsValid(); }
+
+	const FVolumeAnalysisBinaryHeader &GetHeader() const { return Header; }
+
+	int32 Num() const { return Header.CountX * Header.CountY * Header.CountZ; }
+
+	FORCEINLINE int32 Index(int32 X, int32 Y, int32 Z) const
+	{
+		return Z * (Header.CountY * Header.CountX) + Y * Header.CountX + X;
+	}
+
+	FORCEINLINE bool IsVisible(int32 InIndex) const
+	{
+		return (Bits[InIndex >> 5] & (1u << (InIndex & 31))) != 0;
+	}
+
+	// Origin mask of a voxel; files without masks report visible voxels as seen by origin 0
+	FORCEINLINE uint8 GetOriginMask(int32 InIndex) const
+	{
+		return Masks ? Masks[InIndex] : (IsVisible(InIndex) ? 1 : 0);
+	}
+
+	FORCEINLINE FVector GetCellCenter(int32 X, int32 Y, int32 Z) const
+	{
+		if (Edges.Num() == 0)
+		{
+			return Header.Origin + Header.CellSize * FVector(X + 0.5, Y + 0.5, Z + 0.5);
+		}
+		// X, Y and Z edges are stored back to back
+		const double *EX = Edges.GetData();
+		const double *EY = EX + Header.CountX + 1;
+		const double *EZ = EY + Header.CountY + 1;
+		return FVector(0.5 * (EX[X] + EX[X + 1]), 0.5 * (EY[Y] + EY[Y + 1]), 0.5 * (EZ[Z] + EZ[Z + 1]));
+	}
+
+	// Visible voxels inside a voxel range, as FS_VoxelGrid::CountVisibleInRange
+	int32 CountVisibleInRange(const FVoxelRange &Range) const;
+
+	// Raw visibility words (Header.NumWords entries)
+	TConstArrayView<uint32> GetBits() const { return TConstArrayView<uint32>(Bits, IsOpen() ? Header.NumWords : 0); }
+
+	// Copy into an owning grid (flags are not stored in the file)
+	void CopyToGrid(FS_VoxelGrid &OutGrid) const;
+
+private:
+	FVolumeAnalysisBinaryHeader Header;
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<uint32> OwnedBits;
+	TArray<uint8> OwnedMasks;
+	// Cell edges of a non-uniform grid (small, so always copied out of the file)
+	TArray<double> Edges;
+	const uint32 *Bits = nullptr;
+	const uint8 *Masks = nullptr;
+};
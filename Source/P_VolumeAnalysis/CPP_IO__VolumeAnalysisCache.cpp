@@ -0,0 +1,202 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#include "CPP_IO__VolumeAnalysisCache.h"
+#include "CPP_IO__VolumeAnalysisBinary.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Hash/xxhash.h"
+#include "HAL/FileManager.h"
+#include "LandscapeHeightfieldCollisionComponent.h"
+#include "Misc/Paths.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Serialization/MemoryWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPVolCache, Log, All);
+
+template <typename T>
+static void HashValue(FXxHash64Builder &Builder, const T &Value)
+{
+	Builder.Update(&Value, sizeof(T));
+}
+
+static void HashString(FXxHash64Builder &Builder, const FString &Value)
+{
+	Builder.Update(*Value, Value.Len() * sizeof(TCHAR));
+}
+
+// Collision geometry of a body setup: its GUID plus the simple shapes, which editors such as brush rebuilds change in place
+static void HashBodySetup(FXxHash64Builder &Builder, const UBodySetup &BodySetup)
+{
+	HashValue(Builder, BodySetup.BodySetupGuid);
+	HashValue(Builder, static_cast<uint8>(BodySetup.GetCollisionTraceFlag()));
+	const FKAggregateGeom &Geom = BodySetup.AggGeom;
+	for (const FKBoxElem &Box : Geom.BoxElems)
+	{
+		HashValue(Builder, Box.Center);
+		HashValue(Builder, Box.Rotation);
+		HashValue(Builder, FVector(Box.X, Box.Y, Box.Z));
+	}
+	for (const FKSphereElem &Sphere : Geom.SphereElems)
+	{
+		HashValue(Builder, Sphere.Center);
+		HashValue(Builder, Sphere.Radius);
+	}
+	for (const FKSphylElem &Sphyl : Geom.SphylElems)
+	{
+		HashValue(Builder, Sphyl.Center);
+		HashValue(Builder, Sphyl.Rotation);
+		HashValue(Builder, Sphyl.Radius);
+		HashValue(Builder, Sphyl.Length);
+	}
+	for (const FKConvexElem &Convex : Geom.ConvexElems)
+	{
+		HashValue(Builder, Convex.GetTransform().ToMatrixWithScale().M);
+		Builder.Update(Convex.VertexData.GetData(), Convex.VertexData.Num() * sizeof(FVector));
+	}
+}
+
+// Identity of one colliding primitive; independent of actor names, which differ between editor, PIE and cooked worlds
+static uint64 HashPrimitive(const UPrimitiveComponent &Component, ECollisionChannel Channel)
+{
+	FXxHash64Builder Builder;
+	HashString(Builder, Component.GetClass()->GetPathName());
+	const FMatrix ToWorld = Component.GetComponentTransform().ToMatrixWithScale();
+	HashValue(Builder, ToWorld.M);
+	HashValue(Builder, static_cast<uint8>(Component.GetCollisionResponseToChannel(Channel)));
+
+	// Instances (ISM, HISM, foliage) can move, appear or vanish inside unchanged overall bounds
+	if (const UInstancedStaticMeshComponent *Instanced = Cast<UInstancedStaticMeshComponent>(&Component))
+	{
+		const int32 NumInstances = Instanced->GetInstanceCount();
+		HashValue(Builder, NumInstances);
+		for (int32 Instance = 0; Instance < NumInstances; ++Instance)
+		{
+			FTransform InstanceTransform;
+			if (Instanced->GetInstanceTransform(Instance, InstanceTransform, /*bWorldSpace*/ false))
+			{
+				HashValue(Builder, InstanceTransform.ToMatrixWithScale().M);
+			}
+		}
+	}
+
+	const UStaticMeshComponent *MeshComponent = Cast<UStaticMeshComponent>(&Component);
+	const UStaticMesh *Mesh = MeshComponent ? MeshComponent->GetStaticMesh() : nullptr;
+	if (Mesh)
+	{
+		HashString(Builder, Mesh->GetPathName());
+		if (const UBodySetup *BodySetup = Mesh->GetBodySetup())
+		{
+			HashValue(Builder, BodySetup->BodySetupGuid);
+		}
+	}
+	else if (const ULandscapeHeightfieldCollisionComponent *Heightfield = Cast<ULandscapeHeightfieldCollisionComponent>(&Component))
+	{
+		// Renewed whenever sculpting or painting rewrites the collision heights
+		HashValue(Builder, Heightfield->HeightfieldGuid);
+		HashValue(Builder, Component.Bounds.Origin);
+		HashValue(Builder, Component.Bounds.BoxExtent);
+	}
+	else if (const UBodySetup *BodySetup = const_cast<UPrimitiveComponent &>(Component).GetBodySetup())
+	{
+		HashBodySetup(Builder, *BodySetup);
+	}
+	else
+	{
+		// No asset to identify the shape by; its bounds are the best stand-in
+		HashValue(Builder, Component.Bounds.Origin);
+		HashValue(Builder, Component.Bounds.BoxExtent);
+	}
+	return Builder.Finalize().Hash;
+}
+
+FString FVolumeAnalysisCache::ComputeKey(UWorld *World, const FBox &Volume, int32 CountX, int32 CountY, int32 CountZ, const FS_VolumeAnalysisSettings &Settings, const AActor *IgnoredActor)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FVolumeAnalysisCache::ComputeKey);
+	FXxHash64Builder Builder;
+	HashValue(Builder, KeyVersion);
+	HashValue(Builder, Volume.Min);
+	HashValue(Builder, Volume.Max);
+	HashValue(Builder, FIntVector(CountX, CountY, CountZ));
+
+	TArray<uint8> SettingsBytes;
+	FMemoryWriter SettingsWriter(SettingsBytes);
+	FS_VolumeAnalysisSettings::StaticStruct()->SerializeBin(SettingsWriter, const_cast<FS_VolumeAnalysisSettings *>(&Settings));
+	Builder.Update(SettingsBytes.GetData(), SettingsBytes.Num());
+
+	if (World)
+	{
+		// Overlap spheres and segment ends reach up to half a cell past the centers; a whole cell of margin covers them
+		const FVector Margin = Volume.GetSize() / FVector(FMath::Max(CountX, 1), FMath::Max(CountY, 1), FMath::Max(CountZ, 1));
+		const FBox QueryBounds = Volume.ExpandBy(Margin);
+		const ECollisionChannel Channel = Settings.TraceChannel.GetValue();
+
+		// Movable primitives are traced like static ones, so they are part of the key at their current pose.
+		// Sorted so the key does not depend on actor iteration order.
+		TArray<uint64> PrimitiveHashes;
+		for (TActorIterator<AActor> It(World); It; ++It)
+		{
+			const AActor *Actor = *It;
+			if (Actor == IgnoredActor)
+			{
+				continue;
+			}
+			Actor->ForEachComponent<UPrimitiveComponent>(/*bIncludeFromChildActors*/ false, [&](const UPrimitiveComponent *Component)
+														   {
+				if (!Component->IsRegistered() || !Component->IsQueryCollisionEnabled() || Component->GetCollisionResponseToChannel(Channel) == ECR_Ignore)
+				{
+					return;
+				}
+				if (Component->Bounds.GetBox().Intersect(QueryBounds))
+				{
+					PrimitiveHashes.Add(HashPrimitive(*Component, Channel));
+				} });
+		}
+		PrimitiveHashes.Sort();
+		Builder.Update(PrimitiveHashes.GetData(), PrimitiveHashes.Num() * sizeof(uint64));
+	}
+	return FString::Printf(TEXT("%016llx"), Builder.Finalize().Hash);
+}
+
+FString FVolumeAnalysisCache::GetCacheFilePath(const FString &Key)
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("VolumeAnalysis"), TEXT("Cache"), Key + TEXT(".pvag"));
+}
+
+bool FVolumeAnalysisCache::Load(const FString &Key, const FBox &Volume, int32 CountX, int32 CountY, int32 CountZ, FS_VoxelGrid &OutGrid)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FVolumeAnalysisCache::Load);
+	const FString FilePath = GetCacheFilePath(Key);
+	if (!IFileManager::Get().FileExists(*FilePath))
+	{
+		return false;
+	}
+	if (!FVolumeAnalysisBinary::LoadFromFile(FilePath, OutGrid))
+	{
+		UE_LOG(LogPVolCache, Warning, TEXT("Load: Discarding unreadable cache entry '%s'"), *FilePath);
+		IFileManager::Get().Delete(*FilePath);
+		return false;
+	}
+	// A 64-bit key collision is unlikely, but a wrong layout would be silently wrong results
+	const FVector CellSize = Volume.GetSize() / FVector(CountX, CountY, CountZ);
+	if (OutGrid.CountX != CountX || OutGrid.CountY != CountY || OutGrid.CountZ != CountZ || !OutGrid.Origin.Equals(Volume.Min) || !OutGrid.CellSize.Equals(CellSize))
+	{
+		UE_LOG(LogPVolCache, Warning, TEXT("Load: Cache entry '%s' has a different grid layout; ignoring it"), *FilePath);
+		OutGrid.Reset();
+		return false;
+	}
+	return true;
+}
+
+bool FVolumeAnalysisCache::Save(const FString &Key, const FS_VoxelGrid &Grid, bool bCompress)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FVolumeAnalysisCache::Save);
+	return FVolumeAnalysisBinary::SaveToFile(Grid, GetCacheFilePath(Key), bCompress);
+}
@@ -0,0 +1,37 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CPP_ST__VolumeAnalysisGrid.h"
+#include "CPP_EN__VolumeAnalysisEngine.h"
+
+class UWorld;
+class AActor;
+
+/**
+ * On-disk result cache under <ProjectSaved>/VolumeAnalysis/Cache, one binary result file (.pvag) per key.
+ * The key hashes everything a run's result depends on: the grid layout, the run settings and the colliding
+ * geometry overlapping the volume (per primitive: class, world transform, collision response, every instance
+ * transform of instanced meshes, and the mesh identity, landscape heightfield GUID or body setup shapes).
+ * Geometry that changes shape without changing any of those (e.g. procedural mesh sections) is not detected.
+ */
+struct P_VOLUMEANALYSIS_API FVolumeAnalysisCache
+{
+	// Bump when anything that feeds the key or the meaning of a stored result changes
+	static constexpr uint32 KeyVersion = 2;
+
+	// 16 hex digits; IgnoredActor's own components are left out (the run ignores them too)
+	static FString ComputeKey(UWorld *World, const FBox &Volume, int32 CountX, int32 CountY, int32 CountZ, const FS_VolumeAnalysisSettings &Settings, const AActor *IgnoredActor);
+
+	static FString GetCacheFilePath(const FString &Key);
+
+	// False on a miss, or if the cached file does not have the layout Volume and the counts would produce
+	static bool Load(const FString &Key, const FBox &Volume, int32 CountX, int32 CountY, int32 CountZ, FS_VoxelGrid &OutGrid);
+
+	static bool Save(const FString &Key, const FS_VoxelGrid &Grid, bool bCompress = true);
+};
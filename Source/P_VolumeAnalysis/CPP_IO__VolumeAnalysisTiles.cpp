@@ -0,0 +1,467 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#include "CPP_IO__VolumeAnalysisTiles.h"
+#include "CPP_IO__VolumeAnalysisBinary.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPVolTiles, Log, All);
+
+static void SerializeVector(FArchive &Ar, FVector &V)
+{
+	double X = V.X, Y = V.Y, Z = V.Z;
+	Ar << X << Y << Z;
+	V = FVector(X, Y, Z);
+}
+
+FString FVolumeAnalysisTileStore::GetManifestPath(const FString &InDirectory)
+{
+	return InDirectory / TEXT("Tiles.pvat");
+}
+
+FString FVolumeAnalysisTileStore::GetTilePath(int32 TileIndex) const
+{
+	return Directory / FString::Printf(TEXT("Tile_%d.pvag"), TileIndex);
+}
+
+bool FVolumeAnalysisTileStore::BeginWrite(const FString &InDirectory, const FBox &Volume, const FIntVector &InCounts, int32 InTileSize, bool bInCompress)
+{
+	Close();
+	if (!Volume.IsValid || InCounts.X <= 0 || InCounts.Y <= 0 || InCounts.Z <= 0 || InTileSize <= 0 || InTileSize > 1024)
+	{
+		return false;
+	}
+	const FIntVector NumTiles(FMath::DivideAndRoundUp(InCounts.X, InTileSize), FMath::DivideAndRoundUp(InCounts.Y, InTileSize), FMath::DivideAndRoundUp(InCounts.Z, InTileSize));
+	if (int64(NumTiles.X) * NumTiles.Y * NumTiles.Z > MAX_int32)
+	{
+		return false;
+	}
+
+	IFileManager &FileManager = IFileManager::Get();
+	if (!FileManager.MakeDirectory(*InDirectory, /*Tree*/ true))
+	{
+		UE_LOG(LogPVolTiles, Warning, TEXT("BeginWrite: Could not create '%s'"), *InDirectory);
+		return false;
+	}
+	// Only this store's own files are removed; the directory may be shared with other content
+	TArray<FString> OldTiles;
+	FileManager.FindFiles(OldTiles, *(InDirectory / TEXT("Tile_*.pvag")), /*Files*/ true, /*Directories*/ false);
+	for (const FString &OldTile : OldTiles)
+	{
+		FileManager.Delete(*(InDirectory / OldTile));
+	}
+	FileManager.Delete(*GetManifestPath(InDirectory), /*RequireExists*/ false, /*EvenReadOnly*/ false, /*Quiet*/ true);
+
+	Directory = InDirectory;
+	Origin = Volume.Min;
+	Counts = InCounts;
+	CellSize = Volume.GetSize() / FVector(Counts);
+	TileSize = InTileSize;
+	TileCounts = NumTiles;
+	bCompress = bInCompress;
+	const int32 Total = TileCounts.X * TileCounts.Y * TileCounts.Z;
+	TileStates.SetNumZeroed(Total);
+	TileVisibleCounts.SetNumZeroed(Total);
+	return true;
+}
+
+bool FVolumeAnalysisTileStore::WriteTile(int32 TileIndex, const FS_VoxelGrid &TileGrid)
+{
+	if (!TileStates.IsValidIndex(TileIndex))
+	{
+		return false;
+	}
+	const FVoxelRange Range = GetTileRange(TileIndex);
+	const FIntVector Size = Range.Max - Range.Min;
+	if (TileGrid.CountX != Size.X || TileGrid.CountY != Size.Y || TileGrid.CountZ != Size.Z)
+	{
+		UE_LOG(LogPVolTiles, Warning, TEXT("WriteTile: Tile %d has %d x %d x %d voxels, expected %d x %d x %d"), TileIndex, TileGrid.CountX, TileGrid.CountY, TileGrid.CountZ, Size.X, Size.Y, Size.Z);
+		return false;
+	}
+
+	// A stale resident copy of a rewritten tile must not be served
+	if (Resident.Remove(TileIndex) > 0)
+	{
+		ResidentOrder.Remove(TileIndex);
+	}
+	const int32 Visible = TileGrid.CountVisible();
+	TileVisibleCounts[TileIndex] = Visible;
+	const FString TilePath = GetTilePath(TileIndex);
+	if (Visible == 0 || (Visible == TileGrid.Num() && !TileGrid.HasOriginMasks()))
+	{
+		TileStates[TileIndex] = static_cast<uint8>(Visible == 0 ? EE_VolumeAnalysisTileState::AllHidden : EE_VolumeAnalysisTileState::AllVisible);
+		IFileManager::Get().Delete(*TilePath, /*RequireExists*/ false, /*EvenReadOnly*/ false, /*Quiet*/ true);
+		return true;
+	}
+	if (!FVolumeAnalysisBinary::SaveToFile(TileGrid, TilePath, bCompress))
+	{
+		TileStates[TileIndex] = static_cast<uint8>(EE_VolumeAnalysisTileState::Missing);
+		TileVisibleCounts[TileIndex] = 0;
+		return false;
+	}
+	TileStates[TileIndex] = static_cast<uint8>(EE_VolumeAnalysisTileState::Stored);
+	return true;
+}
+
+void FVolumeAnalysisTileStore::SerializeManifest(FArchive &Ar)
+{
+	uint32 Magic = ManifestMagic;
+	uint16 Version = ManifestVersion;
+	Ar << Magic << Version;
+	if (Ar.IsLoading() && (Magic != ManifestMagic || Version == 0 || Version > ManifestVersion))
+	{
+		Ar.SetError();
+		return;
+	}
+	SerializeVector(Ar, Origin);
+	SerializeVector(Ar, CellSize);
+	Ar << Counts << TileSize << TileCounts << bCompress;
+	Ar << TileStates << TileVisibleCounts;
+}
+
+bool FVolumeAnalysisTileStore::FinishWrite()
+{
+	if (!IsOpen())
+	{
+		return false;
+	}
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	SerializeManifest(Writer);
+	const FString ManifestPath = GetManifestPath(Directory);
+	if (!FFileHelper::SaveArrayToFile(Bytes, *ManifestPath))
+	{
+		UE_LOG(LogPVolTiles, Warning, TEXT("FinishWrite: Could not write '%s'"), *ManifestPath);
+		return false;
+	}
+	return true;
+}
+
+bool FVolumeAnalysisTileStore::Open(const FString &InDirectory)
+{
+	Close();
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *GetManifestPath(InDirectory), FILEREAD_Silent))
+	{
+		return false;
+	}
+	FMemoryReader Reader(Bytes);
+	SerializeManifest(Reader);
+	const int64 Total = int64(TileCounts.X) * TileCounts.Y * TileCounts.Z;
+	const bool bValid = !Reader.IsError() && TileSize > 0 && Counts.X > 0 && Counts.Y > 0 && Counts.Z > 0 && TileCounts.X == FMath::DivideAndRoundUp(Counts.X, TileSize) && TileCounts.Y == FMath::DivideAndRoundUp(Counts.Y, TileSize) && TileCounts.Z == FMath::DivideAndRoundUp(Counts.Z, TileSize) && TileStates.Num() == Total && TileVisibleCounts.Num() == Total;
+	if (!bValid)
+	{
+		UE_LOG(LogPVolTiles, Warning, TEXT("Open: '%s' is not a valid tile manifest"), *GetManifestPath(InDirectory));
+		TileStates.Reset();
+		TileVisibleCounts.Reset();
+		return false;
+	}
+	Directory = InDirectory;
+	return true;
+}
+
+void FVolumeAnalysisTileStore::Close()
+{
+	Directory.Reset();
+	Counts = FIntVector::ZeroValue;
+	TileCounts = FIntVector::ZeroValue;
+	TileSize = 0;
+	TileStates.Reset();
+	TileVisibleCounts.Reset();
+	Resident.Reset();
+	ResidentOrder.Reset();
+}
+
+FVoxelRange FVolumeAnalysisTileStore::GetTileRange(int32 TileIndex) const
+{
+	const FIntVector Tile(TileIndex % TileCounts.X, (TileIndex / TileCounts.X) % TileCounts.Y, TileIndex / (TileCounts.X * TileCounts.Y));
+	const FIntVector Min = Tile * TileSize;
+	return FVoxelRange(Min, FIntVector(FMath::Min(Min.X + TileSize, Counts.X), FMath::Min(Min.Y + TileSize, Counts.Y), FMath::Min(Min.Z + TileSize, Counts.Z)));
+}
+
+FBox FVolumeAnalysisTileStore::GetRangeBounds(const FVoxelRange &Range) const
+{
+	return FBox(Origin + CellSize * FVector(Range.Min), Origin + CellSize * FVector(Range.Max));
+}
+
+int64 FVolumeAnalysisTileStore::CountVisible() const
+{
+	int64 Count = 0;
+	for (const int32 Visible : TileVisibleCounts)
+	{
+		Count += Visible;
+	}
+	return Count;
+}
+
+bool FVolumeAnalysisTileStore::GetVoxelAt(const FVector &WorldPos, FIntVector &OutVoxel) const
+{
+	if (!IsOpen())
+	{
+		return false;
+	}
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		if (CellSize[Axis] <= KINDA_SMALL_NUMBER)
+		{
+			return false;
+		}
+		const double Cell = FMath::FloorToDouble((WorldPos[Axis] - Origin[Axis]) / CellSize[Axis]);
+		if (Cell < 0.0 || Cell >= Counts[Axis])
+		{
+			return false;
+		}
+		OutVoxel[Axis] = static_cast<int32>(Cell);
+	}
+	return true;
+}
+
+FVoxelRange FVolumeAnalysisTileStore::GetVoxelRange(const FBox &WorldBox) const
+{
+	if (!IsOpen() || !WorldBox.IsValid)
+	{
+		return FVoxelRange();
+	}
+	FVoxelRange Range;
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		if (CellSize[Axis] <= KINDA_SMALL_NUMBER)
+		{
+			Range.Min[Axis] = 0;
+			Range.Max[Axis] = Counts[Axis];
+			continue;
+		}
+		const auto Cell = [this, Axis](double Value)
+		{
+			return static_cast<int32>(FMath::Clamp(FMath::FloorToDouble((Value - Origin[Axis]) / CellSize[Axis]), -1.0, double(Counts[Axis])));
+		};
+		Range.Min[Axis] = FMath::Clamp(Cell(WorldBox.Min[Axis]), 0, Counts[Axis]);
+		Range.Max[Axis] = FMath::Clamp(Cell(WorldBox.Max[Axis]) + 1, 0, Counts[Axis]);
+	}
+	return Range;
+}
+
+int64 FVolumeAnalysisTileStore::CountVisibleInRange(const FVoxelRange &InRange)
+{
+	FVoxelRange Range;
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		Range.Min[Axis] = FMath::Clamp(InRange.Min[Axis], 0, Counts[Axis]);
+		Range.Max[Axis] = FMath::Clamp(InRange.Max[Axis], 0, Counts[Axis]);
+	}
+	if (!IsOpen() || Range.IsEmpty())
+	{
+		return 0;
+	}
+	const FIntVector FirstTile = Range.Min / TileSize;
+	const FIntVector LastTile = (Range.Max - FIntVector(1)) / TileSize;
+	int64 Count = 0;
+	for (int32 TZ = FirstTile.Z; TZ <= LastTile.Z; ++TZ)
+	{
+		for (int32 TY = FirstTile.Y; TY <= LastTile.Y; ++TY)
+		{
+			for (int32 TX = FirstTile.X; TX <= LastTile.X; ++TX)
+			{
+				const int32 TileIndex = (TZ * TileCounts.Y + TY) * TileCounts.X + TX;
+				const FVoxelRange TileRange = GetTileRange(TileIndex);
+				const FVoxelRange Overlap(FIntVector(FMath::Max(TileRange.Min.X, Range.Min.X), FMath::Max(TileRange.Min.Y, Range.Min.Y), FMath::Max(TileRange.Min.Z, Range.Min.Z)),
+										  FIntVector(FMath::Min(TileRange.Max.X, Range.Max.X), FMath::Min(TileRange.Max.Y, Range.Max.Y), FMath::Min(TileRange.Max.Z, Range.Max.Z)));
+				if (Overlap.Num() == TileRange.Num())
+				{
+					Count += TileVisibleCounts[TileIndex];
+					continue;
+				}
+				switch (GetTileState(TileIndex))
+				{
+				case EE_VolumeAnalysisTileState::AllVisible:
+					Count += Overlap.Num();
+					break;
+				case EE_VolumeAnalysisTileState::Stored:
+					if (const FVolumeAnalysisMappedGrid *Tile = PageIn(TileIndex))
+					{
+						Count += Tile->CountVisibleInRange(FVoxelRange(Overlap.Min - TileRange.Min, Overlap.Max - TileRange.Min));
+					}
+					break;
+				default:
+					break;
+				}
+			}
+		}
+	}
+	return Count;
+}
+
+bool FVolumeAnalysisTileStore::Raymarch(const FVector &Start, const FVector &End, bool bTargetVisible, FVector &OutHitLocation, FIntVector &OutVoxel)
+{
+	if (!IsOpen() || CellSize.GetMin() <= KINDA_SMALL_NUMBER)
+	{
+		return false;
+	}
+
+	// Same clip and DDA as FS_VoxelGrid::Raymarch, on the uniform full-grid cells
+	const FVector Dir = End - Start;
+	const FBox Bounds = GetRangeBounds(FVoxelRange(FIntVector::ZeroValue, Counts));
+	double TMin = 0.0;
+	double TMax = 1.0;
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		if (FMath::Abs(Dir[Axis]) < UE_DOUBLE_SMALL_NUMBER)
+		{
+			if (Start[Axis] < Bounds.Min[Axis] || Start[Axis] > Bounds.Max[Axis])
+			{
+				return false;
+			}
+			continue;
+		}
+		double T0 = (Bounds.Min[Axis] - Start[Axis]) / Dir[Axis];
+		double T1 = (Bounds.Max[Axis] - Start[Axis]) / Dir[Axis];
+		if (T0 > T1)
+		{
+			Swap(T0, T1);
+		}
+		TMin = FMath::Max(TMin, T0);
+		TMax = FMath::Min(TMax, T1);
+		if (TMin > TMax)
+		{
+			return false;
+		}
+	}
+
+	const FVector Entry = Start + Dir * TMin;
+	FIntVector Cell;
+	FIntVector Step;
+	FVector TNext;
+	const auto NextBoundary = [this, &Cell, &Step, &Start, &Dir](int32 Axis) -> double
+	{
+		return (Origin[Axis] + CellSize[Axis] * (Cell[Axis] + (Step[Axis] > 0 ? 1 : 0)) - Start[Axis]) / Dir[Axis];
+	};
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		Cell[Axis] = FMath::Clamp(static_cast<int32>(FMath::FloorToDouble((Entry[Axis] - Origin[Axis]) / CellSize[Axis])), 0, Counts[Axis] - 1);
+		if (FMath::Abs(Dir[Axis]) < UE_DOUBLE_SMALL_NUMBER)
+		{
+			Step[Axis] = 0;
+			TNext[Axis] = UE_DOUBLE_BIG_NUMBER;
+			continue;
+		}
+		Step[Axis] = Dir[Axis] > 0.0 ? 1 : -1;
+		TNext[Axis] = NextBoundary(Axis);
+	}
+
+	// The current tile is looked up once per tile crossed rather than once per voxel
+	int32 CurrentTile = INDEX_NONE;
+	EE_VolumeAnalysisTileState CurrentState = EE_VolumeAnalysisTileState::Missing;
+	const FVolumeAnalysisMappedGrid *CurrentGrid = nullptr;
+	double T = TMin;
+	while (true)
+	{
+		int32 LocalIndex = 0;
+		const int32 TileIndex = GetTileIndex(Cell, LocalIndex);
+		if (TileIndex != CurrentTile)
+		{
+			CurrentTile = TileIndex;
+			CurrentState = GetTileState(TileIndex);
+			CurrentGrid = (CurrentState == EE_VolumeAnalysisTileState::Stored) ? PageIn(TileIndex) : nullptr;
+		}
+		const bool bVisible = CurrentGrid ? CurrentGrid->IsVisible(LocalIndex) : (CurrentState == EE_VolumeAnalysisTileState::AllVisible);
+		if (bVisible == bTargetVisible)
+		{
+			OutHitLocation = Start + Dir * T;
+			OutVoxel = Cell;
+			return true;
+		}
+		const int32 Axis = (TNext.X < TNext.Y) ? (TNext.X < TNext.Z ? 0 : 2) : (TNext.Y < TNext.Z ? 1 : 2);
+		T = TNext[Axis];
+		Cell[Axis] += Step[Axis];
+		if (T > TMax || Cell[Axis] < 0 || Cell[Axis] >= Counts[Axis])
+		{
+			return false;
+		}
+		TNext[Axis] = NextBoundary(Axis);
+	}
+}
+
+int32 FVolumeAnalysisTileStore::GetTileIndex(const FIntVector &Voxel, int32 &OutLocalIndex) const
+{
+	if (!IsOpen() || Voxel.X < 0 || Voxel.Y < 0 || Voxel.Z < 0 || Voxel.X >= Counts.X || Voxel.Y >= Counts.Y || Voxel.Z >= Counts.Z)
+	{
+		return INDEX_NONE;
+	}
+	const FIntVector Tile = Voxel / TileSize;
+	const FIntVector Local = Voxel - Tile * TileSize;
+	const int32 SizeX = FMath::Min(TileSize, Counts.X - Tile.X * TileSize);
+	const int32 SizeY = FMath::Min(TileSize, Counts.Y - Tile.Y * TileSize);
+	OutLocalIndex = Local.Z * (SizeY * SizeX) + Local.Y * SizeX + Local.X;
+	return (Tile.Z * TileCounts.Y + Tile.Y) * TileCounts.X + Tile.X;
+}
+
+const FVolumeAnalysisMappedGrid *FVolumeAnalysisTileStore::PageIn(int32 TileIndex)
+{
+	if (TUniquePtr<FVolumeAnalysisMappedGrid> *Found = Resident.Find(TileIndex))
+	{
+		// Resident sets are small, so a linear move-to-back beats a linked list here
+		ResidentOrder.Remove(TileIndex);
+		ResidentOrder.Add(TileIndex);
+		return Found->Get();
+	}
+	TUniquePtr<FVolumeAnalysisMappedGrid> Loaded = MakeUnique<FVolumeAnalysisMappedGrid>();
+	const FIntVector Size = GetTileRange(TileIndex).Max - GetTileRange(TileIndex).Min;
+	if (!Loaded->Open(GetTilePath(TileIndex)) || Loaded->GetHeader().CountX != Size.X || Loaded->GetHeader().CountY != Size.Y || Loaded->GetHeader().CountZ != Size.Z)
+	{
+		UE_LOG(LogPVolTiles, Warning, TEXT("PageIn: Could not read tile %d of '%s'; treating it as hidden"), TileIndex, *Directory);
+		TileStates[TileIndex] = static_cast<uint8>(EE_VolumeAnalysisTileState::Missing);
+		return nullptr;
+	}
+	EvictToLimit(MaxResidentTiles - 1);
+	ResidentOrder.Add(TileIndex);
+	return Resident.Add(TileIndex, MoveTemp(Loaded)).Get();
+}
+
+void FVolumeAnalysisTileStore::EvictToLimit(int32 Limit)
+{
+	while (ResidentOrder.Num() > FMath::Max(Limit, 0))
+	{
+		Resident.Remove(ResidentOrder[0]);
+		ResidentOrder.RemoveAt(0);
+	}
+}
+
+void FVolumeAnalysisTileStore::SetMaxResidentTiles(int32 InMaxResidentTiles)
+{
+	MaxResidentTiles = FMath::Max(1, InMaxResidentTiles);
+	EvictToLimit(MaxResidentTiles);
+}
+
+bool FVolumeAnalysisTileStore::IsVisible(const FIntVector &Voxel)
+{
+	return GetOriginMask(Voxel) != 0;
+}
+
+uint8 FVolumeAnalysisTileStore::GetOriginMask(const FIntVector &Voxel)
+{
+	int32 LocalIndex = 0;
+	const int32 TileIndex = GetTileIndex(Voxel, LocalIndex);
+	if (TileIndex == INDEX_NONE)
+	{
+		return 0;
+	}
+	switch (GetTileState(TileIndex))
+	{
+	case EE_VolumeAnalysisTileState::AllVisible:
+		return 1;
+	case EE_VolumeAnalysisTileState::Stored:
+	{
+		const FVolumeAnalysisMappedGrid *Tile = PageIn(TileIndex);
+		return Tile ? Tile->GetOriginMask(LocalIndex) : 0;
+	}
+	default:
+		return 0;
+	}
+}
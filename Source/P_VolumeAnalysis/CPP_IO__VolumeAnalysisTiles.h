@@ -0,0 +1,138 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CPP_ST__VolumeAnalysisGrid.h"
+#include "CPP_IO__VolumeAnalysisBinary.h"
+
+/** How one tile of a tiled result is stored */
+enum class EE_VolumeAnalysisTileState : uint8
+{
+	// Not written (the run was stopped before reaching it); reads as hidden
+	Missing,
+	// Every voxel hidden: recorded in the manifest only
+	AllHidden,
+	// Every voxel visible and no origin masks: recorded in the manifest only
+	AllVisible,
+	// Tile_<Index>.pvag next to the manifest
+	Stored
+};
+
+/**
+ * Tiled result storage for grids too large to keep resident. The volume is cut into TileSize^3 voxel tiles (edge
+ * tiles are smaller); each completed tile is written as its own binary result file (.pvag) and uniform tiles are
+ * only recorded in the manifest (Tiles.pvat). Readers page tiles in on demand as memory-mapped views (raw tiles are
+ * read in place, compressed ones decoded once) and keep at most MaxResidentTiles.
+ * Voxels are addressed by full-grid coordinates, so the grid may hold more than MAX_int32 voxels in total.
+ * Not thread-safe: use it from one thread (the game thread for actor queries).
+ */
+class P_VOLUMEANALYSIS_API FVolumeAnalysisTileStore
+{
+public:
+	static constexpr uint32 ManifestMagic = 0x54415650; // "PVAT"
+	static constexpr uint16 ManifestVersion = 1;
+
+	// Start a new tiled result in InDirectory (tiles of an earlier result there are deleted); false if the layout is invalid
+	bool BeginWrite(const FString &InDirectory, const FBox &Volume, const FIntVector &InCounts, int32 InTileSize, bool bInCompress = true);
+
+	// Store a completed tile; TileGrid must have exactly the layout of GetTileRange(TileIndex)
+	bool WriteTile(int32 TileIndex, const FS_VoxelGrid &TileGrid);
+
+	// Write the manifest (tiles never written stay Missing); the store stays open for reading
+	bool FinishWrite();
+
+	// Open a finished tiled result for reading
+	bool Open(const FString &InDirectory);
+
+	void Close();
+
+	bool IsOpen() const { return TileStates.Num() > 0; }
+
+	const FString &GetDirectory() const { return Directory; }
+
+	FVector GetOrigin() const { return Origin; }
+
+	FVector GetCellSize() const { return CellSize; }
+
+	FIntVector GetCounts() const { return Counts; }
+
+	int64 GetNumVoxels() const { return int64(Counts.X) * Counts.Y * Counts.Z; }
+
+	int32 GetNumTiles() const { return TileStates.Num(); }
+
+	FIntVector GetTileCounts() const { return TileCounts; }
+
+	// Full-grid voxels covered by a tile
+	FVoxelRange GetTileRange(int32 TileIndex) const;
+
+	// World-space bounds of a full-grid voxel range
+	FBox GetRangeBounds(const FVoxelRange &Range) const;
+
+	EE_VolumeAnalysisTileState GetTileState(int32 TileIndex) const { return static_cast<EE_VolumeAnalysisTileState>(TileStates[TileIndex]); }
+
+	// Visible voxels of all written tiles, from the manifest (no tile is loaded)
+	int64 CountVisible() const;
+
+	// Full-grid voxel containing a world position; false outside the grid
+	bool GetVoxelAt(const FVector &WorldPos, FIntVector &OutVoxel) const;
+
+	// Full-grid voxels overlapping a world-space box, clamped to the grid
+	FVoxelRange GetVoxelRange(const FBox &WorldBox) const;
+
+	// Flattened full-grid index (X fastest); may exceed MAX_int32
+	int64 GetLinearIndex(const FIntVector &Voxel) const { return (int64(Voxel.Z) * Counts.Y + Voxel.Y) * Counts.X + Voxel.X; }
+
+	// Visible voxels in a full-grid range (clamped to the grid): manifest counts for covered and uniform tiles, partial scans of the rest
+	int64 CountVisibleInRange(const FVoxelRange &Range);
+
+	// FS_VoxelGrid::Raymarch over the whole tiled grid, paging in the Stored tiles the segment crosses
+	bool Raymarch(const FVector &Start, const FVector &End, bool bTargetVisible, FVector &OutHitLocation, FIntVector &OutVoxel);
+
+	// Pages the voxel's tile in if needed; false outside the grid
+	bool IsVisible(const FIntVector &Voxel);
+
+	// Origins that see the voxel; without origin masks, 1 if visible and 0 if hidden
+	uint8 GetOriginMask(const FIntVector &Voxel);
+
+	// Bound on tiles kept in memory (at least 1); evicts least recently used tiles beyond it
+	void SetMaxResidentTiles(int32 InMaxResidentTiles);
+
+	int32 GetNumResidentTiles() const { return Resident.Num(); }
+
+	static FString GetManifestPath(const FString &InDirectory);
+
+private:
+	FString GetTilePath(int32 TileIndex) const;
+
+	// Tile holding a full-grid voxel and the voxel's index inside it; INDEX_NONE outside the grid
+	int32 GetTileIndex(const FIntVector &Voxel, int32 &OutLocalIndex) const;
+
+	// Resident view of a Stored tile, mapping it (and evicting the least recently used one) if needed; null if unreadable
+	const FVolumeAnalysisMappedGrid *PageIn(int32 TileIndex);
+
+	void EvictToLimit(int32 Limit);
+
+	void SerializeManifest(FArchive &Ar);
+
+	FString Directory;
+	FVector Origin = FVector::ZeroVector;
+	FVector CellSize = FVector::ZeroVector;
+	FIntVector Counts = FIntVector::ZeroValue;
+	int32 TileSize = 0;
+	FIntVector TileCounts = FIntVector::ZeroValue;
+	bool bCompress = true;
+
+	// EE_VolumeAnalysisTileState and visible voxel count per tile, X fastest
+	TArray<uint8> TileStates;
+	TArray<int32> TileVisibleCounts;
+
+	int32 MaxResidentTiles = 64;
+	TMap<int32, TUniquePtr<FVolumeAnalysisMappedGrid>> Resident;
+	// Resident tile indices, most recently used last
+	TArray<int32> ResidentOrder;
+};
@@ -0,0 +1,170 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#include "CPP_OBJ__VolumeAnalysisHandle.h"
+#include "CPP_EN__VolumeAnalysisStats.h"
+#include "Async/Async.h"
+#include "Engine/World.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPVolHandle, Log, All);
+
+bool UCPP_OBJ__VolumeAnalysisHandle::Start(UWorld *InWorld, const FBox &Volume, int32 CountX, int32 CountY, int32 CountZ, const FS_VolumeAnalysisSettings &Settings, const FCollisionQueryParams &QueryParams)
+{
+	check(IsInGameThread());
+	if (Engine.IsValid())
+	{
+		UE_LOG(LogPVolHandle, Warning, TEXT("Start: Handle already started"));
+		return false;
+	}
+
+	Engine = MakeShared<FVolumeAnalysisEngine, ESPMode::ThreadSafe>(InWorld, Settings, QueryParams);
+	if (!Engine->Init(Volume, CountX, CountY, CountZ))
+	{
+		UE_LOG(LogPVolHandle, Warning, TEXT("Start: Could not build voxel grid (%d x %d x %d)"), CountX, CountY, CountZ);
+		Engine.Reset();
+		bFinished = true;
+		return false;
+	}
+
+	World = InWorld;
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddUObject(this, &UCPP_OBJ__VolumeAnalysisHandle::HandleWorldCleanup);
+
+	// The task keeps the engine alive; only a weak reference to the handle crosses threads
+	TSharedPtr<FVolumeAnalysisEngine, ESPMode::ThreadSafe> RunEngine = Engine;
+	TWeakObjectPtr<UCPP_OBJ__VolumeAnalysisHandle> WeakThis(this);
+	Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [RunEngine, WeakThis]()
+							 {
+								 RunEngine->RunParallel();
+								 AsyncTask(ENamedThreads::GameThread, [WeakThis]()
+										   {
+											   if (UCPP_OBJ__VolumeAnalysisHandle *Handle = WeakThis.Get())
+											   {
+												   Handle->FinishOnGameThread();
+											   } }); });
+	return true;
+}
+
+void UCPP_OBJ__VolumeAnalysisHandle::Cancel()
+{
+	if (Engine.IsValid())
+	{
+		Engine->Cancel();
+	}
+}
+
+float UCPP_OBJ__VolumeAnalysisHandle::GetProgress() const
+{
+	if (bCompleted)
+	{
+		return 1.0f;
+	}
+	return Engine.IsValid() ? Engine->GetProgress() : 0.0f;
+}
+
+bool UCPP_OBJ__VolumeAnalysisHandle::IsRunning() const
+{
+	return Engine.IsValid() && !Task.IsCompleted();
+}
+
+bool UCPP_OBJ__VolumeAnalysisHandle::IsComplete() const
+{
+	return bCompleted || (Engine.IsValid() && Engine->IsComplete());
+}
+
+bool UCPP_OBJ__VolumeAnalysisHandle::IsCancelled() const
+{
+	return !bCompleted && Engine.IsValid() && Engine->IsCancelled();
+}
+
+bool UCPP_OBJ__VolumeAnalysisHandle::Wait(float TimeoutSeconds)
+{
+	if (Task.IsValid())
+	{
+		if (TimeoutSeconds > 0.f)
+		{
+			if (!Task.Wait(FTimespan::FromSeconds(TimeoutSeconds)))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			Task.Wait();
+		}
+	}
+	if (IsInGameThread())
+	{
+		FinishOnGameThread();
+	}
+	return IsComplete();
+}
+
+FS_VoxelGrid UCPP_OBJ__VolumeAnalysisHandle::GetResultGrid() const
+{
+	return *Result;
+}
+
+TArray<FS_LinkedBox> UCPP_OBJ__VolumeAnalysisHandle::GetResults() const
+{
+	TArray<FS_LinkedBox> Boxes;
+	Result->ToLinkedBoxes(Boxes);
+	return Boxes;
+}
+
+void UCPP_OBJ__VolumeAnalysisHandle::BeginDestroy()
+{
+	CancelAndWait();
+	Super::BeginDestroy();
+}
+
+void UCPP_OBJ__VolumeAnalysisHandle::FinishOnGameThread()
+{
+	// Called after RunParallel has returned (queued from the task body, or after Wait), so the grid is no longer shared
+	if (bFinished || !Engine.IsValid())
+	{
+		return;
+	}
+	bFinished = true;
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+	WorldCleanupHandle.Reset();
+
+	if (!Engine->IsComplete())
+	{
+		return;
+	}
+	bCompleted = true;
+	SCOPE_CYCLE_COUNTER(STAT_PVol_Finalize);
+	RunSummary = Engine->GetRunSummary();
+	Result = MakeShared<FS_VoxelGrid, ESPMode::ThreadSafe>(Engine->TakeGrid());
+	const int32 Visible = Result->CountVisible();
+	UE_LOG(LogPVolHandle, Display, TEXT("Async analysis complete; boxes=%d (Visible=%d Hidden=%d); %s"), Result->Num(), Visible, Result->Num() - Visible, *RunSummary.ToString());
+	OnComplete.Broadcast(this);
+}
+
+void UCPP_OBJ__VolumeAnalysisHandle::CancelAndWait()
+{
+	Cancel();
+	if (Task.IsValid())
+	{
+		Task.Wait();
+	}
+	if (WorldCleanupHandle.IsValid())
+	{
+		FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+		WorldCleanupHandle.Reset();
+	}
+	bFinished = true;
+}
+
+void UCPP_OBJ__VolumeAnalysisHandle::HandleWorldCleanup(UWorld *InWorld, bool bSessionEnded, bool bCleanupResources)
+{
+	// Scene queries must not outlive the world they run against
+	if (InWorld == World.Get())
+	{
+		UE_LOG(LogPVolHandle, Display, TEXT("Async analysis cancelled: world is being cleaned up"));
+		CancelAndWait();
+	}
+}
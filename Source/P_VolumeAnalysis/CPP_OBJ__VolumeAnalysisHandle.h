@@ -0,0 +1,103 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "Tasks/Task.h"
+#include "CPP_EN__VolumeAnalysisEngine.h"
+#include "CPP_BPL__VolumeAnalysis.h"
+#include "CPP_OBJ__VolumeAnalysisHandle.generated.h"
+
+class UCPP_OBJ__VolumeAnalysisHandle;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnVolumeAnalysisHandleComplete, UCPP_OBJ__VolumeAnalysisHandle *, Handle);
+
+/**
+ * Handle for a volume analysis running on the task graph (no actor or world tick required).
+ * Created by UCPP_BPL__VolumeAnalysis::StartVolumeAnalysisAsync. The run is cancelled if the handle is
+ * garbage collected or its world is cleaned up, so keep a reference for as long as the results are wanted.
+ */
+UCLASS(BlueprintType)
+class P_VOLUMEANALYSIS_API UCPP_OBJ__VolumeAnalysisHandle : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	// Broadcast on the game thread once the run has completed (not on cancel)
+	UPROPERTY(BlueprintAssignable, Category = "Punal|VolumeAnalysis|Async")
+	FOnVolumeAnalysisHandleComplete OnComplete;
+
+	// Build the engine and launch the worker task; false if the world, volume or counts are invalid
+	bool Start(UWorld *InWorld, const FBox &Volume, int32 CountX, int32 CountY, int32 CountZ, const FS_VolumeAnalysisSettings &Settings, const FCollisionQueryParams &QueryParams);
+
+	// Request cancellation; remaining rows are skipped and OnComplete is not broadcast
+	UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|Async")
+	void Cancel();
+
+	// 0-1 fraction of work done
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Async")
+	float GetProgress() const;
+
+	// True while the worker task is still running
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Async")
+	bool IsRunning() const;
+
+	// True once the run finished without being cancelled
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Async")
+	bool IsComplete() const;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Async")
+	bool IsCancelled() const;
+
+	/**
+	 * Block until the run finishes (TimeoutSeconds <= 0 waits indefinitely); returns true if it completed.
+	 * On the game thread the result is adopted and OnComplete is broadcast immediately, so headless callers need no tick.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Punal|VolumeAnalysis|Async")
+	bool Wait(float TimeoutSeconds = 0.f);
+
+	// Result grid of a completed run (empty until then)
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Async")
+	FS_VoxelGrid GetResultGrid() const;
+
+	// Result as linked boxes (built on demand; empty until complete)
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Async")
+	TArray<FS_LinkedBox> GetResults() const;
+
+	// Timing and scene query counts of the completed run
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Async")
+	FS_VolumeAnalysisRunSummary GetRunSummary() const { return RunSummary; }
+
+	// Native access to the result without copying
+	const FS_VoxelGrid &GetResultGridRef() const { return *Result; }
+
+	// Shared result snapshot, e.g. for ACPP_AT_VolumeAnalysis_Base::LoadAnalysisResults without a copy
+	FVolumeAnalysisResultRef GetResultSnapshot() const { return Result; }
+
+	virtual void BeginDestroy() override;
+
+private:
+	// Game thread: adopt the engine's grid once the task is done and broadcast (idempotent)
+	void FinishOnGameThread();
+
+	// Cancel and block until the worker has returned
+	void CancelAndWait();
+
+	void HandleWorldCleanup(UWorld *InWorld, bool bSessionEnded, bool bCleanupResources);
+
+	TSharedPtr<FVolumeAnalysisEngine, ESPMode::ThreadSafe> Engine;
+	UE::Tasks::FTask Task;
+	TWeakObjectPtr<UWorld> World;
+	FDelegateHandle WorldCleanupHandle;
+
+	FVolumeAnalysisResultRef Result = MakeShared<FS_VoxelGrid, ESPMode::ThreadSafe>();
+	FS_VolumeAnalysisRunSummary RunSummary;
+
+	bool bFinished = false;
+	bool bCompleted = false;
+};
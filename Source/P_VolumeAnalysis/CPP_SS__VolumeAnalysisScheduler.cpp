@@ -0,0 +1,232 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#include "CPP_SS__VolumeAnalysisScheduler.h"
+#include "CPP_AT_VolumeAnalysis__Base.h"
+#include "CPP_EN__VolumeAnalysisStats.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPVolScheduler, Log, All);
+
+static bool IsSameRun(const FVolumeAnalysisScheduledJob &Job, const FS_VoxelGrid &Layout, const FS_VolumeAnalysisSettings &Settings)
+{
+	return Job.bUniform && Layout.IsUniform() && Job.Counts == FIntVector(Layout.CountX, Layout.CountY, Layout.CountZ) && Job.Origin.Equals(Layout.Origin) && Job.CellSize.Equals(Layout.CellSize) && FS_VolumeAnalysisSettings::StaticStruct()->CompareScriptStruct(&Job.Settings, &Settings, PPF_None);
+}
+
+int32 UCPP_SS__VolumeAnalysisScheduler::GetNumSharedRuns() const
+{
+	int32 Count = 0;
+	for (const FVolumeAnalysisScheduledJob &Job : Jobs)
+	{
+		Count += Job.Followers.Num();
+	}
+	return Count;
+}
+
+bool UCPP_SS__VolumeAnalysisScheduler::SubmitJob(ACPP_AT_VolumeAnalysis_Base *Actor, const FS_VoxelGrid &Layout, const FS_VolumeAnalysisSettings &Settings, bool bIncremental, bool bParallel)
+{
+	check(Actor);
+	CancelJob(Actor);
+
+	// Incremental updates patch each actor's own previous result, so only full runs can be shared
+	if (!bIncremental)
+	{
+		for (FVolumeAnalysisScheduledJob &Job : Jobs)
+		{
+			if (!Job.bIncremental && Job.Actor.IsValid() && IsSameRun(Job, Layout, Settings))
+			{
+				Job.Followers.AddUnique(Actor);
+				UE_LOG(LogPVolScheduler, Verbose, TEXT("%s shares the run of %s"), *Actor->GetName(), *Job.Actor->GetName());
+				return false;
+			}
+		}
+	}
+
+	FVolumeAnalysisScheduledJob &Job = Jobs.AddDefaulted_GetRef();
+	Job.Actor = Actor;
+	Job.Origin = Layout.Origin;
+	Job.CellSize = Layout.CellSize;
+	Job.Counts = FIntVector(Layout.CountX, Layout.CountY, Layout.CountZ);
+	Job.Settings = Settings;
+	Job.bUniform = Layout.IsUniform();
+	Job.bIncremental = bIncremental;
+	Job.bParallel = bParallel;
+	Job.Sequence = NextSequence++;
+	return true;
+}
+
+void UCPP_SS__VolumeAnalysisScheduler::CompleteJob(ACPP_AT_VolumeAnalysis_Base *Actor)
+{
+	const int32 Index = FindJob(Actor);
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+	const TArray<TWeakObjectPtr<ACPP_AT_VolumeAnalysis_Base>> Followers = RemoveJob(Index);
+	const FVolumeAnalysisResultRef Result = Actor->GetResultSnapshot();
+	const FS_VolumeAnalysisRunSummary Summary = Actor->GetLastRunSummary();
+	for (const TWeakObjectPtr<ACPP_AT_VolumeAnalysis_Base> &Follower : Followers)
+	{
+		if (Follower.IsValid())
+		{
+			Follower->AdoptSharedResult(Result, Summary);
+		}
+	}
+}
+
+void UCPP_SS__VolumeAnalysisScheduler::CancelJob(ACPP_AT_VolumeAnalysis_Base *Actor)
+{
+	const int32 Index = FindJob(Actor);
+	if (Index == INDEX_NONE)
+	{
+		// Not running a job itself; it may have been waiting on someone else's
+		for (FVolumeAnalysisScheduledJob &Job : Jobs)
+		{
+			Job.Followers.Remove(Actor);
+		}
+		return;
+	}
+	// Nobody produces the shared result any more; the first follower to resubmit becomes the new owner
+	for (const TWeakObjectPtr<ACPP_AT_VolumeAnalysis_Base> &Follower : RemoveJob(Index))
+	{
+		if (Follower.IsValid())
+		{
+			Follower->StopAnalysis();
+			Follower->StartAnalysis();
+		}
+	}
+}
+
+void UCPP_SS__VolumeAnalysisScheduler::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UCPP_SS__VolumeAnalysisScheduler::Tick);
+
+	// Actors destroyed without stopping their run
+	for (int32 Index = Jobs.Num() - 1; Index >= 0; --Index)
+	{
+		if (!Jobs[Index].Actor.IsValid())
+		{
+			for (const TWeakObjectPtr<ACPP_AT_VolumeAnalysis_Base> &Follower : RemoveJob(Index))
+			{
+				if (Follower.IsValid())
+				{
+					Follower->StopAnalysis();
+					Follower->StartAnalysis();
+				}
+			}
+		}
+	}
+
+	LaunchQueuedParallelJobs();
+	StepGameThreadJobs();
+}
+
+TStatId UCPP_SS__VolumeAnalysisScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCPP_SS__VolumeAnalysisScheduler, STATGROUP_VolumeAnalysis);
+}
+
+void UCPP_SS__VolumeAnalysisScheduler::Deinitialize()
+{
+	// Actors stop their own runs in EndPlay; nothing is restarted while the world goes away
+	Jobs.Reset();
+	Super::Deinitialize();
+}
+
+bool UCPP_SS__VolumeAnalysisScheduler::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+int32 UCPP_SS__VolumeAnalysisScheduler::FindJob(const ACPP_AT_VolumeAnalysis_Base *Actor) const
+{
+	return Jobs.IndexOfByPredicate([Actor](const FVolumeAnalysisScheduledJob &Job)
+								   { return Job.Actor.Get() == Actor; });
+}
+
+TArray<TWeakObjectPtr<ACPP_AT_VolumeAnalysis_Base>> UCPP_SS__VolumeAnalysisScheduler::RemoveJob(int32 Index)
+{
+	TArray<TWeakObjectPtr<ACPP_AT_VolumeAnalysis_Base>> Followers = MoveTemp(Jobs[Index].Followers);
+	Jobs.RemoveAt(Index);
+	return Followers;
+}
+
+int32 UCPP_SS__VolumeAnalysisScheduler::GetJobPriority(const FVolumeAnalysisScheduledJob &Job) const
+{
+	int32 Priority = Job.Actor.IsValid() ? Job.Actor->SchedulerPriority : 1;
+	for (const TWeakObjectPtr<ACPP_AT_VolumeAnalysis_Base> &Follower : Job.Followers)
+	{
+		if (Follower.IsValid())
+		{
+			Priority = FMath::Max(Priority, Follower->SchedulerPriority);
+		}
+	}
+	return FMath::Max(Priority, 1);
+}
+
+void UCPP_SS__VolumeAnalysisScheduler::LaunchQueuedParallelJobs()
+{
+	int32 NumRunning = 0;
+	TArray<int32, TInlineAllocator<16>> Queued;
+	for (int32 Index = 0; Index < Jobs.Num(); ++Index)
+	{
+		if (Jobs[Index].bParallel)
+		{
+			if (Jobs[Index].bLaunched)
+			{
+				++NumRunning;
+			}
+			else
+			{
+				Queued.Add(Index);
+			}
+		}
+	}
+	if (Queued.Num() == 0 || NumRunning >= MaxConcurrentParallelJobs)
+	{
+		return;
+	}
+
+	Queued.Sort([this](int32 A, int32 B)
+				{
+		const int32 PriorityA = GetJobPriority(Jobs[A]);
+		const int32 PriorityB = GetJobPriority(Jobs[B]);
+		return PriorityA != PriorityB ? PriorityA > PriorityB : Jobs[A].Sequence < Jobs[B].Sequence; });
+	for (const int32 Index : Queued)
+	{
+		if (NumRunning >= MaxConcurrentParallelJobs)
+		{
+			break;
+		}
+		Jobs[Index].bLaunched = true;
+		++NumRunning;
+		Jobs[Index].Actor->LaunchScheduledParallelRun();
+	}
+}
+
+void UCPP_SS__VolumeAnalysisScheduler::StepGameThreadJobs()
+{
+	// Collected up front: a step that finishes a run removes its job (and may start others)
+	TArray<TPair<TWeakObjectPtr<ACPP_AT_VolumeAnalysis_Base>, int32>, TInlineAllocator<16>> Steps;
+	int64 TotalPriority = 0;
+	for (const FVolumeAnalysisScheduledJob &Job : Jobs)
+	{
+		if (!Job.bParallel && Job.Actor.IsValid())
+		{
+			const int32 Priority = GetJobPriority(Job);
+			Steps.Emplace(Job.Actor, Priority);
+			TotalPriority += Priority;
+		}
+	}
+	const double FrameBudgetSeconds = FMath::Max(FrameBudgetMs, 0.1f) * 0.001;
+	for (const TPair<TWeakObjectPtr<ACPP_AT_VolumeAnalysis_Base>, int32> &Step : Steps)
+	{
+		if (ACPP_AT_VolumeAnalysis_Base *Actor = Step.Key.Get())
+		{
+			Actor->StepScheduledRun(FrameBudgetSeconds * Step.Value / TotalPriority);
+		}
+	}
+}
@@ -0,0 +1,101 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CPP_EN__VolumeAnalysisEngine.h"
+#include "CPP_SS__VolumeAnalysisScheduler.generated.h"
+
+class ACPP_AT_VolumeAnalysis_Base;
+
+// One run owned by the scheduler, plus the actors waiting for its result because they asked for the identical run
+struct FVolumeAnalysisScheduledJob
+{
+	TWeakObjectPtr<ACPP_AT_VolumeAnalysis_Base> Actor;
+	TArray<TWeakObjectPtr<ACPP_AT_VolumeAnalysis_Base>> Followers;
+
+	// Grid layout and settings of the run (what makes two runs identical)
+	FVector Origin = FVector::ZeroVector;
+	FVector CellSize = FVector::ZeroVector;
+	FIntVector Counts = FIntVector::ZeroValue;
+	FS_VolumeAnalysisSettings Settings;
+	// Non-uniform layouts are never shared (their cell edges are not kept for comparison)
+	bool bUniform = true;
+
+	bool bIncremental = false;
+	bool bParallel = false;
+
+	// Parallel runs only: holds a worker slot
+	bool bLaunched = false;
+
+	// Submission order; breaks priority ties first come, first served
+	uint64 Sequence = 0;
+};
+
+/**
+ * Runs every ACPP_AT_VolumeAnalysis_Base with bUseSharedScheduler from one queue instead of each actor stepping
+ * itself. Game-thread runs split FrameBudgetMs per frame in proportion to their SchedulerPriority; parallel runs
+ * are launched highest priority first with at most MaxConcurrentParallelJobs on the worker pool at once. A full run
+ * whose grid layout and settings match one already in flight is not traced again: the actor waits and adopts the
+ * same result snapshot.
+ */
+UCLASS(Config = Game)
+class P_VOLUMEANALYSIS_API UCPP_SS__VolumeAnalysisScheduler : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Game-thread time per frame shared by all scheduled game-thread runs
+	UPROPERTY(Config, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Scheduler", meta = (ClampMin = "0.1", UIMin = "0.1", UIMax = "16.0", Units = "ms"))
+	float FrameBudgetMs = 4.f;
+
+	// Parallel runs allowed on the worker pool at once; the rest wait in the queue
+	UPROPERTY(Config, BlueprintReadWrite, Category = "Punal|VolumeAnalysis|Scheduler", meta = (ClampMin = "1", UIMin = "1"))
+	int32 MaxConcurrentParallelJobs = 2;
+
+	// Runs queued or in progress (actors sharing another run's result are not counted)
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Scheduler")
+	int32 GetNumJobs() const { return Jobs.Num(); }
+
+	// Actors waiting on an identical run instead of tracing their own
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Punal|VolumeAnalysis|Scheduler")
+	int32 GetNumSharedRuns() const;
+
+	// Called by the actor when a run starts. Returns false if it joined an identical run already in flight; the
+	// actor then waits for that run's result.
+	bool SubmitJob(ACPP_AT_VolumeAnalysis_Base *Actor, const FS_VoxelGrid &Layout, const FS_VolumeAnalysisSettings &Settings, bool bIncremental, bool bParallel);
+
+	// Called by the actor once its run produced results; actors sharing the run adopt the same snapshot
+	void CompleteJob(ACPP_AT_VolumeAnalysis_Base *Actor);
+
+	// Called by the actor when its run stops without results or it stops waiting on a shared run.
+	// Actors that were sharing a cancelled run start their own.
+	void CancelJob(ACPP_AT_VolumeAnalysis_Base *Actor);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	int32 FindJob(const ACPP_AT_VolumeAnalysis_Base *Actor) const;
+
+	// Remove a job and return the actors that were sharing it
+	TArray<TWeakObjectPtr<ACPP_AT_VolumeAnalysis_Base>> RemoveJob(int32 Index);
+
+	// Highest SchedulerPriority among the job's owner and followers
+	int32 GetJobPriority(const FVolumeAnalysisScheduledJob &Job) const;
+
+	void LaunchQueuedParallelJobs();
+	void StepGameThreadJobs();
+
+	TArray<FVolumeAnalysisScheduledJob> Jobs;
+	uint64 NextSequence = 0;
+};
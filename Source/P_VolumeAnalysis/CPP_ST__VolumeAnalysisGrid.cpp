@@ -0,0 +1,605 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#include "CPP_ST__VolumeAnalysisGrid.h"
+#include "CPP_BPL__VolumeAnalysis.h"
+#include "Algo/BinarySearch.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+void FS_VoxelGrid::Init(const FBox &Box, int32 InCountX, int32 InCountY, int32 InCountZ)
+{
+	Reset();
+	if (!Box.IsValid || InCountX <= 0 || InCountY <= 0 || InCountZ <= 0)
+	{
+		return;
+	}
+
+	Origin = Box.Min;
+	CountX = InCountX;
+	CountY = InCountY;
+	CountZ = InCountZ;
+	const FVector Size = Box.GetSize();
+	CellSize = FVector(Size.X / CountX, Size.Y / CountY, Size.Z / CountZ);
+
+	VisibilityBits.SetNumZeroed(FMath::DivideAndRoundUp(Num(), 32));
+}
+
+void FS_VoxelGrid::InitLayout(const FS_VoxelGrid &Layout)
+{
+	Reset();
+	if (!Layout.IsValid())
+	{
+		return;
+	}
+	Origin = Layout.Origin;
+	CellSize = Layout.CellSize;
+	CountX = Layout.CountX;
+	CountY = Layout.CountY;
+	CountZ = Layout.CountZ;
+	EdgesX = Layout.EdgesX;
+	EdgesY = Layout.EdgesY;
+	EdgesZ = Layout.EdgesZ;
+	VisibilityBits.SetNumZeroed(FMath::DivideAndRoundUp(Num(), 32));
+}
+
+bool FS_VoxelGrid::SetAxisEdges(int32 Axis, TArray<double> &&Edges)
+{
+	if (!IsValid() || Axis < 0 || Axis > 2)
+	{
+		return false;
+	}
+	const int32 Count = FIntVector(CountX, CountY, CountZ)[Axis];
+	if (Edges.Num() != Count + 1)
+	{
+		return false;
+	}
+	const double Min = GetEdge(Axis, 0);
+	const double Max = GetEdge(Axis, Count);
+	const double Tolerance = 1e-6 * FMath::Max(Max - Min, 1.0);
+	if (!FMath::IsNearlyEqual(Edges[0], Min, Tolerance) || !FMath::IsNearlyEqual(Edges[Count], Max, Tolerance))
+	{
+		return false;
+	}
+	const double Even = (Max - Min) / Count;
+	double Smallest = Even;
+	bool bEven = true;
+	for (int32 I = 0; I < Count; ++I)
+	{
+		const double Width = Edges[I + 1] - Edges[I];
+		if (Width <= UE_DOUBLE_SMALL_NUMBER)
+		{
+			return false;
+		}
+		Smallest = FMath::Min(Smallest, Width);
+		bEven &= FMath::IsNearlyEqual(Width, Even, 1e-6 * Even);
+	}
+
+	// The grid's extent stays exact; only the boundaries in between move
+	Edges[0] = Min;
+	Edges[Count] = Max;
+	TArray<double> &AxisEdges = Axis == 0 ? EdgesX : (Axis == 1 ? EdgesY : EdgesZ);
+	if (bEven)
+	{
+		AxisEdges.Empty();
+		CellSize[Axis] = Even;
+	}
+	else
+	{
+		AxisEdges = MoveTemp(Edges);
+		CellSize[Axis] = Smallest;
+	}
+	return true;
+}
+
+void FS_VoxelGrid::Reset()
+{
+	Origin = FVector::ZeroVector;
+	CellSize = FVector::ZeroVector;
+	CountX = CountY = CountZ = 0;
+	VisibilityBits.Reset();
+	Flags.Reset();
+	OriginMasks.Reset();
+	EdgesX.Reset();
+	EdgesY.Reset();
+	EdgesZ.Reset();
+}
+
+int32 FS_VoxelGrid::GetAxisCell(int32 Axis, double WorldCoord) const
+{
+	const TArray<double> &Edges = GetAxisEdges(Axis);
+	if (Edges.Num() == 0)
+	{
+		return FMath::FloorToInt((WorldCoord - Origin[Axis]) / CellSize[Axis]);
+	}
+	// First edge above the coordinate, minus one: -1 below the grid, Count at or past its far face
+	return Algo::UpperBound(Edges, WorldCoord) - 1;
+}
+
+void FS_VoxelGrid::ResetVisibility()
+{
+	FMemory::Memzero(VisibilityBits.GetData(), VisibilityBits.Num() * sizeof(uint32));
+	FMemory::Memzero(OriginMasks.GetData(), OriginMasks.Num());
+}
+
+int32 FS_VoxelGrid::CountVisible() const
+{
+	// Trailing bits of the last word are never set, so a plain popcount is exact
+	int32 Count = 0;
+	for (const uint32 Word : VisibilityBits)
+	{
+		Count += FMath::CountBits(Word);
+	}
+	return Count;
+}
+
+void FS_VoxelGrid::AllocateFlags()
+{
+	Flags.SetNumZeroed(Num());
+}
+
+void FS_VoxelGrid::ClearFlags()
+{
+	FMemory::Memzero(Flags.GetData(), Flags.Num());
+}
+
+FBox FS_VoxelGrid::GetBounds() const
+{
+	if (!IsValid())
+	{
+		return FBox(EForceInit::ForceInitToZero);
+	}
+	return FBox(Origin, FVector(GetEdge(0, CountX), GetEdge(1, CountY), GetEdge(2, CountZ)));
+}
+
+FBox FS_VoxelGrid::GetRangeBounds(const FVoxelRange &Range) const
+{
+	return FBox(FVector(GetEdge(0, Range.Min.X), GetEdge(1, Range.Min.Y), GetEdge(2, Range.Min.Z)), FVector(GetEdge(0, Range.Max.X), GetEdge(1, Range.Max.Y), GetEdge(2, Range.Max.Z)));
+}
+
+FVoxelRange FS_VoxelGrid::CopyFrom(const FS_VoxelGrid &Part)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FS_VoxelGrid::CopyFrom);
+	if (!IsValid() || !Part.IsValid() || !IsUniform() || !Part.IsUniform() || !Part.CellSize.Equals(CellSize, 1e-4 * CellSize.GetMin()))
+	{
+		return FVoxelRange();
+	}
+	// Offset of the part in whole voxels; its origin must sit on a lattice point (up to float noise)
+	const FIntVector Counts(CountX, CountY, CountZ);
+	const FIntVector PartCounts(Part.CountX, Part.CountY, Part.CountZ);
+	FIntVector Offset;
+	FVoxelRange Range;
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		const double Cells = (Part.Origin[Axis] - Origin[Axis]) / CellSize[Axis];
+		Offset[Axis] = FMath::RoundToInt32(Cells);
+		if (!FMath::IsNearlyEqual(Cells, static_cast<double>(Offset[Axis]), 1e-3))
+		{
+			return FVoxelRange();
+		}
+		Range.Min[Axis] = FMath::Max(Offset[Axis], 0);
+		Range.Max[Axis] = FMath::Min(Offset[Axis] + PartCounts[Axis], Counts[Axis]);
+	}
+	if (Range.IsEmpty())
+	{
+		return FVoxelRange();
+	}
+
+	const bool bMasks = Part.HasOriginMasks();
+	if (bMasks && !HasOriginMasks())
+	{
+		OriginMasks.SetNumZeroed(Num());
+	}
+	for (int32 Z = Range.Min.Z; Z < Range.Max.Z; ++Z)
+	{
+		for (int32 Y = Range.Min.Y; Y < Range.Max.Y; ++Y)
+		{
+			int32 Src = Part.Index(Range.Min.X - Offset.X, Y - Offset.Y, Z - Offset.Z);
+			int32 Dst = Index(Range.Min.X, Y, Z);
+			for (int32 X = Range.Min.X; X < Range.Max.X; ++X, ++Src, ++Dst)
+			{
+				SetVisible(Dst, Part.IsVisible(Src));
+				if (bMasks)
+				{
+					OriginMasks[Dst] = Part.OriginMasks[Src];
+				}
+			}
+		}
+	}
+	return Range;
+}
+
+FVoxelRange FS_VoxelGrid::GetVoxelRange(const FBox &WorldBox, int32 Dilation) const
+{
+	if (!IsValid() || !WorldBox.IsValid)
+	{
+		return FVoxelRange();
+	}
+	const FIntVector Counts(CountX, CountY, CountZ);
+	FVoxelRange Range;
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		if (CellSize[Axis] <= KINDA_SMALL_NUMBER)
+		{
+			Range.Min[Axis] = 0;
+			Range.Max[Axis] = Counts[Axis];
+			continue;
+		}
+		Range.Min[Axis] = FMath::Clamp(GetAxisCell(Axis, WorldBox.Min[Axis]) - Dilation, 0, Counts[Axis]);
+		Range.Max[Axis] = FMath::Clamp(GetAxisCell(Axis, WorldBox.Max[Axis]) + 1 + Dilation, 0, Counts[Axis]);
+	}
+	return Range;
+}
+
+int32 FS_VoxelGrid::GetVoxelIndexAt(const FVector &WorldPos) const
+{
+	if (!IsValid())
+	{
+		return INDEX_NONE;
+	}
+	FIntVector Cell;
+	const FIntVector Counts(CountX, CountY, CountZ);
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		if (CellSize[Axis] <= KINDA_SMALL_NUMBER)
+		{
+			return INDEX_NONE;
+		}
+		Cell[Axis] = GetAxisCell(Axis, WorldPos[Axis]);
+		if (Cell[Axis] < 0 || Cell[Axis] >= Counts[Axis])
+		{
+			return INDEX_NONE;
+		}
+	}
+	return Index(Cell.X, Cell.Y, Cell.Z);
+}
+
+int32 FS_VoxelGrid::CountBitsInRange(const uint32 *Words, int32 Begin, int32 End)
+{
+	const int32 FirstWord = Begin >> 5;
+	const int32 LastWord = (End - 1) >> 5;
+	const uint32 FirstMask = ~0u << (Begin & 31);
+	const uint32 LastMask = ~0u >> (31 - ((End - 1) & 31));
+	if (FirstWord == LastWord)
+	{
+		return FMath::CountBits(Words[FirstWord] & FirstMask & LastMask);
+	}
+	int32 Count = FMath::CountBits(Words[FirstWord] & FirstMask) + FMath::CountBits(Words[LastWord] & LastMask);
+	for (int32 Word = FirstWord + 1; Word < LastWord; ++Word)
+	{
+		Count += FMath::CountBits(Words[Word]);
+	}
+	return Count;
+}
+
+int32 FS_VoxelGrid::CountVisibleInRange(const FVoxelRange &Range) const
+{
+	if (!IsValid() || Range.IsEmpty())
+	{
+		return 0;
+	}
+	const uint32 *Words = VisibilityBits.GetData();
+	int32 Count = 0;
+	if (Range.Min.X == 0 && Range.Max.X == CountX)
+	{
+		// Full-width ranges are one contiguous run of bits per Z slice
+		for (int32 Z = Range.Min.Z; Z < Range.Max.Z; ++Z)
+		{
+			Count += CountBitsInRange(Words, Index(0, Range.Min.Y, Z), Index(0, Range.Max.Y - 1, Z) + CountX);
+		}
+		return Count;
+	}
+	for (int32 Z = Range.Min.Z; Z < Range.Max.Z; ++Z)
+	{
+		for (int32 Y = Range.Min.Y; Y < Range.Max.Y; ++Y)
+		{
+			const int32 RowStart = Index(Range.Min.X, Y, Z);
+			Count += CountBitsInRange(Words, RowStart, RowStart + (Range.Max.X - Range.Min.X));
+		}
+	}
+	return Count;
+}
+
+bool FS_VoxelGrid::Raymarch(const FVector &Start, const FVector &End, bool bTargetVisible, FVector &OutHitLocation, int32 &OutVoxelIndex) const
+{
+	OutVoxelIndex = INDEX_NONE;
+	if (!IsValid() || CellSize.GetMin() <= KINDA_SMALL_NUMBER)
+	{
+		return false;
+	}
+
+	// Clip the segment to the grid bounds (slab test, in segment parameter space)
+	const FVector Dir = End - Start;
+	const FBox Bounds = GetBounds();
+	double TMin = 0.0;
+	double TMax = 1.0;
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		if (FMath::Abs(Dir[Axis]) < UE_DOUBLE_SMALL_NUMBER)
+		{
+			if (Start[Axis] < Bounds.Min[Axis] || Start[Axis] > Bounds.Max[Axis])
+			{
+				return false;
+			}
+			continue;
+		}
+		double T0 = (Bounds.Min[Axis] - Start[Axis]) / Dir[Axis];
+		double T1 = (Bounds.Max[Axis] - Start[Axis]) / Dir[Axis];
+		if (T0 > T1)
+		{
+			Swap(T0, T1);
+		}
+		TMin = FMath::Max(TMin, T0);
+		TMax = FMath::Min(TMax, T1);
+		if (TMin > TMax)
+		{
+			return false;
+		}
+	}
+
+	// Entry voxel, then per-axis step direction and parameter of the next boundary (taken from the cell edges, so
+	// non-uniform axes step exactly like uniform ones)
+	const FIntVector Counts(CountX, CountY, CountZ);
+	const FVector Entry = Start + Dir * TMin;
+	FIntVector Cell;
+	FIntVector Step;
+	FVector TNext;
+	const auto NextBoundary = [this, &Cell, &Step, &Start, &Dir](int32 Axis) -> double
+	{
+		return (GetEdge(Axis, Cell[Axis] + (Step[Axis] > 0 ? 1 : 0)) - Start[Axis]) / Dir[Axis];
+	};
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		// Clamp guards against round-off when the entry point sits on the far face
+		Cell[Axis] = FMath::Clamp(GetAxisCell(Axis, Entry[Axis]), 0, Counts[Axis] - 1);
+		if (FMath::Abs(Dir[Axis]) < UE_DOUBLE_SMALL_NUMBER)
+		{
+			Step[Axis] = 0;
+			TNext[Axis] = UE_DOUBLE_BIG_NUMBER;
+			continue;
+		}
+		Step[Axis] = Dir[Axis] > 0.0 ? 1 : -1;
+		TNext[Axis] = NextBoundary(Axis);
+	}
+
+	double T = TMin;
+	while (true)
+	{
+		const int32 VoxelIndex = Index(Cell.X, Cell.Y, Cell.Z);
+		if (IsVisible(VoxelIndex) == bTargetVisible)
+		{
+			OutHitLocation = Start + Dir * T;
+			OutVoxelIndex = VoxelIndex;
+			return true;
+		}
+		const int32 Axis = (TNext.X < TNext.Y) ? (TNext.X < TNext.Z ? 0 : 2) : (TNext.Y < TNext.Z ? 1 : 2);
+		T = TNext[Axis];
+		Cell[Axis] += Step[Axis];
+		if (T > TMax || Cell[Axis] < 0 || Cell[Axis] >= Counts[Axis])
+		{
+			return false;
+		}
+		TNext[Axis] = NextBoundary(Axis);
+	}
+}
+
+void FVolumeAnalysisSummedVolume::Build(const FS_VoxelGrid &Grid)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FVolumeAnalysisSummedVolume::Build);
+	Reset();
+	if (!Grid.IsValid())
+	{
+		return;
+	}
+	// The extra face per axis can push a grid that fits int32 past it; every index below stays under this size
+	const int64 TableSize = (int64(Grid.CountX) + 1) * (int64(Grid.CountY) + 1) * (int64(Grid.CountZ) + 1);
+	if (TableSize > MAX_int32)
+	{
+		return;
+	}
+	SizeX = Grid.CountX + 1;
+	SizeY = Grid.CountY + 1;
+	SizeZ = Grid.CountZ + 1;
+	Sums.SetNumZeroed(static_cast<int32>(TableSize));
+
+	// Running sum along X per row, then add the row/slice below: S(x,y,z) = Row + S(x,y-1,z) + S(x,y,z-1) - S(x,y-1,z-1)
+	const int32 SliceStride = SizeX * SizeY;
+	for (int32 Z = 1; Z < SizeZ; ++Z)
+	{
+		for (int32 Y = 1; Y < SizeY; ++Y)
+		{
+			int32 RowSum = 0;
+			int32 VoxelIndex = Grid.Index(0, Y - 1, Z - 1);
+			int32 *Out = &Sums[(Z * SizeY + Y) * SizeX + 1];
+			for (int32 X = 1; X < SizeX; ++X, ++VoxelIndex, ++Out)
+			{
+				RowSum += Grid.IsVisible(VoxelIndex) ? 1 : 0;
+				*Out = RowSum + *(Out - SizeX) + *(Out - SliceStride) - *(Out - SizeX - SliceStride);
+			}
+		}
+	}
+}
+
+void FVolumeAnalysisSummedVolume::Reset()
+{
+	SizeX = SizeY = SizeZ = 0;
+	Sums.Empty();
+}
+
+int32 FVolumeAnalysisSummedVolume::CountVisible(const FVoxelRange &Range) const
+{
+	if (!IsValid())
+	{
+		return 0;
+	}
+	const FIntVector Min(FMath::Clamp(Range.Min.X, 0, SizeX - 1), FMath::Clamp(Range.Min.Y, 0, SizeY - 1), FMath::Clamp(Range.Min.Z, 0, SizeZ - 1));
+	const FIntVector Max(FMath::Clamp(Range.Max.X, 0, SizeX - 1), FMath::Clamp(Range.Max.Y, 0, SizeY - 1), FMath::Clamp(Range.Max.Z, 0, SizeZ - 1));
+	if (FVoxelRange(Min, Max).IsEmpty())
+	{
+		return 0;
+	}
+	return At(Max.X, Max.Y, Max.Z) - At(Min.X, Max.Y, Max.Z) - At(Max.X, Min.Y, Max.Z) - At(Max.X, Max.Y, Min.Z) + At(Min.X, Min.Y, Max.Z) + At(Min.X, Max.Y, Min.Z) + At(Max.X, Min.Y, Min.Z) - At(Min.X, Min.Y, Min.Z);
+}
+
+void FS_VoxelGrid::MakeLinkedBox(int32 InIndex, FS_LinkedBox &OutBox) const
+{
+	const FBox Cell = GetCellBox(InIndex);
+	const FVector &P0 = Cell.Min;
+	const FVector &P1 = Cell.Max;
+
+	OutBox = FS_LinkedBox();
+	OutBox.VisibilityMask = GetOriginMask(InIndex);
+
+	OutBox.SetBoxPoint(EE_Box_8Point::Bottom_Backward_Left, FVector(P0.X, P0.Y, P0.Z));
+	OutBox.SetBoxPoint(EE_Box_8Point::Bottom_Backward_Right, FVector(P1.X, P0.Y, P0.Z));
+	OutBox.SetBoxPoint(EE_Box_8Point::Bottom_Forward_Left, FVector(P0.X, P1.Y, P0.Z));
+	OutBox.SetBoxPoint(EE_Box_8Point::Bottom_Forward_Right, FVector(P1.X, P1.Y, P0.Z));
+
+	OutBox.SetBoxPoint(EE_Box_8Point::Top_Backward_Left, FVector(P0.X, P0.Y, P1.Z));
+	OutBox.SetBoxPoint(EE_Box_8Point::Top_Backward_Right, FVector(P1.X, P0.Y, P1.Z));
+	OutBox.SetBoxPoint(EE_Box_8Point::Top_Forward_Left, FVector(P0.X, P1.Y, P1.Z));
+	OutBox.SetBoxPoint(EE_Box_8Point::Top_Forward_Right, FVector(P1.X, P1.Y, P1.Z));
+}
+
+void FS_VoxelGrid::ToLinkedBoxes(TArray<FS_LinkedBox> &OutBoxes) const
+{
+	OutBoxes.Reset();
+	const int32 Total = Num();
+	if (Total <= 0)
+	{
+		return;
+	}
+	// Same lattice layout and order as the grid, so neighbouring boxes share their corner points
+	if (IsUniform())
+	{
+		UCPP_BPL__VolumeAnalysis::GenerateVoxelGridBoxes_ByCounts(GetBounds(), CountX, CountY, CountZ, OutBoxes);
+	}
+	else
+	{
+		TArray<double> AxisEdges[3];
+		const FIntVector Counts(CountX, CountY, CountZ);
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			AxisEdges[Axis].SetNumUninitialized(Counts[Axis] + 1);
+			for (int32 I = 0; I <= Counts[Axis]; ++I)
+			{
+				AxisEdges[Axis][I] = GetEdge(Axis, I);
+			}
+		}
+		UCPP_BPL__VolumeAnalysis::GenerateVoxelGridBoxes_ByEdges(AxisEdges[0], AxisEdges[1], AxisEdges[2], OutBoxes);
+	}
+	for (int32 i = 0; i < Total; ++i)
+	{
+		OutBoxes[i].VisibilityMask = GetOriginMask(i);
+	}
+}
+
+bool FS_VoxelGrid::InitFromLinkedBoxes(const TArray<FS_LinkedBox> &InBoxes)
+{
+	Reset();
+	if (InBoxes.Num() == 0)
+	{
+		return false;
+	}
+
+	// Overall bounds and the smallest box extent per axis (sets the tolerance for matching boundaries)
+	TArray<FBox> BoxBounds;
+	BoxBounds.Reserve(InBoxes.Num());
+	FBox Bounds(EForceInit::ForceInit);
+	FVector SmallestSize(UE_DOUBLE_BIG_NUMBER);
+	for (const FS_LinkedBox &Box : InBoxes)
+	{
+		const FBox &BoxAABB = BoxBounds.Add_GetRef(UCPP_BPL__VolumeAnalysis::LinkedBox_GetAABB(Box));
+		Bounds += BoxAABB;
+		SmallestSize = SmallestSize.ComponentMin(BoxAABB.GetSize());
+	}
+	if (!Bounds.IsValid || SmallestSize.GetMin() <= KINDA_SMALL_NUMBER)
+	{
+		return false;
+	}
+	const FVector Tolerance = SmallestSize * 1e-3;
+
+	// Cell boundaries per axis are the distinct box minima plus the far face, so graded grids rebuild their edges
+	TArray<double> AxisEdges[3];
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		TArray<double> Mins;
+		Mins.Reserve(BoxBounds.Num());
+		for (const FBox &BoxAABB : BoxBounds)
+		{
+			Mins.Add(BoxAABB.Min[Axis]);
+		}
+		Mins.Sort();
+		TArray<double> &Edges = AxisEdges[Axis];
+		for (const double Min : Mins)
+		{
+			if (Edges.Num() == 0 || Min - Edges.Last() > Tolerance[Axis])
+			{
+				Edges.Add(Min);
+			}
+		}
+		Edges.Add(Bounds.Max[Axis]);
+	}
+	const int32 NX = AxisEdges[0].Num() - 1;
+	const int32 NY = AxisEdges[1].Num() - 1;
+	const int32 NZ = AxisEdges[2].Num() - 1;
+	if (int64(NX) * NY * NZ != InBoxes.Num())
+	{
+		return false;
+	}
+
+	Init(Bounds, NX, NY, NZ);
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		if (!SetAxisEdges(Axis, MoveTemp(AxisEdges[Axis])))
+		{
+			Reset();
+			return false;
+		}
+	}
+	// Masks above 1 carry per-origin line of sight; keep them rather than collapsing to visible/hidden
+	const bool bOriginMasks = InBoxes.ContainsByPredicate([](const FS_LinkedBox &Box)
+														  { return Box.VisibilityMask > 1; });
+	if (bOriginMasks)
+	{
+		OriginMasks.SetNumZeroed(Num());
+	}
+
+	// Every box must fill exactly one cell and no cell may be claimed twice; with as many boxes as cells, that also
+	// leaves no cell unset
+	TBitArray<> Covered(false, Num());
+	for (int32 BoxIndex = 0; BoxIndex < InBoxes.Num(); ++BoxIndex)
+	{
+		const FBox &BoxAABB = BoxBounds[BoxIndex];
+		const FVector Center = BoxAABB.GetCenter();
+		FIntVector Cell;
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			Cell[Axis] = FMath::Clamp(GetAxisCell(Axis, Center[Axis]), 0, FIntVector(CountX, CountY, CountZ)[Axis] - 1);
+			if (!FMath::IsNearlyEqual(BoxAABB.Min[Axis], GetEdge(Axis, Cell[Axis]), Tolerance[Axis]) || !FMath::IsNearlyEqual(BoxAABB.Max[Axis], GetEdge(Axis, Cell[Axis] + 1), Tolerance[Axis]))
+			{
+				Reset();
+				return false;
+			}
+		}
+		const int32 VoxelIndex = Index(Cell.X, Cell.Y, Cell.Z);
+		if (Covered[VoxelIndex])
+		{
+			Reset();
+			return false;
+		}
+		Covered[VoxelIndex] = true;
+		const FS_LinkedBox &Box = InBoxes[BoxIndex];
+		if (Box.VisibilityMask)
+		{
+			SetVisible(VoxelIndex);
+		}
+		if (bOriginMasks)
+		{
+			OriginMasks[VoxelIndex] = Box.VisibilityMask;
+		}
+	}
+	return true;
+}
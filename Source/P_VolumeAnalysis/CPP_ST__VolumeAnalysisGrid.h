@@ -0,0 +1,387 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CPP_ST__VolumeAnalysisGrid.generated.h"
+
+struct FS_LinkedBox;
+
+/** Per-voxel flag bits stored in FS_VoxelGrid::Flags */
+enum class EE_VoxelFlags : uint8
+{
+	None = 0,
+	// Center overlap test has been run for this voxel this analysis
+	CenterTested = 1 << 0,
+	// Center overlap test hit blocking geometry (only meaningful with CenterTested)
+	CenterBlocked = 1 << 1,
+};
+ENUM_CLASS_FLAGS(EE_VoxelFlags);
+
+/** Cached result of the center overlap test for a voxel */
+enum class EE_CenterOverlapState : uint8
+{
+	Unknown,
+	Free,
+	Blocked
+};
+
+/** Half-open range of voxel coordinates [Min, Max) */
+struct FVoxelRange
+{
+	FIntVector Min = FIntVector::ZeroValue;
+	FIntVector Max = FIntVector::ZeroValue;
+
+	FVoxelRange() = default;
+	FVoxelRange(const FIntVector &InMin, const FIntVector &InMax) : Min(InMin), Max(InMax) {}
+
+	bool IsEmpty() const
+	{
+		return Max.X <= Min.X || Max.Y <= Min.Y || Max.Z <= Min.Z;
+	}
+
+	int64 Num() const
+	{
+		return IsEmpty() ? 0 : int64(Max.X - Min.X) * (Max.Y - Min.Y) * (Max.Z - Min.Z);
+	}
+
+	FORCEINLINE bool Contains(int32 X, int32 Y, int32 Z) const
+	{
+		return X >= Min.X && X < Max.X && Y >= Min.Y && Y < Max.Y && Z >= Min.Z && Z < Max.Z;
+	}
+};
+
+/**
+ * Dense voxel grid used as the internal storage for volume analysis.
+ * Voxels are addressed in flattened Z-Y-X order (X fastest), matching GenerateVoxelGridBoxes_ByCounts.
+ * Visibility is packed one bit per voxel; FS_LinkedBox is only produced on demand for Blueprint callers.
+ * Spacing is uniform (CellSize) unless an axis carries explicit cell edges (SetAxisEdges).
+ */
+USTRUCT(BlueprintType)
+struct P_VOLUMEANALYSIS_API FS_VoxelGrid
+{
+	GENERATED_BODY()
+
+public:
+	// World-space minimum corner of the grid
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Grid")
+	FVector Origin = FVector::ZeroVector;
+
+	// World-space size of a single voxel (the smallest cell along axes with explicit edges)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Grid")
+	FVector CellSize = FVector::ZeroVector;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Grid")
+	int32 CountX = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Grid")
+	int32 CountY = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Grid")
+	int32 CountZ = 0;
+
+	// Packed visibility, 32 voxels per word (1 = Visible, 0 = Hidden)
+	UPROPERTY()
+	TArray<uint32> VisibilityBits;
+
+	// Optional per-voxel flags; empty unless AllocateFlags() was called
+	UPROPERTY()
+	TArray<uint8> Flags;
+
+	// Optional line-of-sight bits per voxel, bit i = seen from visibility origin i; empty unless the run used origins
+	UPROPERTY()
+	TArray<uint8> OriginMasks;
+
+	// Optional world-space cell boundaries per axis (Count + 1 increasing values); empty = uniform CellSize
+	UPROPERTY()
+	TArray<double> EdgesX;
+
+	UPROPERTY()
+	TArray<double> EdgesY;
+
+	UPROPERTY()
+	TArray<double> EdgesZ;
+
+	// Size the grid to fill the AABB with the given counts per axis; all voxels start hidden
+	void Init(const FBox &Box, int32 InCountX, int32 InCountY, int32 InCountZ);
+
+	// Size the grid like Layout, including its cell edges; all voxels start hidden
+	void InitLayout(const FS_VoxelGrid &Layout);
+
+	// Give an axis non-uniform spacing; Edges must span the grid's extent on that axis with Count + 1 increasing
+	// values. Evenly spaced edges are dropped (the axis stays uniform). False leaves the grid unchanged.
+	bool SetAxisEdges(int32 Axis, TArray<double> &&Edges);
+
+	// Release all storage and zero the layout
+	void Reset();
+
+	bool IsValid() const
+	{
+		return CountX > 0 && CountY > 0 && CountZ > 0;
+	}
+
+	bool IsUniform() const
+	{
+		return EdgesX.Num() == 0 && EdgesY.Num() == 0 && EdgesZ.Num() == 0;
+	}
+
+	FORCEINLINE const TArray<double> &GetAxisEdges(int32 Axis) const
+	{
+		return Axis == 0 ? EdgesX : (Axis == 1 ? EdgesY : EdgesZ);
+	}
+
+	// World coordinate of cell boundary I (0..Count) along an axis
+	FORCEINLINE double GetEdge(int32 Axis, int32 I) const
+	{
+		const TArray<double> &Edges = GetAxisEdges(Axis);
+		return Edges.Num() > 0 ? Edges[I] : Origin[Axis] + CellSize[Axis] * I;
+	}
+
+	// World coordinate of the center of cell I along an axis
+	FORCEINLINE double GetAxisCenter(int32 Axis, int32 I) const
+	{
+		return 0.5 * (GetEdge(Axis, I) + GetEdge(Axis, I + 1));
+	}
+
+	// Cell along an axis containing a world coordinate; below 0 or at least Count when outside the grid
+	int32 GetAxisCell(int32 Axis, double WorldCoord) const;
+
+	int32 Num() const
+	{
+		return CountX * CountY * CountZ;
+	}
+
+	FORCEINLINE int32 Index(int32 X, int32 Y, int32 Z) const
+	{
+		return Z * (CountY * CountX) + Y * CountX + X;
+	}
+
+	FORCEINLINE FIntVector Coords(int32 InIndex) const
+	{
+		const int32 Slice = CountX * CountY;
+		const int32 Z = InIndex / Slice;
+		const int32 Rem = InIndex - Z * Slice;
+		return FIntVector(Rem % CountX, Rem / CountX, Z);
+	}
+
+	FORCEINLINE bool IsVisible(int32 InIndex) const
+	{
+		return (VisibilityBits[InIndex >> 5] & (1u << (InIndex & 31))) != 0;
+	}
+
+	FORCEINLINE void SetVisible(int32 InIndex, bool bVisible = true)
+	{
+		const uint32 Mask = 1u << (InIndex & 31);
+		if (bVisible)
+		{
+			VisibilityBits[InIndex >> 5] |= Mask;
+		}
+		else
+		{
+			VisibilityBits[InIndex >> 5] &= ~Mask;
+		}
+	}
+
+	// Thread-safe variant of SetVisible(Index, true) for concurrent writers that may share a word
+	FORCEINLINE void SetVisibleAtomic(int32 InIndex)
+	{
+		FPlatformAtomics::InterlockedOr(reinterpret_cast<volatile int32 *>(&VisibilityBits[InIndex >> 5]), static_cast<int32>(1u << (InIndex & 31)));
+	}
+
+	// IsVisible for voxels whose word other threads may be setting with SetVisibleAtomic (relaxed load, no ordering)
+	FORCEINLINE bool IsVisibleAtomic(int32 InIndex) const
+	{
+		const uint32 Word = static_cast<uint32>(FPlatformAtomics::AtomicRead_Relaxed(reinterpret_cast<const volatile int32 *>(&VisibilityBits[InIndex >> 5])));
+		return (Word & (1u << (InIndex & 31))) != 0;
+	}
+
+	// Mark every voxel hidden and clear origin masks (keeps layout and flags)
+	void ResetVisibility();
+
+	// Number of voxels with the visibility bit set
+	int32 CountVisible() const;
+
+	// Allocate (zeroed) per-voxel flags storage
+	void AllocateFlags();
+
+	bool HasFlags() const
+	{
+		return Flags.Num() == Num();
+	}
+
+	FORCEINLINE bool HasFlag(int32 InIndex, EE_VoxelFlags Flag) const
+	{
+		return (Flags[InIndex] & static_cast<uint8>(Flag)) != 0;
+	}
+
+	FORCEINLINE void AddFlag(int32 InIndex, EE_VoxelFlags Flag)
+	{
+		Flags[InIndex] |= static_cast<uint8>(Flag);
+	}
+
+	// Zero all per-voxel flags (keeps the allocation)
+	void ClearFlags();
+
+	bool HasOriginMasks() const
+	{
+		return OriginMasks.Num() > 0 && OriginMasks.Num() == Num();
+	}
+
+	// Origins that see the voxel; without origin masks, 1 if visible and 0 if hidden
+	FORCEINLINE uint8 GetOriginMask(int32 InIndex) const
+	{
+		return HasOriginMasks() ? OriginMasks[InIndex] : (IsVisible(InIndex) ? 1 : 0);
+	}
+
+	// Thread-safe: record that origin OriginIndex (0-7) sees the voxel
+	FORCEINLINE void AddOriginBitAtomic(int32 InIndex, int32 OriginIndex)
+	{
+		FPlatformAtomics::InterlockedOr(reinterpret_cast<volatile int8 *>(&OriginMasks[InIndex]), static_cast<int8>(1u << OriginIndex));
+	}
+
+	// Tri-state view of the cached center overlap result (requires flags)
+	FORCEINLINE EE_CenterOverlapState GetCenterOverlapState(int32 InIndex) const
+	{
+		const uint8 F = Flags[InIndex];
+		if ((F & static_cast<uint8>(EE_VoxelFlags::CenterTested)) == 0)
+		{
+			return EE_CenterOverlapState::Unknown;
+		}
+		return (F & static_cast<uint8>(EE_VoxelFlags::CenterBlocked)) ? EE_CenterOverlapState::Blocked : EE_CenterOverlapState::Free;
+	}
+
+	FORCEINLINE void SetCenterOverlapState(int32 InIndex, bool bBlocked)
+	{
+		Flags[InIndex] |= static_cast<uint8>(EE_VoxelFlags::CenterTested) | (bBlocked ? static_cast<uint8>(EE_VoxelFlags::CenterBlocked) : 0);
+	}
+
+	// World-space bounds of the whole grid
+	FBox GetBounds() const;
+
+	// World-space bounds of a (non-empty) voxel range
+	FBox GetRangeBounds(const FVoxelRange &Range) const;
+
+	// Copy visibility (and origin masks) of a grid lying on this grid's lattice, e.g. a shard result, into the voxels
+	// it covers. Returns the voxel range written; empty if the cell sizes differ, the origin is off the lattice or
+	// either grid is non-uniform.
+	FVoxelRange CopyFrom(const FS_VoxelGrid &Part);
+
+	// World-space center of a voxel, computed analytically (no allocation, no corner walk)
+	FORCEINLINE FVector GetCellCenter(int32 X, int32 Y, int32 Z) const
+	{
+		if (IsUniform())
+		{
+			return Origin + CellSize * FVector(X + 0.5, Y + 0.5, Z + 0.5);
+		}
+		return FVector(GetAxisCenter(0, X), GetAxisCenter(1, Y), GetAxisCenter(2, Z));
+	}
+
+	FORCEINLINE FVector GetCellCenter(int32 InIndex) const
+	{
+		const FIntVector C = Coords(InIndex);
+		return GetCellCenter(C.X, C.Y, C.Z);
+	}
+
+	// Voxels overlapping a world-space box, grown by Dilation voxels per side and clamped to the grid (empty if outside)
+	FVoxelRange GetVoxelRange(const FBox &WorldBox, int32 Dilation = 0) const;
+
+	// Voxel containing a world position (INDEX_NONE outside the grid)
+	int32 GetVoxelIndexAt(const FVector &WorldPos) const;
+
+	// Visibility at a world position (false outside the grid)
+	FORCEINLINE bool IsPointVisible(const FVector &WorldPos) const
+	{
+		const int32 VoxelIndex = GetVoxelIndexAt(WorldPos);
+		return VoxelIndex != INDEX_NONE && IsVisible(VoxelIndex);
+	}
+
+	// Visible voxels inside a voxel range (popcounts whole words along contiguous runs)
+	int32 CountVisibleInRange(const FVoxelRange &Range) const;
+
+	// Set bits in [Begin, End) of a packed bit array (Begin < End)
+	static int32 CountBitsInRange(const uint32 *Words, int32 Begin, int32 End);
+
+	// Visible voxels overlapping a world-space box
+	int32 CountVisibleInBox(const FBox &WorldBox) const
+	{
+		return CountVisibleInRange(GetVoxelRange(WorldBox));
+	}
+
+	/**
+	 * Walk the voxels crossed by the segment Start->End in order (3D DDA, no allocation) and stop at the first one
+	 * whose visibility equals bTargetVisible. OutHitLocation is where the segment enters that voxel (or where it
+	 * enters the grid, if that is the first voxel). Returns false if no such voxel lies on the segment.
+	 */
+	bool Raymarch(const FVector &Start, const FVector &End, bool bTargetVisible, FVector &OutHitLocation, int32 &OutVoxelIndex) const;
+
+	// World-space AABB of a single voxel
+	FORCEINLINE FBox GetCellBox(int32 X, int32 Y, int32 Z) const
+	{
+		if (IsUniform())
+		{
+			const FVector Min = Origin + CellSize * FVector(X, Y, Z);
+			return FBox(Min, Min + CellSize);
+		}
+		return FBox(FVector(GetEdge(0, X), GetEdge(1, Y), GetEdge(2, Z)), FVector(GetEdge(0, X + 1), GetEdge(1, Y + 1), GetEdge(2, Z + 1)));
+	}
+
+	FORCEINLINE FBox GetCellBox(int32 InIndex) const
+	{
+		const FIntVector C = Coords(InIndex);
+		return GetCellBox(C.X, C.Y, C.Z);
+	}
+
+	// Build a Blueprint-facing linked box for one voxel (8 corners + visibility, or the origin mask when present)
+	void MakeLinkedBox(int32 InIndex, FS_LinkedBox &OutBox) const;
+
+	// Build linked boxes for the whole grid (flattened Z-Y-X order); neighbouring boxes share corner points
+	void ToLinkedBoxes(TArray<FS_LinkedBox> &OutBoxes) const;
+
+	// Rebuild the grid from a flat array of boxes in any order; cell edges are taken from the box bounds, so graded
+	// grids round-trip too. Fails unless every cell is filled by exactly one box of exactly its size.
+	bool InitFromLinkedBoxes(const TArray<FS_LinkedBox> &InBoxes);
+};
+
+/**
+ * Summed-volume table (3D prefix sum) of a grid's visibility: the visible count of any axis-aligned voxel range
+ * is 8 lookups, independent of its size. Costs 4 bytes per voxel (plus one face per axis); build is O(N).
+ * Grids whose padded table would exceed MAX_int32 entries get no table (IsValid stays false).
+ */
+struct P_VOLUMEANALYSIS_API FVolumeAnalysisSummedVolume
+{
+	void Build(const FS_VoxelGrid &Grid);
+	void Reset();
+
+	bool IsValid() const { return Sums.Num() > 0; }
+
+	// True if the table was built for a grid with Grid's dimensions
+	bool Matches(const FS_VoxelGrid &Grid) const
+	{
+		return IsValid() && SizeX == Grid.CountX + 1 && SizeY == Grid.CountY + 1 && SizeZ == Grid.CountZ + 1;
+	}
+
+	// Visible voxels in Range (clamped to the grid)
+	int32 CountVisible(const FVoxelRange &Range) const;
+
+	SIZE_T GetAllocatedSize() const { return Sums.GetAllocatedSize(); }
+
+private:
+	// Visible voxels in [0, X) x [0, Y) x [0, Z)
+	FORCEINLINE int32 At(int32 X, int32 Y, int32 Z) const
+	{
+		return Sums[(Z * SizeY + Y) * SizeX + X];
+	}
+
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+	int32 SizeZ = 0;
+	TArray<int32> Sums;
+};
+
+// Shared, immutable result set. Owners swap in a new snapshot instead of mutating, so a held reference never
+// changes underneath its reader and can be passed to other threads or listeners without copying the bits.
+using FVolumeAnalysisResultRef = TSharedRef<const FS_VoxelGrid, ESPMode::ThreadSafe>;
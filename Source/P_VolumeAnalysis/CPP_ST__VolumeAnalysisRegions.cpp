@@ -0,0 +1,204 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#include "CPP_ST__VolumeAnalysisRegions.h"
+#include "Algo/StableSort.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+bool FS_VolumeAnalysisRegions::Build(const FS_VoxelGrid &Grid, bool bIncludeHidden)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FS_VolumeAnalysisRegions::Build);
+	Reset();
+	if (!Grid.IsValid())
+	{
+		return false;
+	}
+	GridCounts = FIntVector(Grid.CountX, Grid.CountY, Grid.CountZ);
+
+	TArray<int32> Labels;
+	TArray<int32> VoxelCounts;
+	Components.SetNum(LabelComponents(Grid, Labels, VoxelCounts));
+	for (int32 i = 0; i < Components.Num(); ++i)
+	{
+		Components[i].NumVoxels = VoxelCounts[i];
+	}
+
+	// Greedy merge in memory order: grow each unclaimed voxel into a run along X, then into whole rows along Y and
+	// whole slabs along Z while every voxel added is unclaimed and has the same state
+	const auto StateAt = [&Grid](int32 Idx)
+	{
+		return (Grid.IsVisible(Idx) ? 0x100 : 0) | Grid.GetOriginMask(Idx);
+	};
+	TBitArray<> Claimed(false, Grid.Num());
+	const auto RowMatches = [&](int32 X0, int32 X1, int32 Y, int32 Z, int32 State)
+	{
+		const int32 Start = Grid.Index(X0, Y, Z);
+		for (int32 i = Start; i < Start + (X1 - X0); ++i)
+		{
+			if (Claimed[i] || StateAt(i) != State)
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+
+	for (int32 Z = 0; Z < Grid.CountZ; ++Z)
+	{
+		for (int32 Y = 0; Y < Grid.CountY; ++Y)
+		{
+			for (int32 X = 0; X < Grid.CountX; ++X)
+			{
+				const int32 Idx = Grid.Index(X, Y, Z);
+				const bool bVisible = Grid.IsVisible(Idx);
+				if (Claimed[Idx] || (!bVisible && !bIncludeHidden))
+				{
+					continue;
+				}
+				const int32 State = StateAt(Idx);
+				int32 X1 = X + 1;
+				while (X1 < Grid.CountX && !Claimed[Idx + X1 - X] && StateAt(Idx + X1 - X) == State)
+				{
+					++X1;
+				}
+				int32 Y1 = Y + 1;
+				while (Y1 < Grid.CountY && RowMatches(X, X1, Y1, Z, State))
+				{
+					++Y1;
+				}
+				int32 Z1 = Z + 1;
+				while (Z1 < Grid.CountZ)
+				{
+					bool bSlab = true;
+					for (int32 RowY = Y; RowY < Y1 && bSlab; ++RowY)
+					{
+						bSlab = RowMatches(X, X1, RowY, Z1, State);
+					}
+					if (!bSlab)
+					{
+						break;
+					}
+					++Z1;
+				}
+				for (int32 BoxZ = Z; BoxZ < Z1; ++BoxZ)
+				{
+					for (int32 BoxY = Y; BoxY < Y1; ++BoxY)
+					{
+						Claimed.SetRange(Grid.Index(X, BoxY, BoxZ), X1 - X, true);
+					}
+				}
+
+				FS_VolumeAnalysisRegionBox &Box = Boxes.AddDefaulted_GetRef();
+				Box.Min = FIntVector(X, Y, Z);
+				Box.Max = FIntVector(X1, Y1, Z1);
+				Box.Bounds = Grid.GetRangeBounds(FVoxelRange(Box.Min, Box.Max));
+				Box.bVisible = bVisible;
+				Box.OriginMask = Grid.GetOriginMask(Idx);
+				// Face neighbours of equal visibility share a component, so the whole box has the first voxel's
+				Box.Component = bVisible ? Labels[Idx] : INDEX_NONE;
+			}
+		}
+	}
+
+	// Group by component (stable, so each component keeps memory order); INDEX_NONE compares as unsigned, so hidden boxes go last
+	Algo::StableSort(Boxes, [](const FS_VolumeAnalysisRegionBox &A, const FS_VolumeAnalysisRegionBox &B)
+					 { return static_cast<uint32>(A.Component) < static_cast<uint32>(B.Component); });
+	for (int32 i = 0; i < Boxes.Num() && Boxes[i].Component != INDEX_NONE; ++i)
+	{
+		FS_VolumeAnalysisRegionComponent &Component = Components[Boxes[i].Component];
+		if (Component.NumBoxes == 0)
+		{
+			Component.FirstBox = i;
+		}
+		++Component.NumBoxes;
+		Component.Bounds += Boxes[i].Bounds;
+		++NumVisibleBoxes;
+	}
+	return true;
+}
+
+void FS_VolumeAnalysisRegions::Reset()
+{
+	Components.Reset();
+	Boxes.Reset();
+	NumVisibleBoxes = 0;
+	GridCounts = FIntVector::ZeroValue;
+}
+
+int32 FS_VolumeAnalysisRegions::FindBoxAt(const FVector &WorldPos) const
+{
+	for (int32 i = 0; i < Boxes.Num(); ++i)
+	{
+		if (Boxes[i].Bounds.IsInsideOrOn(WorldPos))
+		{
+			return i;
+		}
+	}
+	return INDEX_NONE;
+}
+
+int32 FS_VolumeAnalysisRegions::LabelComponents(const FS_VoxelGrid &Grid, TArray<int32> &OutLabels, TArray<int32> &OutVoxelCounts)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FS_VolumeAnalysisRegions::LabelComponents);
+	OutLabels.Init(INDEX_NONE, Grid.Num());
+	OutVoxelCounts.Reset();
+	const int32 SliceSize = Grid.CountX * Grid.CountY;
+
+	// Depth-first flood fill with an explicit stack; every voxel is pushed at most once
+	TArray<int32> Stack;
+	for (int32 Seed = 0; Seed < Grid.Num(); ++Seed)
+	{
+		if (OutLabels[Seed] != INDEX_NONE || !Grid.IsVisible(Seed))
+		{
+			continue;
+		}
+		const int32 Label = OutVoxelCounts.Num();
+		int32 Count = 0;
+		const auto Visit = [&](int32 Idx)
+		{
+			if (OutLabels[Idx] == INDEX_NONE && Grid.IsVisible(Idx))
+			{
+				OutLabels[Idx] = Label;
+				Stack.Add(Idx);
+			}
+		};
+		Visit(Seed);
+		while (Stack.Num() > 0)
+		{
+			const int32 Idx = Stack.Pop(EAllowShrinking::No);
+			++Count;
+			const int32 X = Idx % Grid.CountX;
+			const int32 Y = (Idx / Grid.CountX) % Grid.CountY;
+			const int32 Z = Idx / SliceSize;
+			if (X > 0)
+			{
+				Visit(Idx - 1);
+			}
+			if (X + 1 < Grid.CountX)
+			{
+				Visit(Idx + 1);
+			}
+			if (Y > 0)
+			{
+				Visit(Idx - Grid.CountX);
+			}
+			if (Y + 1 < Grid.CountY)
+			{
+				Visit(Idx + Grid.CountX);
+			}
+			if (Z > 0)
+			{
+				Visit(Idx - SliceSize);
+			}
+			if (Z + 1 < Grid.CountZ)
+			{
+				Visit(Idx + SliceSize);
+			}
+		}
+		OutVoxelCounts.Add(Count);
+	}
+	return OutVoxelCounts.Num();
+}
@@ -0,0 +1,103 @@
+/*
+ * @Author: Punal Manalan
+ * @Description: Volume Analysis Plugin.
+ * @Date: 14/10/2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CPP_ST__VolumeAnalysisGrid.h"
+#include "CPP_ST__VolumeAnalysisRegions.generated.h"
+
+/** Axis-aligned block of voxels that share one state, merged from a voxel grid */
+USTRUCT(BlueprintType)
+struct P_VOLUMEANALYSIS_API FS_VolumeAnalysisRegionBox
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Regions")
+	FBox Bounds = FBox(ForceInit);
+
+	// Voxel coordinates covered, [Min, Max)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Regions")
+	FIntVector Min = FIntVector::ZeroValue;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Regions")
+	FIntVector Max = FIntVector::ZeroValue;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Regions")
+	bool bVisible = false;
+
+	// Origins seeing every voxel of the box (results without origin masks: 1 visible, 0 hidden)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Regions")
+	uint8 OriginMask = 0;
+
+	// Connected component of visible voxels the box belongs to; -1 for hidden boxes
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Regions")
+	int32 Component = INDEX_NONE;
+
+	int64 NumVoxels() const { return FVoxelRange(Min, Max).Num(); }
+};
+
+/** Visible voxels connected through shared faces */
+USTRUCT(BlueprintType)
+struct P_VOLUMEANALYSIS_API FS_VolumeAnalysisRegionComponent
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Regions")
+	int32 NumVoxels = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Regions")
+	FBox Bounds = FBox(ForceInit);
+
+	// The component's boxes are Boxes[FirstBox, FirstBox + NumBoxes) of the owning region set
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Regions")
+	int32 FirstBox = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Regions")
+	int32 NumBoxes = 0;
+};
+
+/**
+ * Compact region list of a result grid: 6-connected components of visible voxels and a greedy merge of the grid into
+ * boxes of equal state (visibility and origin mask). Boxes never span two components; they are grouped by component
+ * in component order, followed by the hidden boxes. Components are numbered in voxel memory order of their first voxel.
+ */
+USTRUCT(BlueprintType)
+struct P_VOLUMEANALYSIS_API FS_VolumeAnalysisRegions
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Regions")
+	TArray<FS_VolumeAnalysisRegionComponent> Components;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Regions")
+	TArray<FS_VolumeAnalysisRegionBox> Boxes;
+
+	// Boxes[0, NumVisibleBoxes) are visible
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Regions")
+	int32 NumVisibleBoxes = 0;
+
+	// Layout of the source grid
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Punal|VolumeAnalysis|Regions")
+	FIntVector GridCounts = FIntVector::ZeroValue;
+
+	/** Rebuild from Grid; hidden space is merged into boxes too when bIncludeHidden. False if Grid is empty. */
+	bool Build(const FS_VoxelGrid &Grid, bool bIncludeHidden = false);
+
+	void Reset();
+
+	// Box containing a world position (linear in the box count); INDEX_NONE if none does
+	int32 FindBoxAt(const FVector &WorldPos) const;
+
+	/**
+	 * Label Grid's visible voxels by 6-connected component (flood fill); hidden voxels get INDEX_NONE.
+	 * OutVoxelCounts receives the size of each component. Returns the number of components.
+	 */
+	static int32 LabelComponents(const FS_VoxelGrid &Grid, TArray<int32> &OutLabels, TArray<int32> &OutVoxelCounts);
+};
@@ -52,6 +52,7 @@ public class P_VolumeAnalysis : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
+				"Landscape",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);